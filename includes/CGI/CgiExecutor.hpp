@@ -2,10 +2,12 @@
 #define CGIEXECUTOR_HPP
 
 #include "../Wrapper/FileDescriptor.hpp"
+#include "../Wrapper/Mutex.hpp"
 #include <string>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#include <vector>
 
 class CgiExecutor
 {
@@ -26,15 +28,18 @@ public:
 
 private:
 	static const int DEFAULT_TIMEOUT_SECONDS = 30;
-	static const size_t MAX_OUTPUT_SIZE = 10 * 1024 * 1024; // 10MB limit
 
 	pid_t _childPid;
 	FileDescriptor _stdinPipe[2];  // [0] = read end, [1] = write end
 	FileDescriptor _stdoutPipe[2]; // [0] = read end, [1] = write end
-	FileDescriptor _stderrPipe[2]; // [0] = read end, [1] = write end
 
 	int _timeoutSeconds;
 	bool _processRunning;
+	bool _outputComplete; // stdout reached EOF while reading the header block
+
+	// Children whose output outlived execute(), reaped once they exit
+	static std::vector<pid_t> _detachedChildren;
+	static Mutex _detachedMutex;
 
 public:
 	CgiExecutor();
@@ -44,9 +49,12 @@ public:
 
 	CgiExecutor &operator=(const CgiExecutor &other);
 
-	// Main execution method
+	// Main execution method, returns once the header block (and whatever came with it) is read
 	ExecutionResult execute(const std::string &scriptPath, const std::string &interpreter, char **envp,
-							const std::string &inputData, std::string &outputData, std::string &errorData);
+							const std::string &inputData, std::string &outputData);
+	bool isOutputComplete() const;
+	FileDescriptor detachOutput();
+	static void reapDetached();
 
 	// Configuration
 	void setTimeout(int seconds);
@@ -61,10 +69,11 @@ private:
 	ExecutionResult setupPipes();
 	void closePipes();
 	ExecutionResult forkAndExec(const std::string &scriptPath, const std::string &interpreter, char **envp);
-	ExecutionResult communicateWithChild(const std::string &inputData, std::string &outputData, std::string &errorData);
+	ExecutionResult communicateWithChild(const std::string &inputData, std::string &outputData);
 	ExecutionResult waitForChild();
 
 	// Utility methods
+	static bool hasHeaderBlock(const std::string &output);
 	bool isFileExecutable(const std::string &path) const;
 	std::string getInterpreterFromShebang(const std::string &scriptPath) const;
 };
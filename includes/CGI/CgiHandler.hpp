@@ -39,9 +39,9 @@ private:
 private:
 	// Internal methods
 	ExecutionResult executeCgiScript(const std::string &scriptPath, const std::string &interpreter,
-									 const HttpRequest &request, std::string &output, std::string &error);
+									 const HttpRequest &request, std::string &output);
 
-	ExecutionResult processResponse(const std::string &output, const std::string &error, HttpResponse &response,
+	ExecutionResult processResponse(const std::string &output, const FileDescriptor &stream, HttpResponse &response,
 									const Server *server);
 
 	// Utility methods
@@ -26,7 +26,8 @@ private:
 	int _statusCode;
 	std::string _statusMessage;
 	bool _isParsed;
-	bool _isNPH; // Non-Parsed Header mode
+	bool _isNPH;		  // Non-Parsed Header mode
+	bool _outputComplete; // the whole output was parsed, nothing is left in the script's stdout
 
 public:
 	CgiResponse();
@@ -36,10 +37,10 @@ public:
 	CgiResponse &operator=(const CgiResponse &other);
 
 	// Main parsing method
-	ParseResult parseOutput(const std::string &cgiOutput);
+	ParseResult parseOutput(const std::string &cgiOutput, bool outputComplete);
 
-	// Convert to HttpResponse
-	void populateHttpResponse(HttpResponse &httpResponse) const;
+	// Convert to HttpResponse, an open stream carries the rest of the body
+	void populateHttpResponse(HttpResponse &httpResponse, const FileDescriptor &stream) const;
 
 	// Getters
 	const std::map<std::string, std::string> &getHeaders() const;
@@ -60,12 +61,14 @@ private:
 	// Internal parsing methods
 	ParseResult parseHeaders(const std::string &headerSection);
 	ParseResult parseStatusLine(const std::string &statusLine);
-	void parseHeaderLine(const std::string &line);
+	void parseHeaderLine(const char *begin, const char *end);
 
 	// Utility methods
 	std::string toLowerCase(const std::string &str) const;
 	std::string trim(const std::string &str) const;
+	void trimRange(const char *&begin, const char *&end) const;
 	bool isValidStatusCode(int code) const;
+	ssize_t getScriptContentLength() const;
 	std::string getDefaultStatusMessage(int code) const;
 
 	// Header processing
@@ -2,6 +2,7 @@
 #define CONFIG_TRANSLATOR_HPP
 
 #include "../../includes/ConfigParser/ConfigNameSpace.hpp"
+#include "../../includes/Core/GlobalConfig.hpp"
 #include "../../includes/Core/Location.hpp"
 #include "../../includes/Core/Server.hpp"
 #include <vector>
@@ -10,6 +11,7 @@ class ConfigTranslator
 {
 private:
 	std::vector<Server> _servers; // owned
+	GlobalConfig _globalConfig;	  // top-level directives
 
 	// Non-copyable
 	ConfigTranslator(const ConfigTranslator &other);
@@ -18,6 +20,16 @@ private:
 	// Translation helpers
 	void _translate(const AST::ASTNode &ast);
 	Server _translateServer(const AST::ASTNode &ast);
+	void _translateGlobal(const AST::ASTNode &directive);
+
+	// Global specific translation helpers
+	void _translateWorkerProcesses(const AST::ASTNode &directive, GlobalConfig &globalConfig);
+	void _translateWorkerCpuAffinity(const AST::ASTNode &directive, GlobalConfig &globalConfig);
+	void _translateWorkerThreads(const AST::ASTNode &directive, GlobalConfig &globalConfig);
+	void _translateTimeout(const AST::ASTNode &directive, GlobalConfig &globalConfig);
+	void _translateCount(const AST::ASTNode &directive, GlobalConfig &globalConfig);
+	void _translateByteBudget(const AST::ASTNode &directive, GlobalConfig &globalConfig);
+	void _translateEventBackend(const AST::ASTNode &directive, GlobalConfig &globalConfig);
 
 	// Server specific translation helpers
 	void _translateServerName(const AST::ASTNode &directive, Server &server);
@@ -25,6 +37,8 @@ private:
 	void _translateServerRoot(const AST::ASTNode &directive, Server &server);
 	void _translateServerIndex(const AST::ASTNode &directive, Server &server);
 	void _translateServerAutoindex(const AST::ASTNode &directive, Server &server);
+	void _translateServerTcpOption(const AST::ASTNode &directive, Server &server);
+	void _translateServerLimitRate(const AST::ASTNode &directive, Server &server);
 	void _translateServerClientMaxBodySize(const AST::ASTNode &directive, Server &server);
 	void _translateServerErrorPages(const AST::ASTNode &directive, Server &server);
 
@@ -40,6 +54,7 @@ private:
 	void _translateLocationCgiPath(const AST::ASTNode &directive, Location &location);
 	void _translateLocationCgiParam(const AST::ASTNode &directive, Location &location);
 	void _translateLocationClientMaxBodySize(const AST::ASTNode &directive, Location &location);
+	void _translateLocationLimitRate(const AST::ASTNode &directive, Location &location);
 
 public:
 	explicit ConfigTranslator(const AST::ASTNode &ast);
@@ -47,6 +62,7 @@ public:
 
 	// Accessors
 	const std::vector<Server> &getServers() const;
+	const GlobalConfig &getGlobalConfig() const;
 };
 
 #endif /* **************************************************** CONFIG_TRANSLATOR_H */
\ No newline at end of file
@@ -21,10 +21,15 @@ private:
 	// Server map (key: binded socket, value: vector of references to servers)
 	std::map<ListeningSocket, std::vector<Server> > _serverMap;
 
-	void _buildServerMap();
+	// Worker mode: sockets are bound with SO_REUSEPORT and only reserved, each worker listens on its own copy
+	bool _reusePort;
+
+	void _buildServerMap(const ServerMap *previous);
+	ListenOptions _resolveListenOptions(const SocketAddress &address) const;
 
 public:
-	explicit ServerMap(std::vector<Server> &servers);
+	ServerMap();
+	explicit ServerMap(std::vector<Server> &servers, bool reusePort = false, const ServerMap *previous = NULL);
 	ServerMap(ServerMap const &src);
 	ServerMap &operator=(ServerMap const &rhs);
 	~ServerMap();
@@ -37,6 +42,9 @@ public:
 
 	// Mutators
 	void insertServer(const Server &server);
+	void reopenListeners();
+	void listenReserved();
+	void removeUnixSockets() const;
 
 	// Listening sockets
 	const ListeningSocket &getListeningSocket(int &fd) const;
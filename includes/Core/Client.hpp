@@ -2,10 +2,15 @@
 #ifndef CLIENT_HPP
 #define CLIENT_HPP
 
+#include "../../includes/Core/ConfigSnapshot.hpp"
+#include "../../includes/Core/EventBackend.hpp"
+#include "../../includes/Core/FileIoPool.hpp"
 #include "../../includes/Core/Server.hpp"
+#include "../../includes/Core/TimerWheel.hpp"
 #include "../../includes/HTTP/HttpRequest.hpp"
 #include "../../includes/HTTP/HttpResponse.hpp"
 #include "../../includes/Wrapper/FileDescriptor.hpp"
+#include "../../includes/Wrapper/RingBuffer.hpp"
 #include "../../includes/Wrapper/SocketAddress.hpp"
 #include <deque>
 #include <fcntl.h>
@@ -26,7 +31,19 @@ public:
 	{
 		WAITING_FOR_EPOLLIN = 0,  // Ready to process incoming data
 		WAITING_FOR_EPOLLOUT = 1, // Ready to send outgoing data
-		DISCONNECTED = 2		  // Client has been disconnected
+		DISCONNECTED = 2,		  // Client has been disconnected
+		WAITING_FOR_IO = 3		  // Requests run on the file I/O pool, responses behind them wait their turn
+	};
+
+	// Which deadline currently applies to the connection
+	enum TimerPhase
+	{
+		HEADER_PHASE = 0,	// Receiving a request head, deadline counted from its first byte (or from accept)
+		BODY_PHASE = 1,		// Receiving a request body, deadline counted from the last read
+		SEND_PHASE = 2,		// Responses queued, deadline counted from the last write
+		KEEPALIVE_PHASE = 3, // Idle between requests, deadline counted from the last response
+		THROTTLE_PHASE = 4,	 // limit_rate holds the response back, the deadline is when it may send again
+		IO_PHASE = 5		 // Waiting on the file I/O pool, deadline counted from the last write
 	};
 
 private:
@@ -39,16 +56,36 @@ private:
 	HttpResponse _response;					  // Cached response (May be partially processed)
 	std::deque<HttpResponse> _responseBuffer; // Buffer to hold responses
 
-	// Raw data buffers
-	std::vector<char> _receiveBuffer; // Static buffer to draw from the kernel buffer
-	std::vector<char> _holdingBuffer; // Dynamic buffer to hold incoming data
+	// Raw data buffer, recv() writes into its free space and the parsers consume from its front
+	RingBuffer _receiveBuffer;
+	size_t _recvSize;	// bytes asked of the next recv(), adapts to what the connection sends
+	size_t _shortReads; // consecutive reads that filled under a quarter of _recvSize
 
 	const std::vector<Server> *_potentialServers; // Potential servers to use for the request
+	ConfigSnapshot *_snapshot;					  // Configuration generation the connection runs on, retained
+	const ConfigSnapshot::Listener *_listener;	  // Listener of _snapshot the connection was accepted on
 
 	// State
-	ClientState _state;	  // Current state of the client
-	time_t _lastActivity; // Time of last activity will be used by server manager to check for timed out clients
-	bool _keepAlive;	  // Whether the connection should be kept alive
+	ClientState _state;		 // Current state of the client
+	bool _keepAlive;		 // Whether the connection should be kept alive
+	EpollTag _epollTag;		 // epoll data.ptr, always points back at this instance
+	TimerPhase _phase;		 // Deadline phase, derived after every event
+	uint64_t _phaseStart;	 // Monotonic ms when the current phase began
+	uint64_t _lastProgress;	 // Monotonic ms of the last read or write that moved bytes
+	bool _idle;				 // Last response sent and no byte of the next request received yet
+	bool _progressed;		 // Bytes moved during the event being handled
+	bool _phaseRestart;		 // A request or response completed during the event, restart the phase clock
+	bool _sendYielded;		 // Send budget used up with the socket still writable, no EPOLLOUT edge will follow
+	bool _recvYielded;		 // Socket not read down to EAGAIN, no EPOLLIN edge will follow for what is left
+	bool _parseYielded;		 // Request budget used up with complete requests possibly still buffered
+	bool _corked;			 // TCP_CORK holds the head of a file response until its body is out (tcp_nopush)
+	uint64_t _now;			 // Monotonic ms of the event being handled
+	uint64_t _throttledUntil; // Monotonic ms the front response's rate limit lets it send again, 0 when not held
+	TimerWheel::Timer _timer; // Deadline node, armed by the server manager
+	std::deque<FileIoPool::Job *> _ioJobs; // Responses not yet in _responseBuffer, in request order
+
+	void _updatePhase(uint64_t now);
+	void _adaptRecvSize(size_t bytesRead);
 
 	// Post header methods
 	void _identifyServer();
@@ -57,10 +94,15 @@ private:
 	// Request processing methods
 	void _handleBuffer();
 	void _handleRequest();
+	bool _dispatchRequest();
+	void _queueResponse(const HttpResponse &response);
 
 	// Response processing methods
 	void _handleResponseBuffer();
+	bool _sendCoalesced(ssize_t &totalBytesSent, size_t budget);
 	void _routeRequest();
+	void _limitResponseRate(const HttpRequest &request, HttpResponse &response);
+	void _dropFileIoJobs();
 
 public:
 	// Orchestrator methods
@@ -71,23 +113,46 @@ public:
 	~Client();
 
 	// Core operations
-	void handleEvent(epoll_event event);
+	void handleEvent(epoll_event event, uint64_t now);
+
+	// Slot recycling (ClientTable)
+	void attach(const FileDescriptor &socketFd, const SocketAddress &remoteAddress, ConfigSnapshot &snapshot,
+				const ConfigSnapshot::Listener &listener, uint64_t now);
+	void reset();
+
+	// Configuration reload
+	bool isBetweenRequests() const;
+
+	// Per turn budgets
+	uint32_t getYieldedEvents() const;
+	bool rebind(ConfigSnapshot &snapshot);
+
+	// File I/O offloading
+	bool completeFileIo(FileIoPool::Job &job, uint64_t now);
+	const std::deque<FileIoPool::Job *> &getFileIoJobs() const;
+	bool hasQueuedResponses() const;
 
 	// State management
 
 	// Mutators
 	ClientState getCurrentState() const;
 	void setState(ClientState newState);
-	void updateActivity();
 
 	// Accessors
 	int getSocketFd() const;
+	EpollTag &getEpollTag();
+	TimerWheel::Timer &getTimer();
+	TimerPhase getTimerPhase() const;
+	uint64_t getPhaseStart() const;
+	uint64_t getLastProgress() const;
+	uint64_t getThrottledUntil() const;
 	const SocketAddress &getLocalAddr() const;
 	const SocketAddress &getRemoteAddr() const;
 	const std::vector<Server> &getPotentialServers() const;
+	ConfigSnapshot *getSnapshot() const;
+	const ConfigSnapshot::Listener *getListener() const;
 	void setPotentialServers(
 		const std::vector<Server> &potentialServers); // For server manager to set potential servers
-	bool isTimedOut() const;
 };
 
 // TODO: Stream overload for diagnostic purposes
@@ -0,0 +1,44 @@
+#ifndef CLIENTTABLE_HPP
+#define CLIENTTABLE_HPP
+
+#include "../../includes/Core/Client.hpp"
+#include "../../includes/Core/Server.hpp"
+#include "../../includes/Wrapper/FileDescriptor.hpp"
+#include "../../includes/Wrapper/SocketAddress.hpp"
+#include <cstddef>
+#include <vector>
+
+// Connection slab indexed by socket fd. Client objects are allocated once and recycled through a free list, so
+// accepting and closing a connection never builds or copies a Client. Slots never move: epoll tags and the
+// request's remote address pointer stay valid for the lifetime of the table.
+class ClientTable
+{
+private:
+	std::vector<Client *> _slots;	   // every Client ever allocated, owned by the table
+	std::vector<Client *> _free;	   // recycled slots ready for the next connection
+	std::vector<Client *> _byFd;	   // fd -> live client, NULL when the fd is not a client
+	std::vector<Client *> _live;	   // dense list of live clients, iteration order is unspecified
+	std::vector<size_t> _livePosition; // fd -> index in _live
+
+	void _grow(size_t count);
+
+	// Non-copyable
+	ClientTable(ClientTable const &src);
+	ClientTable &operator=(ClientTable const &rhs);
+
+public:
+	explicit ClientTable(size_t preallocated);
+	~ClientTable();
+
+	Client *acquire(const FileDescriptor &socketFd, const SocketAddress &remoteAddress,
+					ConfigSnapshot &snapshot, const ConfigSnapshot::Listener &listener, uint64_t now);
+	void release(int fd);
+	Client *find(int fd) const;
+
+	// Live iteration, releasing a client moves the last live client into its index
+	size_t size() const;
+	Client &at(size_t index) const;
+};
+
+#endif /* ****************************************************** CLIENTTABLE_H                                          \
+		*/
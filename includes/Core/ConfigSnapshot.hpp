@@ -0,0 +1,61 @@
+#ifndef CONFIGSNAPSHOT_HPP
+#define CONFIGSNAPSHOT_HPP
+
+#include "../../includes/ConfigParser/ServerMap.hpp"
+#include "../../includes/Core/GlobalConfig.hpp"
+#include "../../includes/Core/Server.hpp"
+#include "../../includes/Wrapper/SocketAddress.hpp"
+#include <cstddef>
+#include <vector>
+
+// Immutable copy of one configuration generation: the candidate servers of every listening address plus the global
+// settings. A configuration reload builds a new snapshot instead of touching this one, and every connection retains
+// the snapshot it was accepted under, so the Server/Location objects its request points into live until it is done.
+// The reference count is atomic, snapshots are released by whichever reactor thread closes the last connection.
+class ConfigSnapshot
+{
+public:
+	struct Listener
+	{
+		SocketAddress address;		 // listening address, the identity kept across reloads
+		std::vector<Server> servers; // candidate servers for connections accepted on it
+		size_t connectionLimit;		 // smallest listen max_connections of its servers, 0 = none
+		bool tcpNoDelay;			 // tcp_nodelay of the default (first) server, set on accepted sockets
+		bool tcpNoPush;				 // tcp_nopush of the default server, cork heads with their file bodies
+		mutable volatile size_t connections; // open connections bound to it, closed by any reactor thread
+
+		Listener();
+
+		// Takes a connection slot, false (and nothing taken) when the listener is full
+		bool admit() const;
+		// Takes a slot regardless of the limit, for connections moved over from an older generation
+		void join() const;
+		void leave() const;
+	};
+
+private:
+	std::vector<Listener> _listeners;
+	GlobalConfig _globalConfig;
+	size_t _generation;		 // 1 for the configuration loaded at startup, +1 per reload
+	volatile int _refCount;	 // the creator holds the first reference
+
+	~ConfigSnapshot(); // deleted by the last release()
+
+	// Non-copyable
+	ConfigSnapshot(ConfigSnapshot const &src);
+	ConfigSnapshot &operator=(ConfigSnapshot const &rhs);
+
+public:
+	ConfigSnapshot(const ServerMap &serverMap, const GlobalConfig &globalConfig, size_t generation);
+
+	void retain();
+	void release();
+
+	// NULL when the address is not part of this generation
+	const Listener *findListener(const SocketAddress &address) const;
+	const GlobalConfig &getGlobalConfig() const;
+	size_t getGeneration() const;
+};
+
+#endif /* *************************************************** CONFIGSNAPSHOT_H                                          \
+		*/
@@ -0,0 +1,56 @@
+#ifndef CONNECTIONQUEUE_HPP
+#define CONNECTIONQUEUE_HPP
+
+#include "../../includes/Core/ConfigSnapshot.hpp"
+#include "../../includes/Wrapper/FileDescriptor.hpp"
+#include "../../includes/Wrapper/SocketAddress.hpp"
+#include <cstddef>
+#include <vector>
+
+// Bounded single-producer/single-consumer ring used to hand accepted sockets from the acceptor thread to one
+// reactor thread. Lock-free: the producer only writes _tail, the consumer only writes _head, full barriers order
+// the slot access against the index publish. An eventfd wakes the consumer's epoll loop.
+class ConnectionQueue
+{
+public:
+	// fd -1 with a snapshot is a configuration reload notice rather than a connection
+	struct PendingConnection
+	{
+		int fd;									  // Released raw fd, the consumer takes ownership
+		SocketAddress remoteAddress;			  // Peer address from accept()
+		ConfigSnapshot *snapshot;				  // Configuration generation, one reference passed to the consumer
+		const ConfigSnapshot::Listener *listener; // Listener of snapshot the connection was accepted on
+
+		PendingConnection() : fd(-1), snapshot(NULL), listener(NULL)
+		{
+		}
+	};
+
+private:
+	std::vector<PendingConnection> _slots;
+	size_t _mask;			// capacity - 1, capacity is a power of two
+	volatile size_t _head;	// next slot to pop (consumer)
+	volatile size_t _tail;	// next slot to push (producer)
+	FileDescriptor _eventFd; // wakeup for the consumer
+
+	// Non-copyable
+	ConnectionQueue(ConnectionQueue const &src);
+	ConnectionQueue &operator=(ConnectionQueue const &rhs);
+
+public:
+	explicit ConnectionQueue(size_t capacity);
+	~ConnectionQueue();
+
+	// Producer side
+	bool push(const PendingConnection &connection);
+	void notify();
+
+	// Consumer side
+	bool pop(PendingConnection &connection);
+	void drainNotifications();
+
+	int getEventFd() const;
+};
+
+#endif /* *************************************************** CONNECTIONQUEUE_H                                          \
+		*/
@@ -1,12 +1,15 @@
 #ifndef EPOLLMANAGER_HPP
 #define EPOLLMANAGER_HPP
 
+#include "../../includes/Core/EventBackend.hpp"
 #include "../../includes/Wrapper/FileDescriptor.hpp"
 #include <cstring>
+#include <stdint.h>
 #include <sys/epoll.h>
 #include <vector>
 
-class EpollManager
+// Default event backend: edge triggered epoll
+class EpollManager : public EventBackend
 {
 private:
 	FileDescriptor _epollFd;
@@ -20,12 +23,13 @@ public:
 	~EpollManager();
 	EpollManager &operator=(const EpollManager &);
 
-	void addFd(int fd, uint32_t events = EPOLLIN);
-	void modifyFd(int fd, uint32_t events);
+	void addFd(EpollTag &tag, uint32_t events);
+	void modifyFd(EpollTag &tag, uint32_t events);
 	void removeFd(int fd);
 
 	// Wait for events
-	int wait(std::vector<epoll_event> &events, int timeout = -1);
+	int wait(std::vector<epoll_event> &events, int timeout);
+	const char *getName() const;
 
 	FileDescriptor &getFd();
 };
@@ -0,0 +1,61 @@
+#ifndef EVENTBACKEND_HPP
+#define EVENTBACKEND_HPP
+
+#include <cstring>
+#include <string>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <vector>
+
+// Registered as epoll_event.data.ptr so an event leads straight to its owner without any fd lookup.
+// The tag must outlive its registration (remove the fd before destroying the owner).
+struct EpollTag
+{
+	enum Type
+	{
+		LISTENER, // owner: const ConfigSnapshot::Listener * served by the listening socket
+		CLIENT,	  // owner: Client *
+		HANDOFF,  // owner: ConnectionQueue * whose eventfd this is
+		SIGNAL,	  // owner: NULL, signalfd delivering SIGHUP
+		FILE_IO	  // owner: IoCompletionQueue * whose eventfd this is
+	};
+
+	Type type;
+	int fd;
+	void *owner;
+	uint32_t events; // interest mask currently registered, maintained by the event backend
+
+	EpollTag() : type(CLIENT), fd(-1), owner(NULL), events(0)
+	{
+	}
+	EpollTag(Type t, int f, void *o) : type(t), fd(f), owner(o), events(0)
+	{
+	}
+};
+
+// Readiness notification interface of the event loop. Interest masks and results use the epoll bit values and
+// every backend reports events as epoll_event with data.ptr set to the registered tag.
+class EventBackend
+{
+public:
+	enum Type
+	{
+		EPOLL = 0,
+		IO_URING = 1
+	};
+
+	virtual ~EventBackend();
+
+	virtual void addFd(EpollTag &tag, uint32_t events) = 0;
+	virtual void modifyFd(EpollTag &tag, uint32_t events) = 0;
+	virtual void removeFd(int fd) = 0;
+	virtual int wait(std::vector<epoll_event> &events, int timeout) = 0;
+	virtual const char *getName() const = 0;
+
+	// Builds the requested backend, falling back to epoll when it cannot be set up on this kernel
+	static EventBackend *create(Type type);
+	static bool parseType(const std::string &name, Type &typeOut);
+};
+
+#endif /* **************************************************** EVENTBACKEND_H                                          \
+		*/
@@ -0,0 +1,76 @@
+#ifndef FILEIOPOOL_HPP
+#define FILEIOPOOL_HPP
+
+#include "../../includes/Core/ConfigSnapshot.hpp"
+#include "../../includes/Core/IMethodHandler.hpp"
+#include "../../includes/HTTP/HttpRequest.hpp"
+#include "../../includes/HTTP/HttpResponse.hpp"
+#include "../../includes/Wrapper/Mutex.hpp"
+#include <cstddef>
+#include <pthread.h>
+#include <vector>
+
+class Client;
+class IoCompletionQueue;
+
+// Worker threads that run the blocking part of a request (stat, open, unlink, writing an upload) away from the event
+// loops. Every loop of the process submits into one bounded queue, a worker runs the method handler and posts the
+// job to the completion queue of the loop it came from, which hands the response back to its connection.
+class FileIoPool
+{
+public:
+	// One request handed off by a connection. The handler only reads what the job owns, so the connection may
+	// close while it runs.
+	struct Job
+	{
+		IMethodHandler *handler;		// owned, NULL for a response made on the loop that only keeps its place
+		HttpRequest request;			// routed copy, its server and location live in snapshot
+		HttpResponse response;			// filled in by the handler
+		ConfigSnapshot *snapshot;		// retained until the job is deleted
+		Client *client;					// connection the job was made for, only used by its event loop
+		IoCompletionQueue *completions; // loop the job returns to, NULL until submitted
+		bool cancelled;					// handed back unrun by a stopping pool
+		bool finished;					// response ready, only touched by the event loop
+		Job *next;						// intrusive link, submission queue then completion queue
+
+		Job(IMethodHandler *handler, const HttpRequest &request, const HttpResponse &response,
+			ConfigSnapshot &snapshot, Client &client);
+		~Job();
+
+		void run();
+
+	private:
+		// Non-copyable
+		Job(Job const &src);
+		Job &operator=(Job const &rhs);
+	};
+
+private:
+	std::vector<pthread_t> _threads;
+	Mutex _mutex;	  // guards the queue and _stopping
+	Condition _ready; // a job was queued or the pool is stopping
+	Job *_head;		  // oldest queued job
+	Job *_tail;		  // newest queued job
+	size_t _queued;
+	size_t _capacity; // queued jobs past which submit() refuses
+	bool _stopping;
+
+	// Non-copyable
+	FileIoPool(FileIoPool const &src);
+	FileIoPool &operator=(FileIoPool const &rhs);
+
+	Job *_take();
+	static void *_workerRoutine(void *arg);
+
+public:
+	FileIoPool(size_t threadCount, size_t capacity);
+	~FileIoPool();
+
+	bool submit(Job *job);
+	void stop();
+
+	size_t getThreadCount() const;
+};
+
+#endif /* ******************************************************** FILEIOPOOL_H                                          \
+		*/
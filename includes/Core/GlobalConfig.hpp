@@ -0,0 +1,84 @@
+#ifndef GLOBALCONFIG_HPP
+#define GLOBALCONFIG_HPP
+
+#include "../../includes/Core/EventBackend.hpp"
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Process wide configuration object (top-level directives outside of server blocks)
+class GlobalConfig
+{
+private:
+	size_t _workerProcesses;					  // Number of worker processes (1 = no master/worker split)
+	size_t _workerThreads;						  // Reactor threads per process (1 = single threaded)
+	size_t _ioThreads;							  // File I/O threads per process (0 = no offloading)
+	bool _cpuAffinityAuto;						  // Pin worker N to cpu N % online cpus
+	std::vector<std::string> _cpuAffinityMasks; // Binary cpu masks, one per worker (rightmost char = cpu 0)
+	size_t _clientHeaderTimeout;				  // ms to receive a complete request head, from its first byte
+	size_t _clientBodyTimeout;					  // ms allowed between two reads of a request body
+	size_t _sendTimeout;						  // ms allowed between two writes of a response
+	size_t _keepaliveTimeout;					  // ms an idle keep-alive connection is held open
+	size_t _reloadDrainTimeout;					  // ms connections may stay on a configuration replaced by a reload
+	size_t _acceptBatch;						  // Max connections accepted per listener wakeup
+	size_t _sendBudget;							  // Bytes written to one connection per loop turn
+	size_t _recvBudget;							  // Bytes read from one connection per loop turn
+	size_t _requestBudget;						  // Pipelined requests parsed for one connection per loop turn
+	size_t _workerConnections;					  // Max open client connections per process (0 = from RLIMIT_NOFILE)
+	EventBackend::Type _eventBackend;			  // Readiness backend of the event loops
+
+	// Flags
+	bool _modified;
+
+public:
+	GlobalConfig();
+	GlobalConfig(GlobalConfig const &src);
+	~GlobalConfig();
+	GlobalConfig &operator=(GlobalConfig const &rhs);
+
+	// Investigators
+	bool isModified() const;
+	bool isCpuAffinityAuto() const;
+	bool hasCpuAffinity() const;
+
+	// Accessors
+	size_t getWorkerProcesses() const;
+	size_t getWorkerThreads() const;
+	size_t getIoThreads() const;
+	const std::vector<std::string> &getCpuAffinityMasks() const;
+	size_t getClientHeaderTimeout() const;
+	size_t getClientBodyTimeout() const;
+	size_t getSendTimeout() const;
+	size_t getKeepaliveTimeout() const;
+	size_t getReloadDrainTimeout() const;
+	size_t getAcceptBatch() const;
+	size_t getWorkerConnections() const;
+	size_t getSendBudget() const;
+	size_t getRecvBudget() const;
+	size_t getRequestBudget() const;
+	EventBackend::Type getEventBackend() const;
+
+	// Mutators
+	void setWorkerProcesses(size_t workerProcesses);
+	void setWorkerThreads(size_t workerThreads);
+	void setIoThreads(size_t ioThreads);
+	void setCpuAffinityAuto(bool cpuAffinityAuto);
+	void insertCpuAffinityMask(const std::string &mask);
+	void setClientHeaderTimeout(size_t timeoutMs);
+	void setClientBodyTimeout(size_t timeoutMs);
+	void setSendTimeout(size_t timeoutMs);
+	void setKeepaliveTimeout(size_t timeoutMs);
+	void setReloadDrainTimeout(size_t timeoutMs);
+	void setAcceptBatch(size_t acceptBatch);
+	void setWorkerConnections(size_t workerConnections);
+	void setSendBudget(size_t sendBudget);
+	void setRecvBudget(size_t recvBudget);
+	void setRequestBudget(size_t requestBudget);
+	void setEventBackend(EventBackend::Type eventBackend);
+};
+
+std::ostream &operator<<(std::ostream &o, GlobalConfig const &i);
+
+#endif /* **************************************************** GLOBALCONFIG_H                                          \
+		*/
@@ -18,6 +18,10 @@ public:
 
 	// Virtual method to check if this handler can handle the given method
 	virtual bool canHandle(const std::string &method) const = 0;
+
+	// Whether handling the request only blocks on the file system, so it may run on an I/O thread instead of the
+	// event loop
+	virtual bool canOffload(const HttpRequest &request, const Location *location) const = 0;
 };
 
 #endif /* IMETHODHANDLER_HPP */
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef IOCOMPLETIONQUEUE_HPP
+#define IOCOMPLETIONQUEUE_HPP
+
+#include "../../includes/Core/FileIoPool.hpp"
+#include "../../includes/Wrapper/FileDescriptor.hpp"
+
+// Finished file I/O jobs on their way back to one event loop. Any number of pool threads push, only the loop takes.
+// Lock-free: a push is a compare-and-swap onto a stack, the loop detaches the whole stack with one exchange and
+// reverses it into completion order. Only a push onto an empty stack writes the eventfd, the loop takes everything
+// pushed before it wakes.
+class IoCompletionQueue
+{
+private:
+	FileIoPool::Job *volatile _top; // newest completion
+	FileDescriptor _eventFd;		// wakeup for the loop
+
+	// Non-copyable
+	IoCompletionQueue(IoCompletionQueue const &src);
+	IoCompletionQueue &operator=(IoCompletionQueue const &rhs);
+
+public:
+	IoCompletionQueue();
+	~IoCompletionQueue();
+
+	// Producer side
+	void push(FileIoPool::Job *job);
+
+	// Consumer side
+	FileIoPool::Job *takeAll();
+	void drainNotifications();
+
+	int getEventFd() const;
+};
+
+#endif /* ************************************************* IOCOMPLETIONQUEUE_H                                          \
+		*/
@@ -0,0 +1,76 @@
+#ifndef IOURINGBACKEND_HPP
+#define IOURINGBACKEND_HPP
+
+#include "../../includes/Core/EventBackend.hpp"
+#include "../../includes/Wrapper/FileDescriptor.hpp"
+#include <cstddef>
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <vector>
+
+// io_uring event backend built on raw syscalls (no liburing). Interest is expressed as multishot POLL_ADD requests,
+// which post a completion on every readiness wakeup like an edge triggered epoll registration does. Registration
+// changes are queued in the submission ring and go to the kernel together with the wait, one io_uring_enter per
+// loop turn. Completions carry fd and a generation in user_data so results of cancelled polls are dropped.
+class IoUringBackend : public EventBackend
+{
+private:
+	struct Registration
+	{
+		EpollTag *tag;		 // NULL when the fd is not registered
+		uint32_t events;	 // poll mask, epoll only flags stripped
+		uint32_t generation; // bumped on every arm and removal
+		bool armed;			 // a POLL_ADD is in flight
+		bool rearm;			 // the kernel ended the multishot poll, armed again by the next wait()
+
+		Registration() : tag(NULL), events(0), generation(0), armed(false), rearm(false)
+		{
+		}
+	};
+
+	FileDescriptor _ringFd;
+	void *_sqRing;
+	size_t _sqRingSize;
+	void *_cqRing;
+	size_t _cqRingSize;
+	struct io_uring_sqe *_sqes;
+	size_t _sqesSize;
+
+	// Ring fields shared with the kernel
+	unsigned *_sqHead;
+	unsigned *_sqTail;
+	unsigned *_sqMask;
+	unsigned *_sqArray;
+	unsigned _sqEntries;
+	unsigned *_cqHead;
+	unsigned *_cqTail;
+	unsigned *_cqMask;
+	struct io_uring_cqe *_cqes;
+
+	std::vector<Registration> _registrations; // indexed by fd
+	std::vector<int> _rearm;				  // fds whose multishot poll ended
+	struct __kernel_timespec _timeout;		  // read by the kernel when the timeout sqe is submitted
+
+	struct io_uring_sqe *_nextSqe();
+	int _enter(unsigned minComplete);
+	void _arm(int fd);
+	void _cancel(Registration &registration, int fd);
+	Registration &_registration(int fd);
+
+	// Non-copyable
+	IoUringBackend(IoUringBackend const &src);
+	IoUringBackend &operator=(IoUringBackend const &rhs);
+
+public:
+	explicit IoUringBackend(unsigned entries); // throws std::runtime_error when io_uring is unavailable
+	~IoUringBackend();
+
+	void addFd(EpollTag &tag, uint32_t events);
+	void modifyFd(EpollTag &tag, uint32_t events);
+	void removeFd(int fd);
+	int wait(std::vector<epoll_event> &events, int timeout);
+	const char *getName() const;
+};
+
+#endif /* *************************************************** IOURINGBACKEND_H                                          \
+		*/
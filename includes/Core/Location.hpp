@@ -21,6 +21,10 @@ private:
 	std::pair<int, std::string> _redirect;
 	std::string _cgiPath;
 	double _clientMaxBodySize;
+	bool _hasLimitRate;
+	size_t _limitRate; // overrides the server's limit_rate, 0 lifts it
+	bool _hasLimitRateAfter;
+	size_t _limitRateAfter;
 	std::map<std::string, std::string> _cgiParams;
 
 	// Flags
@@ -51,6 +55,8 @@ public:
 	bool hasIndexes() const;
 	bool hasCgiPath() const;
 	bool hasClientMaxBodySize() const;
+	bool hasLimitRate() const;
+	bool hasLimitRateAfter() const;
 	bool hasCgiParams() const;
 	bool hasModified() const;
 	bool hasRoot() const;
@@ -64,6 +70,8 @@ public:
 	const TrieTree<std::string> &getIndexes() const;
 	const std::string &getCgiPath() const;
 	double getClientMaxBodySize() const;
+	size_t getLimitRate() const;
+	size_t getLimitRateAfter() const;
 	const std::map<std::string, std::string> &getCgiParams() const;
 
 	// Mutators
@@ -76,6 +84,8 @@ public:
 	void setAutoIndex(const bool &autoIndex);
 	void setCgiPath(const std::string &cgiPath);
 	void setClientMaxBodySize(double size);
+	void setLimitRate(size_t limitRate);
+	void setLimitRateAfter(size_t limitRateAfter);
 	void setCgiParam(const std::string &key, const std::string &value);
 };
 
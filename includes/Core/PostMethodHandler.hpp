@@ -20,6 +20,7 @@ public:
 	virtual bool handleRequest(const HttpRequest &request, HttpResponse &response, 
 							  const Server *server, const Location *location);
 	virtual bool canHandle(const std::string &method) const;
+	virtual bool canOffload(const HttpRequest &request, const Location *location) const;
 
 private:
 	// Helper methods
@@ -27,7 +28,7 @@ private:
 						  const Server *server, const Location *location);
 	bool handleFileUpload(const HttpRequest &request, HttpResponse &response, 
 						  const Server *server, const Location *location);
-	bool isCgiRequest(const std::string &uri, const Location *location);
+	bool isCgiRequest(const std::string &uri, const Location *location) const;
 	std::string getUploadPath(const Server *server, const Location *location);
 	bool saveUploadedFile(const std::string &filePath, const std::string &content);
 };
@@ -17,6 +17,7 @@ public:
 	virtual bool handleRequest(const HttpRequest &request, HttpResponse &response, const Server *server,
 							   const Location *location);
 	virtual bool canHandle(const std::string &method) const;
+	virtual bool canOffload(const HttpRequest &request, const Location *location) const;
 
 private:
 	bool _ensureDirectory(const std::string &filePath) const;
@@ -2,6 +2,7 @@
 #define SERVER_HPP
 
 #include "../../includes/Core/Location.hpp"
+#include "../../includes/Wrapper/ListeningSocket.hpp"
 #include "../../includes/Wrapper/SocketAddress.hpp"
 #include "../../includes/Wrapper/TrieTree.hpp"
 #include <iostream>
@@ -16,6 +17,8 @@ private:
 	// Identifier members
 	TrieTree<std::string> _serverNames;
 	std::vector<SocketAddress> _sockets;
+	std::vector<std::pair<SocketAddress, size_t> > _connectionLimits; // listen ... max_connections=N
+	std::vector<std::pair<SocketAddress, ListenOptions> > _listenOptions; // listen ... backlog=N rcvbuf=SIZE ...
 
 	// Main members
 	std::string _rootPath;
@@ -26,6 +29,10 @@ private:
 	std::map<int, std::string> _statusPages;
 	TrieTree<Location> _locations;
 	bool _keepAlive;
+	bool _tcpNoDelay; // accepted sockets get TCP_NODELAY
+	bool _tcpNoPush;  // heads and file bodies are corked together
+	size_t _limitRate;		// bytes per second a response is sent at, 0 = unlimited
+	size_t _limitRateAfter; // bytes of a response sent at full speed before limit_rate applies
 
 	// Flags
 	bool _modified;
@@ -45,15 +52,22 @@ public:
 	bool hasAutoIndex() const; // Line exists
 	bool isAutoIndex() const;  // Line value
 	bool isKeepAlive() const;
+	bool isTcpNoDelay() const;
+	bool isTcpNoPush() const;
+	bool hasListenOptions(const SocketAddress &socketAddress) const;
 	bool isModified() const;
 	bool hasRootPath() const;
 
 	// Accessors
 	const TrieTree<std::string> &getServerNames() const;
 	const std::vector<SocketAddress> &getSocketAddresses() const;
+	size_t getConnectionLimit(const SocketAddress &socketAddress) const; // 0 = no limit of its own
+	ListenOptions getListenOptions(const SocketAddress &socketAddress) const; // defaults when none were given
 	const std::string &getRootPath() const;
 	const TrieTree<std::string> &getIndexes() const;
 	double getClientMaxBodySize() const;
+	size_t getLimitRate() const;
+	size_t getLimitRateAfter() const;
 	const std::string &getStatusPath(int status) const;
 	const std::map<int, std::string> &getStatusPages() const;
 	const TrieTree<Location> &getLocations() const;
@@ -62,11 +76,17 @@ public:
 	// Mutators
 	void insertServerName(const std::string &serverName);
 	void insertSocketAddress(const SocketAddress &socketAddress);
+	void setConnectionLimit(const SocketAddress &socketAddress, size_t limit);
+	void setListenOptions(const SocketAddress &socketAddress, const ListenOptions &options);
 	void insertIndex(const std::string &index);
 	void insertLocation(const Location &location);
 	void insertStatusPage(const std::string &path, const std::vector<int> &codes);
 	void setKeepAlive(const bool &keepAlive);
+	void setTcpNoDelay(const bool &tcpNoDelay);
+	void setTcpNoPush(const bool &tcpNoPush);
 	void setClientMaxBodySize(const double &clientMaxBodySize);
+	void setLimitRate(size_t limitRate);
+	void setLimitRateAfter(size_t limitRateAfter);
 	void setRoot(const std::string &root);
 	void setAutoindex(const bool &autoindex);
 
@@ -3,11 +3,23 @@
 
 #include "../../includes/ConfigParser/ServerMap.hpp"
 #include "../../includes/Core/Client.hpp"
-#include "../../includes/Core/EpollManager.hpp"
+#include "../../includes/Core/ClientTable.hpp"
+#include "../../includes/Core/ConfigSnapshot.hpp"
+#include "../../includes/Core/ConnectionQueue.hpp"
+#include "../../includes/Core/EventBackend.hpp"
+#include "../../includes/Core/FileIoPool.hpp"
+#include "../../includes/Core/GlobalConfig.hpp"
+#include "../../includes/Core/IoCompletionQueue.hpp"
+#include "../../includes/Core/TimerWheel.hpp"
 #include "../../includes/Global/Logger.hpp"
 #include "../../includes/Wrapper/FileDescriptor.hpp"
+#include <csignal>
+#include <deque>
 #include <map>
+#include <pthread.h>
+#include <ctime>
 #include <sys/epoll.h>
+#include <sys/types.h>
 #include <unistd.h>
 #include <vector>
 
@@ -20,26 +32,139 @@ private:
 	ServerManager(ServerManager const &src);
 	ServerManager &operator=(ServerManager const &rhs);
 
-	static bool serverRunning;
+	static volatile bool serverRunning; // read by every reactor thread
+	static volatile size_t _openConnections; // admitted client connections of this process, every reactor included
+
+	// STANDALONE accepts and serves, ACCEPTOR only accepts and hands sockets to REACTOR threads
+	enum Role
+	{
+		STANDALONE,
+		ACCEPTOR,
+		REACTOR
+	};
+
+	struct Reactor
+	{
+		ServerManager *manager; // owns the reactor's epoll instance and clients
+		ConnectionQueue *queue; // acceptor -> reactor handoff
+		pthread_t thread;
+	};
+
+	// Connections still on a replaced configuration generation are closed once its deadline passes
+	struct Drain
+	{
+		size_t generation; // this generation and every older one
+		uint64_t deadline; // monotonic ms
+	};
+
+	// Reactor thread constructor, serves the sockets pushed into handoffQueue
+	ServerManager(ConnectionQueue &handoffQueue, const GlobalConfig &globalConfig, FileIoPool *ioPool);
 
 	void _addServerFdsToEpoll(ServerMap &serverMap);
-	void _handleNewConnection(int serverFd);
+	void _handleNewConnection(EpollTag &listenerTag);
+	void _deferAccept(EpollTag &listenerTag);
+	void _resumeAccepts();
+	void _shedConnection(int listenerFd);
+	void _raiseFileLimit() const;
+	size_t _resolveConnectionLimit() const;
+	bool _admitConnection(const ConfigSnapshot::Listener &listener);
+	static void _releaseConnection(const ConfigSnapshot::Listener &listener);
+	void _rejectConnection(FileDescriptor &clientFd, const ConfigSnapshot::Listener &listener);
+	int _pollTimeout() const;
 	void _handleClientEvent(Client &client, epoll_event event);
+	void _settleClient(Client &client);
+	void _deferClient(Client &client);
+	void _resumeClients();
+	void _registerClient(const FileDescriptor &clientFd, const SocketAddress &remoteAddress, ConfigSnapshot &snapshot,
+						 const ConfigSnapshot::Listener &listener);
+	void _closeClient(int fd);
+	void _armClientTimer(Client &client);
+	void _expireClients();
+
+	// File I/O offloading
+	void _startIoPool();
+	void _stopIoPool();
+	void _submitFileIo(FileIoPool::Job &job);
+	void _completeFileIo();
 
 	// Private methods
+	void _runEventLoop();
 	void _handleEventLoop(int ready_events, std::vector<epoll_event> &events);
 	bool _isClientFd(int fd) const;
 
+	// Threaded reactor mode
+	void _startReactors();
+	void _stopReactors();
+	void _dispatchConnection(FileDescriptor &clientFd, const SocketAddress &remoteAddress,
+							 const ConfigSnapshot::Listener &listener);
+	void _acceptHandoffs();
+	static void _warmSharedCaches();
+	static void *_reactorRoutine(void *arg);
+
+	// Configuration reload
+	void _setupReloadSignal();
+	void _handleSignalFd();
+	void _parseConfig(std::vector<Server> &servers, GlobalConfig &globalConfig) const;
+	void _warnRestartOnly(const GlobalConfig &globalConfig) const;
+	void _applyGlobalConfig(const GlobalConfig &globalConfig);
+	void _reloadConfig();
+	void _reloadMaster();
+	void _removeListeners();
+	void _adoptSnapshot(ConfigSnapshot *snapshot);
+	void _publishSnapshot();
+	void _rebindClient(Client &client);
+	void _drainClients();
+
+	// Master/worker mode
+	void _runMaster();
+	void _runWorker(size_t index);
+	pid_t _spawnWorker(size_t index);
+	bool _superviseExit(pid_t pid, int status);
+	void _pinWorker(size_t index) const;
+	void _stopWorkers();
+
 	// Signal handlers
 	static void _handleSignal(int signal);
 
 	// Internal members
 	ServerMap _serverMap;			// Map to servers via their host_port/connection fd
-	std::map<int, Client> _clients; // clients that are currently active
-	EpollManager _epollManager;		// epoll instance class
+	ClientTable _clients;			// clients that are currently active, indexed by fd
+	TimerWheel _timers;				// one deadline per client, drives the epoll_wait timeout
+	uint64_t _now;					// monotonic ms, refreshed once per loop iteration
+	std::vector<epoll_event> _events; // epoll_wait output, allocated once
+	std::vector<void *> _expired;	  // scratch list of clients whose deadline passed
+	std::vector<EpollTag *> _pendingAccepts; // listeners with a backlog left over from the previous turn
+	std::vector<Client *> _readyClients;	  // clients that used up a per turn budget with work left, resumed next turn
+	uint64_t _acceptPausedUntil;			  // monotonic ms, accepting stops until then after running out of fds
+	FileDescriptor _reserveFd;				  // spare descriptor given up to shed a connection on EMFILE
+	size_t _connectionLimit;				  // worker_connections, bounded by what RLIMIT_NOFILE can hold
+	uint64_t _shedLogAt;					  // monotonic ms, next time shedding may be logged
+	GlobalConfig _globalConfig;		// process wide settings (worker count, cpu affinity)
+	EventBackend *_eventBackend;	// readiness backend (epoll or io_uring), owned
+	std::vector<EpollTag> _listenerTags; // epoll data.ptr for each listener, owner is its snapshot listener
+	std::string _configPath;			 // re-read on SIGHUP
+	ConfigSnapshot *_snapshot;			 // current configuration generation, new connections retain it
+	size_t _generation;					 // number of the newest generation built by this process
+	std::deque<Drain> _drains;			 // replaced generations still allowed to finish, oldest first
+	FileDescriptor _signalFd;			 // SIGHUP, not used by REACTOR
+	EpollTag _signalTag;
+	EpollTag _handoffTag;				 // REACTOR only, epoll data.ptr for the handoff eventfd
+	FileIoPool *_ioPool;				 // NULL when io_threads is 0, owned unless REACTOR
+	IoCompletionQueue _completions;		 // jobs this loop submitted, back from the pool
+	EpollTag _completionTag;			 // epoll data.ptr for the completion eventfd
+
+	Role _role;
+	ConnectionQueue *_handoffQueue; // REACTOR only, borrowed from the acceptor
+	std::vector<Reactor> _reactors; // ACCEPTOR only
+	size_t _nextReactor;			// round robin cursor for handoffs
+
+	// Master bookkeeping, indexed by worker slot (-1 = slot not running)
+	std::vector<pid_t> _workerPids;
+	std::vector<time_t> _workerStartTimes;
 
 public:
-	explicit ServerManager(ServerMap &serverMap);
+	explicit ServerManager(ServerMap &serverMap, const GlobalConfig &globalConfig = GlobalConfig(),
+						   const std::string &configPath = "");
 	~ServerManager();
 
 	void run();
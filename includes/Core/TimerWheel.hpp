@@ -0,0 +1,64 @@
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+// Hierarchical timer wheel (4 levels x 64 slots, 10 ms ticks, ~46 h horizon) on the monotonic clock.
+// Timers are intrusive list nodes owned by the caller: schedule, reschedule and cancel are O(1) and never
+// allocate. Far timers cascade down a level as the wheel turns, so advancing costs O(expired) amortised.
+class TimerWheel
+{
+public:
+	struct Timer
+	{
+		Timer *prev;
+		Timer *next;
+		uint64_t expiry; // absolute tick
+		void *owner;	 // handed back on expiry
+
+		Timer() : prev(NULL), next(NULL), expiry(0), owner(NULL)
+		{
+		}
+		bool isArmed() const
+		{
+			return next != NULL;
+		}
+	};
+
+	static const unsigned int LEVELS = 4;
+	static const unsigned int SLOT_BITS = 6;
+	static const unsigned int SLOTS = 1u << SLOT_BITS;
+	static const uint64_t TICK_MS = 10;
+
+private:
+	Timer _slots[LEVELS][SLOTS]; // list sentinels
+	uint64_t _current;			 // last tick that has been processed
+	size_t _count;				 // armed timers
+
+	void _place(Timer &timer);
+	void _cascade(unsigned int level, unsigned int slot);
+	static void _unlink(Timer &timer);
+
+	// Non-copyable, the sentinels point at themselves
+	TimerWheel(TimerWheel const &src);
+	TimerWheel &operator=(TimerWheel const &rhs);
+
+public:
+	explicit TimerWheel(uint64_t nowMs);
+	~TimerWheel();
+
+	void schedule(Timer &timer, uint64_t deadlineMs);
+	void cancel(Timer &timer);
+	void advance(uint64_t nowMs, std::vector<void *> &expired);
+
+	// Milliseconds epoll may sleep before the next expiry or cascade, -1 when nothing is armed
+	int msUntilNext(uint64_t nowMs) const;
+	size_t size() const;
+
+	static uint64_t monotonicMs();
+};
+
+#endif /* ******************************************************* TIMERWHEEL_H                                          \
+		*/
@@ -0,0 +1,53 @@
+#ifndef CHARSCAN_HPP
+#define CHARSCAN_HPP
+
+#include <cstddef>
+
+// Byte scanning shared by the request parser, the CGI header parser and the config tokeniser.
+// Character classes come from one 256 entry table. Delimiter and control byte searches run 16 (SSE2) or 32 (AVX2)
+// bytes per step; the kernel is picked once at startup from what the CPU supports, other architectures get the
+// scalar loop.
+namespace CharScan
+{
+enum CharClass
+{
+	TOKEN = 0x01,		// RFC 9110 tchar, plus the '/' StrUtils has always let through
+	CONTROL = 0x02,		// 0x00-0x1F and 0x7F
+	SPACE = 0x04,		// isspace() in the C locale
+	CONFIG_WORD = 0x08, // identifier, number or path in the config file
+	DIGIT = 0x10		// 0-9
+};
+
+extern const unsigned char CLASSES[256];
+
+inline bool is(unsigned char c, unsigned char charClass)
+{
+	return (CLASSES[c] & charClass) != 0;
+}
+
+// First byte of [begin, end) outside the class, end when there is none
+inline const char *skip(const char *begin, const char *end, unsigned char charClass)
+{
+	while (begin != end && is(static_cast<unsigned char>(*begin), charClass))
+		++begin;
+	return begin;
+}
+
+// Searches of [begin, end), end when nothing matches
+const char *findCrlf(const char *begin, const char *end);
+const char *findDoubleCrlf(const char *begin, const char *end);
+const char *findControl(const char *begin, const char *end);
+
+// First byte a URI path normaliser has to act on: '%', '+', or a '/' followed by '/' or '.'. A dot anywhere else
+// cannot start a "." or ".." segment.
+const char *findUriSpecial(const char *begin, const char *end);
+
+// End of a CGI header block: the first "\r\n\r\n", or failing that the first "\n\n"
+const char *findHeaderEnd(const char *begin, const char *end, size_t &separatorLength);
+
+// Kernel picked at startup: "avx2", "sse2" or "scalar"
+const char *kernelName();
+} // namespace CharScan
+
+#endif /* ******************************************************** CHARSCAN_H                                          \
+		*/
@@ -1,6 +1,7 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
+#include "../../includes/Wrapper/Mutex.hpp"
 #include <cstring>
 #include <ctime>
 #include <fstream>
@@ -36,11 +37,13 @@ private:
 	static bool _sessionInitialized;
 	static std::ofstream _logFile;
 	static LogLevel _minLogLevel;
+	static Mutex _mutex; // Serialises file and console writes across reactor threads
 
 	// Private helper methods
 	static std::string _getCurrentTime();
 	static std::string _getLevelString(LogLevel level);
 	static void _logToConsole(LogLevel level, const std::string &logEntry);
+	static void _writeEntry(LogLevel level, const std::string &logEntry);
 	static void _createLogDirectory();
 	static void _generateSessionId();
 	static void _openSessionLogFile();
@@ -1,6 +1,7 @@
 #ifndef PERFORMANCEMONITOR_HPP
 #define PERFORMANCEMONITOR_HPP
 
+#include "../../includes/Wrapper/Mutex.hpp"
 #include <ctime>
 #include <string>
 #include <sys/resource.h>
@@ -46,13 +47,15 @@ public:
 		size_t epollEventsProcessed;
 		size_t timeoutsOccurred;
 		size_t errorsOccurred;
+		size_t rejectedConnections; // answered with 503 by admission control
 
 		Metrics()
 			: totalRequestTime(0), averageRequestTime(0), minRequestTime(0), maxRequestTime(0), totalCGITime(0),
 			  averageCGITime(0), totalFileReadTime(0), averageFileReadTime(0), totalConnections(0),
 			  activeConnections(0), totalRequests(0), successfulRequests(0), failedRequests(0), bytesTransferred(0),
 			  peakMemoryUsage(0), currentMemoryUsage(0), totalMemoryAllocated(0), fileDescriptorsUsed(0),
-			  maxFileDescriptors(0), cpuUsagePercent(0), epollEventsProcessed(0), timeoutsOccurred(0), errorsOccurred(0)
+			  maxFileDescriptors(0), cpuUsagePercent(0), epollEventsProcessed(0), timeoutsOccurred(0), errorsOccurred(0),
+			  rejectedConnections(0)
 		{
 		}
 	};
@@ -107,7 +110,11 @@ private:
 	// Memory tracking
 	size_t _initialMemoryUsage;
 
+	// Guards every metric above, recorders may run on several reactor threads at once
+	mutable Mutex _mutex;
+
 	// Private helper methods
+	void _calculateStatistics();
 	void _updateSystemMetrics();
 	void _updateMemoryMetrics();
 	void _updateFileDescriptorMetrics();
@@ -135,6 +142,7 @@ public:
 	void recordEpollEvent();
 	void recordTimeout();
 	void recordError();
+	void recordRejectedConnection();
 
 	// Metrics access
 	const Metrics &getCurrentMetrics() const
@@ -208,6 +216,7 @@ public:
 #define PERF_RECORD_EPOLL_EVENT() PerformanceMonitor::getInstance().recordEpollEvent()
 #define PERF_RECORD_TIMEOUT() PerformanceMonitor::getInstance().recordTimeout()
 #define PERF_RECORD_ERROR() PerformanceMonitor::getInstance().recordError()
+#define PERF_RECORD_REJECTED_CONNECTION() PerformanceMonitor::getInstance().recordRejectedConnection()
 
 #define PERF_UPDATE_SYSTEM_METRICS() PerformanceMonitor::getInstance().updateSystemMetrics()
 #define PERF_LOG_REPORT() PerformanceMonitor::getInstance().logPerformanceReport()
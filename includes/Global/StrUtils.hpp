@@ -1,6 +1,7 @@
 #ifndef STRINGUTILS_HPP
 #define STRINGUTILS_HPP
 
+#include "CharScan.hpp"
 #include <algorithm>
 #include <cctype>
 #include <cstddef>
@@ -109,7 +110,7 @@ inline bool isControlCharacter(unsigned char c)
 	// 0x0C - FF
 	// 0x0D - CR
 	// 0x7F - DEL
-	return (c < 0x20 || c == 0x7F);
+	return CharScan::is(c, CharScan::CONTROL);
 }
 
 // Check if character is valid in a path
@@ -133,18 +134,13 @@ inline int hexCharToInt(char c)
 // RFC 7230 §3.2.6: Token
 inline bool isValidTokenCharacter(char c)
 {
-	return std::string("!#$%&'*+-./^_`|~0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ").find(c) !=
-		   std::string::npos;
+	return CharScan::is(static_cast<unsigned char>(c), CharScan::TOKEN);
 }
 
 inline bool isValidToken(const std::string &str)
 {
-	for (size_t i = 0; i < str.size(); ++i)
-	{
-		if (!isValidTokenCharacter(str[i]))
-			return false;
-	}
-	return true;
+	const char *begin = str.data();
+	return CharScan::skip(begin, begin + str.size(), CharScan::TOKEN) == begin + str.size();
 }
 
 // ============================================================
@@ -154,12 +150,8 @@ inline bool isValidToken(const std::string &str)
 // Check if string contains control characters
 inline bool hasControlCharacters(const std::string &str)
 {
-	for (size_t i = 0; i < str.size(); ++i)
-	{
-		if (isControlCharacter(static_cast<unsigned char>(str[i])))
-			return true;
-	}
-	return false;
+	const char *begin = str.data();
+	return CharScan::findControl(begin, begin + str.size()) != begin + str.size();
 }
 
 // Check if string contains only printable ASCII (0x20-0x7E)
@@ -188,12 +180,9 @@ inline bool hasConsecutiveDots(const std::string &str)
 // Find first control character position
 inline size_t findControlCharacter(const std::string &str)
 {
-	for (size_t i = 0; i < str.size(); ++i)
-	{
-		if (isControlCharacter(static_cast<unsigned char>(str[i])))
-			return i;
-	}
-	return std::string::npos;
+	const char *begin = str.data();
+	size_t pos = CharScan::findControl(begin, begin + str.size()) - begin;
+	return pos == str.size() ? std::string::npos : pos;
 }
 
 // Get human-readable representation of control character
@@ -381,16 +370,85 @@ inline std::string trimTrailingSlashes(const std::string &path)
 	return path.substr(0, end + 1);
 }
 
-// Full URI path sanitization (decode, normalize, remove traversal)
-inline std::string sanitizeUriPath(const std::string &path)
+// percentDecode(), normalizeSlashes() and removeDotSegments() in one pass over the string itself. Decoding only
+// shrinks and every segment written is preceded by at least one slash read, so the write cursor never passes the
+// read cursor. Paths with nothing to decode, collapse or resolve are left untouched after a vectorised scan.
+// False when a ".." had nothing left to remove, the path is still normalised as if it stopped at "/".
+inline bool normalizeUriPath(std::string &path)
 {
-	std::string decoded = percentDecode(path);
-	std::string normalized = normalizeSlashes(decoded);
-	std::string clean = removeDotSegments(normalized);
+	if (path.empty() || path[0] != '/')
+		path.insert(path.begin(), '/');
+	char *begin = &path[0];
+	char *end = begin + path.size();
+	const char *special = CharScan::findUriSpecial(begin, end);
+	if (special == end)
+	{
+		if (end[-1] != '/' || path.size() == 1)
+			return true;
+		special = end - 1; // only the trailing slash to drop
+	}
 
-	if (clean.empty() || clean[0] != '/')
-		clean = "/" + clean;
+	// Everything before the segment holding the first special byte is already in its final form
+	char *write = const_cast<char *>(special);
+	while (*write != '/')
+		--write;
+	const char *read = write;
+	char *segment = NULL; // first byte of the segment being written, NULL between segments
+	bool contained = true;
+	while (true)
+	{
+		bool atEnd = read == end;
+		char c = '/';
+		if (!atEnd)
+		{
+			c = *read++;
+			if (c == '%' && end - read >= 2 && hexCharToInt(read[0]) != -1 && hexCharToInt(read[1]) != -1)
+			{
+				c = static_cast<char>(hexCharToInt(read[0]) * 16 + hexCharToInt(read[1]));
+				read += 2;
+			}
+			else if (c == '+')
+				c = ' ';
+		}
+		if (c != '/')
+		{
+			if (segment == NULL)
+			{
+				*write++ = '/';
+				segment = write;
+			}
+			*write++ = c;
+			continue;
+		}
+		if (segment != NULL)
+		{
+			size_t length = write - segment;
+			if (length == 1 && segment[0] == '.')
+				write = segment - 1;
+			else if (length == 2 && segment[0] == '.' && segment[1] == '.')
+			{
+				write = segment - 1;
+				if (write == begin)
+					contained = false;
+				while (write != begin && *--write != '/')
+					;
+			}
+			segment = NULL;
+		}
+		if (atEnd)
+			break;
+	}
+	if (write == begin)
+		*write++ = '/';
+	path.resize(write - begin);
+	return contained;
+}
 
+// Full URI path sanitization (decode, normalize, remove traversal)
+inline std::string sanitizeUriPath(const std::string &path)
+{
+	std::string clean = path;
+	normalizeUriPath(clean);
 	return clean;
 }
 
@@ -15,17 +15,16 @@
 // HTTP Constants
 namespace HTTP
 {
-const char *const SINGLETON_HEADERS[] = {
-	"host",			 "content-length",		"content-type", "content-location", "date",		   "etag",
-	"expires",		 "last-modified",		"location",		"server",			"user-agent",  "referer",
-	"authorization", "proxy-authorization", "expect",		"upgrade",			"retry-after", "content-range"};
 static const std::string HTTP_VERSION = "HTTP/1.1";
 static const std::string TEMP_FILE_TEMPLATE = "/tmp/webserv-";
 const ssize_t DEFAULT_CLIENT_MAX_REQUEST_LINE_SIZE = 8192; // 8KB
 const ssize_t DEFAULT_CLIENT_MAX_URI_SIZE = 16384;		   // 16KB
 const ssize_t DEFAULT_CLIENT_MAX_HEADERS_SIZE = 32768;	   // 32KB
 const ssize_t DEFAULT_CLIENT_MAX_BODY_SIZE = 1048576;	   // 1MB
-const ssize_t DEFAULT_RECV_SIZE = 4096;					   // 4KB
+const ssize_t DEFAULT_RECV_SIZE = 4096;					   // 4KB, first read of a connection
+const size_t MIN_RECV_SIZE = 1024;						   // reads shrink no further
+const size_t MAX_RECV_SIZE = 65536;						   // reads grow no further
+const size_t RECV_SHRINK_READS = 8;						   // consecutive reads under a quarter full before halving
 const ssize_t DEFAULT_SEND_SIZE = 4096;					   // 4KB
 static const char *const CRLF = "\r\n";					   // CRLF
 const int DEFAULT_TIMEOUT_SECONDS = 30;					   // 30 second timeout
@@ -33,6 +32,47 @@ static const std::string DEFAULT_HOST = "0.0.0.0";
 static const unsigned short DEFAULT_PORT = 80;
 static const bool DEFAULT_AUTOINDEX = false;
 static const bool DEFAULT_KEEP_ALIVE = true;
+static const bool DEFAULT_TCP_NODELAY = true;  // keep-alive responses are not held back by Nagle
+static const bool DEFAULT_TCP_NOPUSH = false;  // no corking of heads with their file bodies
+const int LISTEN_DEFER_ACCEPT_SECONDS = 1;	   // listen ... deferred: wait this long for the first request bytes
+const size_t DEFAULT_WORKER_PROCESSES = 1;	  // single process, no master/worker split
+const int WORKER_RESPAWN_BACKOFF_SECONDS = 1; // Min lifetime before a dead worker is respawned immediately
+const size_t DEFAULT_WORKER_THREADS = 1;	  // reactor threads per process (1 = acceptor serves clients itself)
+const size_t DEFAULT_HANDOFF_QUEUE_SIZE = 1024; // accepted fds buffered per reactor thread
+const size_t DEFAULT_IO_THREADS = 4;			// file I/O threads per process (0 = handlers run on the event loop)
+const size_t FILE_IO_QUEUE_SIZE = 1024;		// file I/O jobs waiting for a thread, past it they run on the loop
+const size_t FILE_IO_PREFETCH_SIZE = 262144;	// head of a file body read into the page cache by the I/O thread
+const size_t DEFAULT_CLIENT_SLAB_SIZE = 64;	   // client slots preallocated per event loop, doubles on demand
+const size_t DEFAULT_EPOLL_EVENTS = 128;		   // events harvested per epoll_wait
+const unsigned DEFAULT_IO_URING_ENTRIES = 256;	   // submission ring size of the io_uring backend
+const size_t DEFAULT_CLIENT_HEADER_TIMEOUT_MS = 30000; // full request head, counted from its first byte
+const size_t DEFAULT_CLIENT_BODY_TIMEOUT_MS = 60000;   // between two body reads
+const size_t DEFAULT_SEND_TIMEOUT_MS = 60000;		   // between two response writes
+const size_t DEFAULT_KEEPALIVE_TIMEOUT_MS = 75000;	   // idle between requests
+const size_t DEFAULT_RELOAD_DRAIN_TIMEOUT_MS = 60000; // connections left on a replaced configuration are then closed
+const size_t DEFAULT_ACCEPT_BATCH = 64;			   // connections accepted per listener wakeup before yielding
+const size_t DEFAULT_SEND_BUDGET = 524288;		   // bytes written to one connection per loop turn before yielding
+const size_t DEFAULT_RECV_BUDGET = 262144;		   // bytes read from one connection per loop turn before yielding
+const size_t DEFAULT_REQUEST_BUDGET = 16;		   // pipelined requests parsed for one connection per loop turn
+const size_t CGI_BUFFERED_OUTPUT = 65536;		   // CGI output read into memory, a longer body is spliced from the pipe
+const int CGI_STREAM_TIMEOUT_MS = 30000;		   // a spliced CGI body may stall this long before the response fails
+const size_t MAX_COALESCED_IOV = 64;			   // iovecs gathered from queued pipelined responses into one write
+const size_t COALESCED_INLINE_LIMIT = 16384;	   // file bodies up to this size are read into a gathered write
+const size_t LIMIT_RATE_WINDOW_MS = 100;		   // a throttled response wakes to send this long's worth of its rate
+const size_t ACCEPT_PAUSE_MS = 100;				   // accepting is paused this long after EMFILE/ENFILE
+const size_t DEFAULT_WORKER_CONNECTIONS = 0;		   // 0 = derived from RLIMIT_NOFILE
+const size_t FDS_PER_CONNECTION = 2;			   // the socket plus the file or CGI pipe serving it
+const size_t RESERVED_FDS = 64;					   // listeners, epoll, logs, eventfds... kept out of the connection budget
+const size_t OPEN_FILES_CEILING = 1048576;		   // default fs.nr_open, used when the hard RLIMIT_NOFILE is unlimited
+const size_t SHED_LOG_INTERVAL_MS = 1000;		   // at most one "shedding connections" warning per interval
+// Sent to connections refused by admission control, straight from static storage
+static const char OVERLOAD_RESPONSE[] = "HTTP/1.1 503 Service Unavailable\r\n"
+										"Content-Type: text/plain\r\n"
+										"Content-Length: 24\r\n"
+										"Retry-After: 1\r\n"
+										"Connection: close\r\n"
+										"\r\n"
+										"503 Service Unavailable\n";
 
 inline bool isSupportedMethod(const std::string &method)
 {
@@ -1,6 +1,7 @@
 #ifndef HEADER_HPP
 #define HEADER_HPP
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -43,6 +44,11 @@ public:
 
 	// Methods
 	void merge(const Header &other);
+
+	// Runs the constructor's checks over a raw line without building any string. NULL when the line is well formed,
+	// else the reason the constructor would throw with.
+	static const char *check(const char *line, size_t length);
+	static size_t findParameters(const char *line, size_t from, size_t length);
 };
 
 std::ostream &operator<<(std::ostream &os, const Header &header);
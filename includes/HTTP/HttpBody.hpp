@@ -4,6 +4,7 @@
 #include "../../includes/HTTP/HttpResponse.hpp"
 #include "../../includes/Wrapper/FileDescriptor.hpp"
 #include "../../includes/Wrapper/FileManager.hpp"
+#include "../../includes/Wrapper/RingBuffer.hpp"
 #include <cerrno>
 #include <climits>
 #include <cstdlib>
@@ -56,8 +57,8 @@ private:
 	bool _isUsingTempFile;
 
 	// Parsing paths
-	BodyState _parseChunkedBody(std::vector<char> &buffer, HttpResponse &response);
-	BodyState _parseContentLengthBody(std::vector<char> &buffer, HttpResponse &response);
+	BodyState _parseChunkedBody(RingBuffer &buffer, HttpResponse &response);
+	BodyState _parseContentLengthBody(RingBuffer &buffer, HttpResponse &response);
 
 	// Decoding methods
 	ssize_t _parseHexSize(const std::string &hexStr) const;
@@ -69,7 +70,7 @@ public:
 
 	HttpBody &operator=(HttpBody const &rhs);
 
-	void parseBuffer(std::vector<char> &buffer, HttpResponse &response);
+	void parseBuffer(RingBuffer &buffer, HttpResponse &response);
 
 	// Accessors
 	BodyState getBodyState() const;
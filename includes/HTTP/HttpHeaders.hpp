@@ -1,57 +1,81 @@
-#ifndef HTTPHEADERS_HPP
-#define HTTPHEADERS_HPP
-
-#include "../../includes/HTTP/Header.hpp"
-#include "../../includes/HTTP/HttpBody.hpp"
-#include "../../includes/HTTP/HttpResponse.hpp"
-#include <cstddef>
-#include <cstdlib>
-#include <ctime>
-#include <string>
-#include <sys/types.h>
-#include <unistd.h>
-#include <vector>
-
-class HttpHeaders
-{
-
-public:
-	enum HeadersState
-	{
-		HEADERS_PARSING = 0,
-		HEADERS_PARSING_COMPLETE = 1,
-		HEADERS_PARSING_ERROR = 2
-	};
-
-private:
-	HeadersState _headersState;
-	std::vector<Header> _headers;
-	size_t _rawHeadersSize;
-
-	// Helper methods
-	void parseHeaderLine(const std::string &line, HttpResponse &response);
-	void parseAllHeaders(HttpResponse &response, HttpBody &body);
-
-public:
-	// OOP
-	HttpHeaders();
-	HttpHeaders(HttpHeaders const &src);
-	~HttpHeaders();
-	HttpHeaders &operator=(HttpHeaders const &rhs);
-
-	// Main parsing method
-	void parseBuffer(std::vector<char> &buffer, HttpResponse &response, HttpBody &body);
-
-	// Accessors
-	int getHeadersState() const;
-	const std::vector<Header> &getHeaders() const;
-	const Header *getHeader(const std::string &headerName) const;
-	size_t getHeadersSize() const;
-
-	// Methods
-	bool isSingletonHeader(const std::string &headerName) const;
-	void reset();
-};
-
-#endif /* ***************************************************** HTTPHEADERS_H                                          \
-		*/
+#ifndef HTTPHEADERS_HPP
+#define HTTPHEADERS_HPP
+
+#include "../../includes/HTTP/Header.hpp"
+#include "../../includes/HTTP/HttpBody.hpp"
+#include "../../includes/HTTP/HttpResponse.hpp"
+#include "../../includes/HTTP/KnownHeaders.hpp"
+#include "../../includes/Wrapper/RingBuffer.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
+class HttpHeaders
+{
+
+public:
+	enum HeadersState
+	{
+		HEADERS_PARSING = 0,
+		HEADERS_PARSING_COMPLETE = 1,
+		HEADERS_PARSING_ERROR = 2
+	};
+
+private:
+	// One header line, as offsets into _raw
+	struct Field
+	{
+		size_t offset;	   // first byte of the line
+		size_t length;	   // line length without its CRLF
+		size_t nameLength; // bytes before the colon
+		KnownHeaders::Id id;
+	};
+
+	HeadersState _headersState;
+	std::string _raw;					  // header lines as received, back to back without their CRLFs
+	std::vector<Field> _fields;			  // one per line, in arrival order
+	int _known[KnownHeaders::COUNT];	  // index in _fields of the first line of each known header, -1 when absent
+	mutable std::vector<Header> _headers; // built from _fields the first time a caller asks for Header objects
+	mutable bool _headersBuilt;
+	size_t _rawHeadersSize;
+
+	// Helper methods
+	void parseHeaderLine(const char *line, size_t length, HttpResponse &response);
+	void parseAllHeaders(HttpResponse &response, HttpBody &body);
+	const Field *_findField(const char *name, size_t length) const;
+	const Field *_findField(KnownHeaders::Id id) const;
+	bool _firstValue(const Field &field, const char *&value, size_t &length) const;
+	void _buildHeaders() const;
+
+public:
+	// OOP
+	HttpHeaders();
+	HttpHeaders(HttpHeaders const &src);
+	~HttpHeaders();
+	HttpHeaders &operator=(HttpHeaders const &rhs);
+
+	// Main parsing method
+	void parseBuffer(RingBuffer &buffer, HttpResponse &response, HttpBody &body);
+
+	// Accessors
+	int getHeadersState() const;
+	const std::vector<Header> &getHeaders() const;
+	const Header *getHeader(const std::string &headerName) const;
+	bool getValue(const char *headerName, const char *&value, size_t &length) const;
+	bool getValue(KnownHeaders::Id id, const char *&value, size_t &length) const;
+	size_t getFieldCount() const;
+	bool getField(size_t index, KnownHeaders::Id &id, std::string &name, const char *&value, size_t &length) const;
+	size_t getHeadersSize() const;
+
+	// Methods
+	bool isSingletonHeader(const std::string &headerName) const;
+	static bool isSingletonHeader(const char *name, size_t length);
+	void reset();
+};
+
+#endif /* ***************************************************** HTTPHEADERS_H                                          \
+		*/
@@ -59,7 +59,7 @@ public:
 	~HttpRequest();
 
 	// Parsing methods
-	ParseState parseBuffer(std::vector<char> &holdingBuffer, HttpResponse &response);
+	ParseState parseBuffer(RingBuffer &holdingBuffer, HttpResponse &response);
 
 	// Sanitization methods
 	void sanitizeRequest(HttpResponse &response, const Server *server, const Location *location);
@@ -82,16 +82,17 @@ public:
 	size_t getMessageSize() const;
 
 	// URI accessors
-	std::string getMethod() const;
-	std::string getUri() const;
-	std::string getRawUri() const;
-	std::string getVersion() const;
-	std::string getQueryString() const;
+	const std::string &getMethod() const;
+	const std::string &getUri() const;
+	const std::string &getRawUri() const;
+	const std::string &getVersion() const;
+	const std::string &getQueryString() const;
 	const std::map<std::string, std::vector<std::string> > &getQueryParameters() const;
 
 	// Headers accessors
 	std::map<std::string, std::vector<std::string> > getHeaders() const;
 	const std::vector<std::string> getHeader(const std::string &name) const;
+	const HttpHeaders &getHeaderFields() const;
 
 	// Body accessors
 	std::string getBodyData() const;
@@ -4,8 +4,11 @@
 #include "../../includes/Core/Location.hpp"
 #include "../../includes/Core/Server.hpp"
 #include "../../includes/HTTP/Header.hpp"
+#include "../../includes/HTTP/KnownHeaders.hpp"
 #include "../../includes/Wrapper/FileDescriptor.hpp"
+#include <stdint.h>
 #include <string>
+#include <sys/uio.h>
 
 namespace HTTP_RESPONSE_DEFAULT
 {
@@ -38,13 +41,16 @@ public: // State of the response
 		FATAL_ERROR = 2
 	};
 
+	static const size_t BUFFERED_IOV_COUNT = 2; // head and in-memory body
+
 private:
 	// State of the response
 	SendingState _sendingState;
 	ResponseType _responseType;
 
 	// Response data
-	std::string _rawResponse;
+	std::string _rawResponse; // serialized status line and headers, the body stays in _body
+	size_t _sendOffset;		  // bytes of _rawResponse then _body already sent
 
 	// URI Portion
 	int _statusCode;
@@ -52,18 +58,42 @@ private:
 	std::string _version;
 
 	// Headers Portion
-	std::vector<Header> _headers;
+	std::vector<Header> _headers;	 // in the order they are sent
+	int _known[KnownHeaders::COUNT]; // index in _headers of each known header, -1 when absent
 
 	// Body Portion
 	std::string _body;
 	bool _streamBody;
 	FileDescriptor _bodyFileDescriptor;
+	bool _sendfileBody;	 // regular file body, sent with sendfile() from _bodyOffset
+	off_t _bodyOffset;	 // next byte of the file to send
+	off_t _bodyRemaining; // bytes of the file still to send, sendfile and pipe paths
+	bool _pipeBody;		  // body is the rest of a CGI's stdout, spliced to the socket after _body
+	bool _passThrough;	  // the body carries its own status line and headers (NPH), no head is formatted
+	bool _closeDelimited; // length unknown, the body ends with the pipe and the connection closes after it
+
+	// Token bucket of limit_rate: refills at _limitRate bytes per second up to two windows' worth, starts with
+	// limit_rate_after plus one window
+	size_t _limitRate;		 // bytes per second, 0 = unlimited
+	size_t _limitRateAfter;	 // initial burst
+	size_t _rateTokens;		 // bytes that may be sent right now
+	uint64_t _rateRefilledAt; // monotonic ms the tokens were last brought up to date, 0 before the first send
 
 	// Private methods
+	Header *_findHeader(const Header &header);
+	void _appendHeader(const Header &header);
+	void _indexHeaders();
 	void _getDateHeader();
 	void _setServerHeader();
 	void _setContentLengthHeader();
 	void _setVersionHeader();
+	void _prepareBodyStream();
+	void _sendBuffered(int socketFd, ssize_t &totalBytesSent, size_t budget);
+	void _sendfileChunk(int socketFd, ssize_t &totalBytesSent, size_t budget);
+	void _copyChunk(int socketFd, ssize_t &totalBytesSent, size_t budget);
+	void _spliceChunk(int socketFd, ssize_t &totalBytesSent, size_t budget);
+	size_t _bufferedBodySize() const;
+	size_t _rateWindow() const;
 
 public:
 	HttpResponse();
@@ -80,6 +110,10 @@ public:
 	std::string getRawResponse() const;
 	SendingState getSendingState() const;
 	ResponseType getResponseType() const;
+	bool isStreamed() const;
+	bool closesConnection() const;
+	bool isRateLimited() const;
+	uint64_t getRateResumeAt() const;
 
 	// Mutators
 	void setHeader(const Header &header);
@@ -101,9 +135,20 @@ public:
 							   const std::string &contentType, ResponseType responseType);
 	void setResponseFile(int statusCode, const std::string &statusMessage, const std::string &filePath,
 						 const std::string &contentType, ResponseType responseType);
+	void setResponseStream(const FileDescriptor &pipe, const std::string &prefix, ssize_t contentLength);
+	void setResponsePassThrough(const FileDescriptor &pipe, const std::string &output);
 	void setRedirectResponse(const std::string &redirectPath, ResponseType responseType);
 	std::string toString() const;
-	void sendResponse(const FileDescriptor &clientSocketFd, ssize_t &totalBytesSent);
+	void formatMessage();
+	bool inlineBody(size_t limit);
+	void prefetchBody(size_t length) const;
+	size_t bufferedRemaining() const;
+	size_t gatherBuffered(struct iovec *iov, size_t allowance) const;
+	void consumeBuffered(size_t bytes);
+	void sendResponse(const FileDescriptor &clientSocketFd, ssize_t &totalBytesSent, size_t budget);
+	void setRateLimit(size_t rate, size_t after);
+	size_t rateAllowance(uint64_t now);
+	void chargeRate(size_t bytes);
 	void reset();
 };
 
@@ -4,6 +4,7 @@
 #include "../../includes/Core/Location.hpp"
 #include "../../includes/Core/Server.hpp"
 #include "../../includes/HTTP/HttpResponse.hpp"
+#include "../../includes/Wrapper/RingBuffer.hpp"
 #include <cstddef>
 #include <string>
 #include <sys/types.h>
@@ -27,15 +28,24 @@ private:
 	URIState _uriState;
 	size_t _uriSize;
 
-	// Request line
+	// Request line, copied once from the receive buffer and kept as spans into _requestLine. Method and target
+	// are read by every request and copied out when it is parsed, the rest only when a caller asks.
+	std::string _requestLine;
+	size_t _targetOffset;
+	size_t _targetLength;
+	size_t _versionOffset;
+	size_t _versionLength;
 	std::string _method;
-	std::string _URI;
-	std::string _rawURI;
-	std::string _version;
+	std::string _URI;			 // target, rewritten in place to the resolved path by sanitizeURI()
+	mutable std::string _rawURI;  // target as received, built on first use
+	mutable std::string _version; // built on first use
 
-	// Query parameters
-	std::string _queryString;
-	std::map<std::string, std::vector<std::string> > _queryParameters;
+	// Query, a span of the target found by sanitizeURI(). String and parameters are built on first use.
+	size_t _queryOffset;
+	size_t _queryLength;
+	mutable std::string _queryString;
+	mutable std::map<std::string, std::vector<std::string> > _queryParameters;
+	mutable bool _queryParsed;
 
 public:
 	// Constructor
@@ -45,7 +55,7 @@ public:
 	HttpURI &operator=(const HttpURI &other);
 
 	// Main parsing method
-	void parseBuffer(std::vector<char> &buffer, HttpResponse &response);
+	void parseBuffer(RingBuffer &buffer, HttpResponse &response);
 	void sanitizeURI(const Server *server, const Location *location, HttpResponse &response);
 
 	// Accessors
@@ -0,0 +1,62 @@
+#ifndef KNOWNHEADERS_HPP
+#define KNOWNHEADERS_HPP
+
+#include <cstddef>
+#include <string>
+
+// Registry of the header names the server knows about. A name is resolved to its id once, when its line is parsed
+// or its Header is stored, through a perfect hash: no two known names share a slot, so a lookup hashes three bytes
+// and compares at most one name. Requests and responses keep one slot per id, unknown names go to a fallback list.
+namespace KnownHeaders
+{
+enum Id
+{
+	HOST,
+	CONTENT_LENGTH,
+	TRANSFER_ENCODING,
+	CONNECTION,
+	CONTENT_TYPE,
+	CONTENT_LOCATION,
+	DATE,
+	ETAG,
+	EXPIRES,
+	LAST_MODIFIED,
+	LOCATION,
+	SERVER,
+	USER_AGENT,
+	REFERER,
+	AUTHORIZATION,
+	PROXY_AUTHORIZATION,
+	EXPECT,
+	UPGRADE,
+	RETRY_AFTER,
+	CONTENT_RANGE,
+	ACCEPT,
+	ACCEPT_ENCODING,
+	ACCEPT_LANGUAGE,
+	COOKIE,
+	SET_COOKIE,
+	CACHE_CONTROL,
+	KEEP_ALIVE,
+	RANGE,
+	IF_MODIFIED_SINCE,
+	IF_NONE_MATCH,
+	TE,
+	VARY,
+	COUNT,
+	UNKNOWN = COUNT
+};
+
+// Case-insensitive, UNKNOWN when the name is not in the registry
+Id lookup(const char *name, size_t length);
+Id lookup(const std::string &name);
+
+// Lowercase name of a known id
+const char *name(Id id);
+
+// May appear only once in a request (RFC 9110 fields defined as a single value)
+bool isSingleton(Id id);
+} // namespace KnownHeaders
+
+#endif /* **************************************************** KNOWNHEADERS_H                                          \
+		*/
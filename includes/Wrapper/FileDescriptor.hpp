@@ -3,6 +3,7 @@
 
 #include "SocketAddress.hpp"
 #include <cstring>
+#include <csignal>
 #include <fcntl.h>
 #include <iostream>
 #include <string>
@@ -33,6 +34,7 @@ public:
 
 	// Methods
 	void closeDescriptor();
+	int release();
 
 	// Accessors
 	int getFd() const;
@@ -55,6 +57,11 @@ public:
 	bool unsetCloseOnExec();
 	bool setReuseAddr();
 	bool unsetReuseAddr();
+	bool setReusePort();
+	bool setIntOption(int level, int option, int value, const char *name);
+	bool setNoDelay();
+	bool setCork();
+	bool unsetCork();
 
 	// Comparator overloads
 	bool operator==(int rhs) const;
@@ -76,6 +83,7 @@ public:
 	ssize_t writeFile(const std::string &buffer);
 	ssize_t writeFile(const std::vector<char> &buffer, std::vector<char>::iterator start,
 					  std::vector<char>::iterator end);
+	ssize_t writeFile(const char *data, size_t len);
 	// Socket operations
 	ssize_t receiveData(void *buffer, size_t size);
 	ssize_t sendData(const std::string &buffer);
@@ -90,13 +98,16 @@ public:
 
 	// Static factory methods for all fd-creating functions
 	static FileDescriptor createSocket(int domain, int type, int protocol);
-	static FileDescriptor createFromAccept(int sockfd, SocketAddress &remoteAddress);
+	static FileDescriptor createFromAccept(int sockfd, SocketAddress &remoteAddress, int flags = 0);
 	static FileDescriptor createFromOpen(const char *pathname, int flags);
 	static FileDescriptor createFromOpen(const char *pathname, int flags, mode_t mode);
 	static FileDescriptor createFromDup(int oldfd);
 	static FileDescriptor createFromDup2(int oldfd, int newfd);
 	static FileDescriptor createFromOpendir(const char *name); // Returns fd from dirfd()
 	static FileDescriptor createEpoll(int flags);
+	static FileDescriptor createEventFd(unsigned int initval, int flags);
+	static FileDescriptor createSignalFd(const sigset_t &mask, int flags);
+	static FileDescriptor createFromRaw(int fd);
 };
 
 std::ostream &operator<<(std::ostream &o, FileDescriptor const &i);
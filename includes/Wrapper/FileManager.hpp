@@ -50,6 +50,7 @@ public:
 	// Methods
 	void append(const std::string &data);
 	void append(const std::vector<char> &buffer, std::vector<char>::iterator start, std::vector<char>::iterator end);
+	void append(const char *data, size_t len);
 	void reset();
 	void clear();
 };
@@ -4,6 +4,21 @@
 #include "FileDescriptor.hpp"
 #include "SocketAddress.hpp"
 #include <iostream>
+#include <sys/types.h>
+
+// Socket level tuning from the listen directive, 0 leaves the system default
+struct ListenOptions
+{
+	int backlog;	 // accept queue length, SOMAXCONN by default
+	int rcvbuf;		 // SO_RCVBUF, inherited by accepted sockets
+	int sndbuf;		 // SO_SNDBUF, inherited by accepted sockets
+	int deferAccept; // TCP_DEFER_ACCEPT seconds: accept only once the request's first bytes arrived
+	int fastOpen;	 // TCP_FASTOPEN queue length: requests may ride on the SYN
+	bool reusePort;	 // SO_REUSEPORT even outside worker mode
+	mode_t mode;	 // permissions of a unix socket file, 0666 by default
+
+	ListenOptions();
+};
 
 // Wrapper for listening socketss
 class ListeningSocket
@@ -11,6 +26,12 @@ class ListeningSocket
 private:
 	SocketAddress _socketAddress; // Socket address info
 	FileDescriptor _bindFd;		  // Fd when binded
+	ListenOptions _options;		  // applied by bind() and listen()
+	bool _reusePort;			  // SO_REUSEPORT requested before bind
+	bool _shared;				  // Accept queue polled by several worker processes
+	bool _listening;			  // listen() succeeded, false while the address is only reserved
+
+	void _removeStaleSocket() const;
 
 	// Non-copyable
 
@@ -24,6 +45,12 @@ public:
 	void accept(SocketAddress &address, FileDescriptor &clientFd) const;
 	void bind();
 	void listen();
+	void setReusePort(bool reusePort);
+	void setOptions(const ListenOptions &options);
+	const ListenOptions &getOptions() const;
+	void setShared(bool shared);
+	bool isShared() const;
+	bool isListening() const;
 
 	// Comparator overloads for mapping
 	bool operator<(const ListeningSocket &rhs) const;
@@ -0,0 +1,61 @@
+#ifndef MUTEX_HPP
+#define MUTEX_HPP
+
+#include <pthread.h>
+
+// Wrapper for a pthread mutex (non-recursive)
+class Mutex
+{
+private:
+	pthread_mutex_t _mutex;
+
+	friend class Condition;
+
+	// Non-copyable
+	Mutex(Mutex const &src);
+	Mutex &operator=(Mutex const &rhs);
+
+public:
+	Mutex();
+	~Mutex();
+
+	void lock();
+	void unlock();
+};
+
+// RAII guard, holds the mutex for the lifetime of the scope
+class ScopedLock
+{
+private:
+	Mutex &_mutex;
+
+	// Non-copyable
+	ScopedLock(ScopedLock const &src);
+	ScopedLock &operator=(ScopedLock const &rhs);
+
+public:
+	explicit ScopedLock(Mutex &mutex);
+	~ScopedLock();
+};
+
+// Wrapper for a pthread condition variable, always waited on with its Mutex held
+class Condition
+{
+private:
+	pthread_cond_t _cond;
+
+	// Non-copyable
+	Condition(Condition const &src);
+	Condition &operator=(Condition const &rhs);
+
+public:
+	Condition();
+	~Condition();
+
+	void wait(Mutex &mutex);
+	void signal();
+	void broadcast();
+};
+
+#endif /* ************************************************************ MUTEX_H                                          \
+		*/
@@ -1,59 +1,53 @@
-#ifndef RINGBUFFER_HPP
-#define RINGBUFFER_HPP
-
-#include "FileDescriptor.hpp"
-#include <cstddef>
-#include <cstring>
-#include <string>
-#include <unistd.h>
-#include <vector>
-
-// Ring buffer is a circular buffer that can be used to store data
-// More efficient than most other buffers
-class RingBuffer
-{
-private:
-	std::vector<char> _buffer;
-	size_t _head;
-	size_t _tail;
-	size_t _capacity;
-
-	size_t _advance(size_t pos, size_t n) const;
-
-public:
-	// Constructors
-	RingBuffer();
-	RingBuffer(size_t size);
-	RingBuffer(const RingBuffer &src);
-	~RingBuffer();
-
-	RingBuffer &operator=(const RingBuffer &rhs);
-
-	// Accessors
-	size_t readable() const;
-	size_t writable() const;
-	bool empty() const;
-	bool full() const;
-	size_t contains(const char *data, size_t len) const;
-	size_t capacity() const;
-
-	// Mutators
-	size_t writeBuffer(const char *data, size_t len);
-	size_t writeBuffer(const RingBuffer &src, size_t len);
-	size_t readBuffer(std::string &dest, size_t len);
-	size_t peekBuffer(std::string &dest, size_t len) const;
-	size_t transferFrom(RingBuffer &src, size_t len);
-	size_t transferTo(RingBuffer &dest, size_t len);
-	size_t appendBuffer(const RingBuffer &src);
-	size_t readBuffer(char *dest, size_t len);
-	size_t peekBuffer(char *dest, size_t len) const;
-	size_t flushToFile(const std::string &filePath);
-	size_t flushToFile(FileDescriptor &fd);
-	void reserve(size_t newCapacity);
-	void consume(size_t len);
-	void reset();
-	void clear();
-};
-
-#endif /* ****************************************************** RINGBUFFER_H                                          \
-		*/
+#ifndef RINGBUFFER_HPP
+#define RINGBUFFER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Receive buffer with a read cursor (_head) and a write cursor (_tail) over one allocation
+// Unread bytes never wrap: when the free space past _tail runs short they slide back to the front once instead,
+// so parsers can search and copy them in place. Consuming only advances _head.
+class RingBuffer
+{
+private:
+	std::vector<char> _buffer;
+	size_t _head;	  // first unread byte
+	size_t _tail;	  // first free byte
+	size_t _searched; // unread bytes known not to start a match of the last searched pattern
+
+public:
+	static const size_t npos = static_cast<size_t>(-1);
+
+	// Constructors
+	RingBuffer();
+	RingBuffer(size_t size);
+	RingBuffer(const RingBuffer &src);
+	~RingBuffer();
+
+	RingBuffer &operator=(const RingBuffer &rhs);
+
+	// Accessors
+	size_t readable() const;
+	size_t writable() const;
+	bool empty() const;
+	size_t capacity() const;
+	const char *data() const;
+	char *writePtr();
+	size_t search(const char *pattern, size_t len);
+
+	// Mutators
+	void prepare(size_t len);
+	void commit(size_t len);
+	size_t writeBuffer(const char *data, size_t len);
+	size_t readBuffer(std::string &dest, size_t len);
+	void consume(size_t len);
+	void reserve(size_t newCapacity);
+	void shrink(size_t maxCapacity);
+	void reset();
+	void clear();
+};
+
+#endif /* ****************************************************** RINGBUFFER_H                                          \
+		*/
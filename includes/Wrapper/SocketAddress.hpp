@@ -10,6 +10,7 @@
 #include <netinet/in.h>
 #include <string>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 // Class wrapper for socketAddress data
@@ -19,8 +20,8 @@ private:
 	struct sockaddr_storage _storage; // Universal storage for all address types
 	socklen_t _addrLen;				  // Actual length of stored address
 	int _family;					  // Family refers to the address family (AF_INET, AF_INET6, etc.)
-	std::string _host;				  // Original host string for compatibility
-	unsigned short _port;			  // Cached port for quick access
+	std::string _host;				  // Original host string for compatibility, the path of a unix socket
+	unsigned short _port;			  // Cached port for quick access, 0 for unix sockets
 
 	// Private helpers
 	void _updateCachedValues();
@@ -30,6 +31,7 @@ private:
 	struct sockaddr_in *_getSockAddrIn();
 	const struct sockaddr_in6 *_getSockAddrIn6() const;
 	struct sockaddr_in6 *_getSockAddrIn6();
+	void _setUnixPath(const std::string &path);
 
 public:
 	// Orthodox Canonical Class Form
@@ -69,6 +71,7 @@ public:
 	// Validators
 	bool isIPv4() const;
 	bool isIPv6() const;
+	bool isUnix() const;
 	bool isValid() const;
 	bool isEmpty() const;
 
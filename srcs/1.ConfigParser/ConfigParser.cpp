@@ -170,6 +170,12 @@ AST::ASTNode ConfigParser::parse()
 			parseServerBlock(cfg);
 			continue;
 		}
+		// Global directives (worker_processes, ...) live directly under the config node
+		if (t.type == Token::TOKEN_IDENTIFIER)
+		{
+			cfg.addChild(parseDirective());
+			continue;
+		}
 		std::ostringstream ss;
 		ss << "Top-level: unexpected token '" << t.lexeme << "' at " << t.line << ":" << t.column;
 		throw std::runtime_error(ss.str());
@@ -1,4 +1,5 @@
 #include "../../includes/ConfigParser/ConfigTokeniser.hpp"
+#include "../../includes/Global/CharScan.hpp"
 #include <iostream>
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
@@ -44,13 +45,12 @@ Token::Token ConfigTokeniser::consumeSingle(Token::TokenType type)
 
 bool ConfigTokeniser::isIdentChar(unsigned char ch)
 {
-	return std::isalnum(ch) || ch == '_' || ch == '-' || ch == '.' || ch == '/' || ch == '$' || ch == ':' ||
-		   ch == '[' || ch == ']';
+	return CharScan::is(ch, CharScan::CONFIG_WORD);
 }
 
 bool ConfigTokeniser::isDigit(unsigned char ch)
 {
-	return ch >= '0' && ch <= '9';
+	return CharScan::is(ch, CharScan::DIGIT);
 }
 
 // Lex a word (identifier or number)
@@ -158,16 +158,8 @@ Token::Token ConfigTokeniser::nextToken()
 		}
 
 		// If the current line contains only whitespace, skip it entirely
-		bool allws = true;
-		for (size_t i = 0; i < _currentLine.size(); ++i)
-		{
-			if (!std::isspace(static_cast<unsigned char>(_currentLine[i])))
-			{
-				allws = false;
-				break;
-			}
-		}
-		if (allws)
+		const char *line = _currentLine.data();
+		if (CharScan::skip(line, line + _currentLine.size(), CharScan::SPACE) == line + _currentLine.size())
 		{
 			_currentLine.clear();
 			_pos = 0;
@@ -178,7 +170,7 @@ Token::Token ConfigTokeniser::nextToken()
 		unsigned char uch = static_cast<unsigned char>(_currentLine[_pos]);
 
 		// whitespace within line: consume and continue
-		if (std::isspace(uch))
+		if (CharScan::is(uch, CharScan::SPACE))
 		{
 			++_pos;
 			continue;
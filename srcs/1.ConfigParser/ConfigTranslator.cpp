@@ -3,7 +3,10 @@
 #include "../../includes/Global/StrUtils.hpp"
 #include "../../includes/HTTP/HTTP.hpp"
 #include <cctype>
+#include <climits>
 #include <cstdlib>
+#include <sched.h>
+#include <unistd.h>
 #include <vector>
 
 namespace
@@ -39,6 +42,114 @@ bool parseSizeArgument(const std::string &rawValue, double &sizeOut)
 	return true;
 }
 
+// Parses a plain non-negative decimal integer (no suffixes)
+bool parseCountArgument(const std::string &rawValue, size_t &countOut)
+{
+	if (rawValue.empty())
+		return false;
+	for (size_t i = 0; i < rawValue.size(); ++i)
+	{
+		if (!std::isdigit(static_cast<unsigned char>(rawValue[i])))
+			return false;
+	}
+	char *end = NULL;
+	unsigned long parsed = std::strtoul(rawValue.c_str(), &end, 10);
+	if (end == rawValue.c_str() || *end != '\0')
+		return false;
+	countOut = static_cast<size_t>(parsed);
+	return true;
+}
+
+// Parses a duration: bare numbers are seconds, "ms", "s" and "m" suffixes are accepted
+bool parseTimeArgument(const std::string &rawValue, size_t &millisecondsOut)
+{
+	std::string numericPart = rawValue;
+	size_t multiplier = 1000;
+	if (rawValue.size() > 2 && rawValue.compare(rawValue.size() - 2, 2, "ms") == 0)
+	{
+		multiplier = 1;
+		numericPart = rawValue.substr(0, rawValue.size() - 2);
+	}
+	else if (!rawValue.empty() && (rawValue[rawValue.size() - 1] == 's' || rawValue[rawValue.size() - 1] == 'm'))
+	{
+		multiplier = rawValue[rawValue.size() - 1] == 'm' ? 60000 : 1000;
+		numericPart = rawValue.substr(0, rawValue.size() - 1);
+	}
+	size_t count = 0;
+	if (!parseCountArgument(numericPart, count))
+		return false;
+	millisecondsOut = count * multiplier;
+	return true;
+}
+
+// Matches "name=value" listen arguments, valueOut is what follows the '='
+bool matchListenOption(const std::string &argument, const std::string &name, std::string &valueOut)
+{
+	if (argument.size() <= name.size() || argument.compare(0, name.size(), name) != 0 || argument[name.size()] != '=')
+		return false;
+	valueOut = argument.substr(name.size() + 1);
+	return true;
+}
+
+// Listen option values end up in setsockopt() as a positive int, sizes take k/m/g suffixes
+bool parseListenValue(const std::string &rawValue, bool isSize, int &valueOut)
+{
+	double value = 0.0;
+	size_t count = 0;
+	if (isSize && !parseSizeArgument(rawValue, value))
+		return false;
+	if (!isSize)
+	{
+		if (!parseCountArgument(rawValue, count))
+			return false;
+		value = static_cast<double>(count);
+	}
+	if (value < 1.0 || value > static_cast<double>(INT_MAX))
+		return false;
+	valueOut = static_cast<int>(value);
+	return true;
+}
+
+// Unix socket permissions are octal as in chmod, "0660" or "660"
+bool parseModeArgument(const std::string &rawValue, mode_t &modeOut)
+{
+	if (rawValue.empty() || rawValue.size() > 4 || rawValue.find_first_not_of("01234567") != std::string::npos)
+		return false;
+	unsigned long parsed = std::strtoul(rawValue.c_str(), NULL, 8);
+	if (parsed > 0777)
+		return false;
+	modeOut = static_cast<mode_t>(parsed);
+	return true;
+}
+
+// limit_rate SIZE and limit_rate_after SIZE take one size argument, 0 is allowed (no limit, no initial burst)
+bool parseLimitRateDirective(const AST::ASTNode &directive, size_t &valueOut)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	double size = 0.0;
+	if (it == directive.children.end())
+		Logger::warning("No arguments in " + directive.value + " directive line: " +
+							StrUtils::toString<int>(directive.line) +
+							" column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else if ((*it)->type != AST::ARG || !parseSizeArgument((*it)->value, size))
+		Logger::warning("Invalid " + directive.value + " value: " + (*it)->value + " line: " +
+							StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else
+	{
+		while (++it != directive.children.end())
+			Logger::warning("Extra argument in " + directive.value + " directive: " + (*it)->value +
+								" line: " + StrUtils::toString<int>((*it)->line) +
+								" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		valueOut = static_cast<size_t>(size);
+		return true;
+	}
+	return false;
+}
+
 } // namespace
 
 /*
@@ -67,6 +178,11 @@ const std::vector<Server> &ConfigTranslator::getServers() const
 	return _servers;
 }
 
+const GlobalConfig &ConfigTranslator::getGlobalConfig() const
+{
+	return _globalConfig;
+}
+
 // Iterate through the AST and translate the server blocks
 void ConfigTranslator::_translate(const AST::ASTNode &ast)
 {
@@ -90,9 +206,38 @@ void ConfigTranslator::_translate(const AST::ASTNode &ast)
 			else
 				_servers.push_back(server);
 		}
+		else if ((*it)->type == AST::DIRECTIVE)
+			_translateGlobal(**it);
 	}
 }
 
+// Directives declared outside of any server block apply to the whole process
+void ConfigTranslator::_translateGlobal(const AST::ASTNode &directive)
+{
+	if (directive.value == "worker_processes")
+		_translateWorkerProcesses(directive, _globalConfig);
+	else if (directive.value == "worker_cpu_affinity")
+		_translateWorkerCpuAffinity(directive, _globalConfig);
+	else if (directive.value == "worker_threads")
+		_translateWorkerThreads(directive, _globalConfig);
+	else if (directive.value == "client_header_timeout" || directive.value == "client_body_timeout" ||
+			 directive.value == "send_timeout" || directive.value == "keepalive_timeout" ||
+			 directive.value == "reload_drain_timeout")
+		_translateTimeout(directive, _globalConfig);
+	else if (directive.value == "accept_batch" || directive.value == "worker_connections" ||
+			 directive.value == "request_budget" || directive.value == "io_threads")
+		_translateCount(directive, _globalConfig);
+	else if (directive.value == "event_backend")
+		_translateEventBackend(directive, _globalConfig);
+	else if (directive.value == "send_budget" || directive.value == "recv_budget")
+		_translateByteBudget(directive, _globalConfig);
+	else
+		Logger::warning("Unknown global directive: " + directive.value +
+							" line: " + StrUtils::toString<int>(directive.line) +
+							" column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
 Server ConfigTranslator::_translateServer(const AST::ASTNode &ast)
 {
 	Server server;
@@ -111,6 +256,10 @@ Server ConfigTranslator::_translateServer(const AST::ASTNode &ast)
 				_translateServerIndex(**it, server);
 			else if ((*it)->value == "autoindex")
 				_translateServerAutoindex(**it, server);
+			else if ((*it)->value == "tcp_nodelay" || (*it)->value == "tcp_nopush")
+				_translateServerTcpOption(**it, server);
+			else if ((*it)->value == "limit_rate" || (*it)->value == "limit_rate_after")
+				_translateServerLimitRate(**it, server);
 			else if ((*it)->value == "client_max_body_size")
 				_translateServerClientMaxBodySize(**it, server);
 			else if ((*it)->value == "error_pages")
@@ -144,6 +293,224 @@ Server ConfigTranslator::_translateServer(const AST::ASTNode &ast)
 	return server;
 }
 
+/*
+** --------------------------------- GLOBAL SPECIFIC HELPERS ---------------------------------
+*/
+
+// worker_processes N|auto
+void ConfigTranslator::_translateWorkerProcesses(const AST::ASTNode &directive, GlobalConfig &globalConfig)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	if (it == directive.children.end())
+		return Logger::warning("No arguments in worker_processes directive line: " +
+								   StrUtils::toString<int>(directive.line) +
+								   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	if ((*it)->value == "auto")
+	{
+		long onlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+		globalConfig.setWorkerProcesses(onlineCpus > 0 ? static_cast<size_t>(onlineCpus) : 1);
+	}
+	else
+	{
+		size_t count = 0;
+		if (!parseCountArgument((*it)->value, count) || count == 0)
+			Logger::warning("Invalid worker_processes value: " + (*it)->value +
+								" line: " + StrUtils::toString<int>((*it)->line) +
+								" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		else
+			globalConfig.setWorkerProcesses(count);
+	}
+	while (++it != directive.children.end())
+		Logger::warning("Extra argument in worker_processes directive: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// worker_threads N|auto (reactor threads fed by one acceptor, per process)
+void ConfigTranslator::_translateWorkerThreads(const AST::ASTNode &directive, GlobalConfig &globalConfig)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	if (it == directive.children.end())
+		return Logger::warning("No arguments in worker_threads directive line: " +
+								   StrUtils::toString<int>(directive.line) +
+								   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	if ((*it)->value == "auto")
+	{
+		long onlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+		globalConfig.setWorkerThreads(onlineCpus > 0 ? static_cast<size_t>(onlineCpus) : 1);
+	}
+	else
+	{
+		size_t count = 0;
+		if (!parseCountArgument((*it)->value, count) || count == 0)
+			Logger::warning("Invalid worker_threads value: " + (*it)->value +
+								" line: " + StrUtils::toString<int>((*it)->line) +
+								" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		else
+			globalConfig.setWorkerThreads(count);
+	}
+	while (++it != directive.children.end())
+		Logger::warning("Extra argument in worker_threads directive: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// client_header_timeout | client_body_timeout | send_timeout | keepalive_timeout | reload_drain_timeout <time>
+// (see parseTimeArgument)
+void ConfigTranslator::_translateTimeout(const AST::ASTNode &directive, GlobalConfig &globalConfig)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	if (it == directive.children.end())
+		return Logger::warning("No arguments in " + directive.value +
+								   " directive line: " + StrUtils::toString<int>(directive.line) +
+								   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	size_t timeoutMs = 0;
+	if (!parseTimeArgument((*it)->value, timeoutMs) || timeoutMs == 0)
+		Logger::warning("Invalid " + directive.value + " value: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else if (directive.value == "client_header_timeout")
+		globalConfig.setClientHeaderTimeout(timeoutMs);
+	else if (directive.value == "client_body_timeout")
+		globalConfig.setClientBodyTimeout(timeoutMs);
+	else if (directive.value == "send_timeout")
+		globalConfig.setSendTimeout(timeoutMs);
+	else if (directive.value == "keepalive_timeout")
+		globalConfig.setKeepaliveTimeout(timeoutMs);
+	else
+		globalConfig.setReloadDrainTimeout(timeoutMs);
+	while (++it != directive.children.end())
+		Logger::warning("Extra argument in " + directive.value + " directive: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// accept_batch N (connections accepted per listener wakeup, the rest wait for the next loop turn)
+// worker_connections N (open client connections per process, past it new connections get a 503)
+// request_budget N (pipelined requests parsed for one connection per loop turn)
+// io_threads N (threads running blocking file operations, 0 keeps them on the event loop)
+void ConfigTranslator::_translateCount(const AST::ASTNode &directive, GlobalConfig &globalConfig)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	if (it == directive.children.end())
+		return Logger::warning("No arguments in " + directive.value + " directive line: " +
+								   StrUtils::toString<int>(directive.line) +
+								   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	size_t count = 0;
+	if (!parseCountArgument((*it)->value, count) || (count == 0 && directive.value != "io_threads"))
+		Logger::warning("Invalid " + directive.value + " value: " + (*it)->value + " line: " +
+							StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else if (directive.value == "accept_batch")
+		globalConfig.setAcceptBatch(count);
+	else if (directive.value == "request_budget")
+		globalConfig.setRequestBudget(count);
+	else if (directive.value == "io_threads")
+		globalConfig.setIoThreads(count);
+	else
+		globalConfig.setWorkerConnections(count);
+	while (++it != directive.children.end())
+		Logger::warning("Extra argument in " + directive.value + " directive: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// send_budget SIZE / recv_budget SIZE (bytes written to / read from one connection per loop turn before the others
+// get theirs, k/m/g suffixes)
+void ConfigTranslator::_translateByteBudget(const AST::ASTNode &directive, GlobalConfig &globalConfig)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	if (it == directive.children.end())
+		return Logger::warning("No arguments in " + directive.value + " directive line: " +
+								   StrUtils::toString<int>(directive.line) +
+								   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	double size = 0.0;
+	if (!parseSizeArgument((*it)->value, size) || size < 1.0)
+		Logger::warning("Invalid " + directive.value + " value: " + (*it)->value + " line: " +
+							StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else if (directive.value == "recv_budget")
+		globalConfig.setRecvBudget(static_cast<size_t>(size));
+	else
+		globalConfig.setSendBudget(static_cast<size_t>(size));
+	while (++it != directive.children.end())
+		Logger::warning("Extra argument in " + directive.value + " directive: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// event_backend epoll | io_uring (io_uring falls back to epoll when the kernel cannot provide it)
+void ConfigTranslator::_translateEventBackend(const AST::ASTNode &directive, GlobalConfig &globalConfig)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	if (it == directive.children.end())
+		return Logger::warning("No arguments in event_backend directive line: " +
+								   StrUtils::toString<int>(directive.line) +
+								   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	EventBackend::Type type = EventBackend::EPOLL;
+	if (!EventBackend::parseType((*it)->value, type))
+		Logger::warning("Invalid event_backend value: " + (*it)->value + " line: " +
+							StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else
+		globalConfig.setEventBackend(type);
+	while (++it != directive.children.end())
+		Logger::warning("Extra argument in event_backend directive: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// worker_cpu_affinity auto | <mask> [<mask> ...] where each mask is a binary cpu set (e.g. 0001 0010)
+void ConfigTranslator::_translateWorkerCpuAffinity(const AST::ASTNode &directive, GlobalConfig &globalConfig)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	if (it == directive.children.end())
+		return Logger::warning("No arguments in worker_cpu_affinity directive line: " +
+								   StrUtils::toString<int>(directive.line) +
+								   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	if ((*it)->value == "auto")
+	{
+		globalConfig.setCpuAffinityAuto(true);
+		while (++it != directive.children.end())
+			Logger::warning("Extra argument in worker_cpu_affinity directive: " + (*it)->value +
+								" line: " + StrUtils::toString<int>((*it)->line) +
+								" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		return;
+	}
+	for (; it != directive.children.end(); ++it)
+	{
+		const std::string &mask = (*it)->value;
+		if (mask.empty() || mask.size() > CPU_SETSIZE || mask.find_first_not_of("01") != std::string::npos ||
+			mask.find('1') == std::string::npos)
+			Logger::warning("Invalid worker_cpu_affinity mask: " + mask +
+								" line: " + StrUtils::toString<int>((*it)->line) +
+								" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		else
+			globalConfig.insertCpuAffinityMask(mask);
+	}
+}
+
 /*
 ** --------------------------------- SERVER SPECIFIC HELPERS ---------------------------------
 */
@@ -199,6 +566,7 @@ void ConfigTranslator::_translateServerName(const AST::ASTNode &directive, Serve
 }
 
 // Translate listen directives into server members
+// listen [host:]port [max_connections=N]
 void ConfigTranslator::_translateListen(const AST::ASTNode &directive, Server &server)
 {
 	try
@@ -209,21 +577,53 @@ void ConfigTranslator::_translateListen(const AST::ASTNode &directive, Server &s
 									   " line: " + StrUtils::toString<int>(directive.line) +
 									   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
 								   __FILE__, __LINE__, __PRETTY_FUNCTION__);
-		else if ((*it)->type == AST::ARG)
+		if ((*it)->type != AST::ARG)
+			return Logger::warning("Unknown token in listen directive: " + (*it)->value +
+									   " line: " + StrUtils::toString<int>((*it)->line) +
+									   " column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+								   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		SocketAddress socket((*it)->value);
+		server.insertSocketAddress(socket);
+		ListenOptions options;
+		bool tuned = false;
+		while (++it != directive.children.end())
 		{
-			SocketAddress socket((*it)->value);
-			server.insertSocketAddress(socket);
+			const std::string &argument = (*it)->value;
+			std::string value;
+			size_t limit = 0;
+			bool valid = true;
+			if (matchListenOption(argument, "max_connections", value))
+			{
+				valid = parseCountArgument(value, limit) && limit != 0;
+				if (valid)
+					server.setConnectionLimit(socket, limit);
+			}
+			else if (matchListenOption(argument, "backlog", value))
+				valid = parseListenValue(value, false, options.backlog);
+			else if (matchListenOption(argument, "rcvbuf", value))
+				valid = parseListenValue(value, true, options.rcvbuf);
+			else if (matchListenOption(argument, "sndbuf", value))
+				valid = parseListenValue(value, true, options.sndbuf);
+			else if (matchListenOption(argument, "fastopen", value))
+				valid = parseListenValue(value, false, options.fastOpen);
+			else if (matchListenOption(argument, "mode", value))
+				valid = socket.isUnix() && parseModeArgument(value, options.mode);
+			else if (argument == "deferred")
+				options.deferAccept = HTTP::LISTEN_DEFER_ACCEPT_SECONDS;
+			else if (argument == "reuseport")
+				options.reusePort = true;
+			else
+				valid = false;
+			if (!valid)
+				Logger::warning("Invalid listen argument: " + argument + " line: " +
+									StrUtils::toString<int>((*it)->line) +
+									" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+								__FILE__, __LINE__, __PRETTY_FUNCTION__);
+			else if (limit == 0) // anything but max_connections is a socket option
+				tuned = true;
 		}
-		else
-			Logger::warning("Unknown token in listen directive: " + (*it)->value +
-								" line: " + StrUtils::toString<int>((*it)->line) +
-								" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
-							__FILE__, __LINE__, __PRETTY_FUNCTION__);
-		while (++it != directive.children.end())
-			Logger::warning("Extra argument in listen directive: " + (*it)->value +
-								" line: " + StrUtils::toString<int>((*it)->line) +
-								" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
-							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		if (tuned)
+			server.setListenOptions(socket, options);
 	}
 	catch (const std::exception &e)
 	{
@@ -370,6 +770,43 @@ void ConfigTranslator::_translateServerAutoindex(const AST::ASTNode &directive,
 	}
 }
 
+// limit_rate SIZE (bytes per second, k/m/g suffixes), limit_rate_after SIZE (sent at full speed first)
+void ConfigTranslator::_translateServerLimitRate(const AST::ASTNode &directive, Server &server)
+{
+	size_t value = 0;
+	if (!parseLimitRateDirective(directive, value))
+		return;
+	if (directive.value == "limit_rate")
+		server.setLimitRate(value);
+	else
+		server.setLimitRateAfter(value);
+}
+
+// tcp_nodelay on|off, tcp_nopush on|off
+void ConfigTranslator::_translateServerTcpOption(const AST::ASTNode &directive, Server &server)
+{
+	std::vector<AST::ASTNode *>::const_iterator it = directive.children.begin();
+	if (it == directive.children.end())
+		return Logger::warning("No arguments in " + directive.value +
+								   " directive line: " + StrUtils::toString<int>(directive.line) +
+								   " column: " + StrUtils::toString<int>(directive.column) + " skipping...",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	if ((*it)->value != "on" && (*it)->value != "off")
+		Logger::warning("Invalid " + directive.value + " value: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else if (directive.value == "tcp_nodelay")
+		server.setTcpNoDelay((*it)->value == "on");
+	else
+		server.setTcpNoPush((*it)->value == "on");
+	while (++it != directive.children.end())
+		Logger::warning("Extra argument in " + directive.value + " directive: " + (*it)->value +
+							" line: " + StrUtils::toString<int>((*it)->line) +
+							" column: " + StrUtils::toString<int>((*it)->column) + " skipping...",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
 // Translate client max body size directives into server members
 void ConfigTranslator::_translateServerClientMaxBodySize(const AST::ASTNode &directive, Server &server)
 {
@@ -547,6 +984,8 @@ void ConfigTranslator::_translateLocation(const AST::ASTNode &location_node, Loc
 					_translateLocationCgiParam(**it, location);
 				else if ((*it)->value == "client_max_body_size")
 					_translateLocationClientMaxBodySize(**it, location);
+				else if ((*it)->value == "limit_rate" || (*it)->value == "limit_rate_after")
+					_translateLocationLimitRate(**it, location);
 				else
 					Logger::warning("Unknown directive in location block: " + (*it)->value +
 										" line: " + StrUtils::toString<int>((*it)->line) +
@@ -569,6 +1008,18 @@ void ConfigTranslator::_translateLocation(const AST::ASTNode &location_node, Loc
 	}
 }
 
+// Same as the server directives, a location's value replaces the server's
+void ConfigTranslator::_translateLocationLimitRate(const AST::ASTNode &directive, Location &location)
+{
+	size_t value = 0;
+	if (!parseLimitRateDirective(directive, value))
+		return;
+	if (directive.value == "limit_rate")
+		location.setLimitRate(value);
+	else
+		location.setLimitRateAfter(value);
+}
+
 void ConfigTranslator::_translateLocationClientMaxBodySize(const AST::ASTNode &directive, Location &location)
 {
 	try
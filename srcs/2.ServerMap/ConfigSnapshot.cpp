@@ -0,0 +1,107 @@
+#include "../../includes/Core/ConfigSnapshot.hpp"
+#include "../../includes/HTTP/HTTP.hpp"
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+ConfigSnapshot::ConfigSnapshot(const ServerMap &serverMap, const GlobalConfig &globalConfig, size_t generation)
+	: _globalConfig(globalConfig), _generation(generation), _refCount(1)
+{
+	const std::map<ListeningSocket, std::vector<Server> > &listeners = serverMap.getServerMap();
+	_listeners.resize(listeners.size());
+	size_t index = 0;
+	for (std::map<ListeningSocket, std::vector<Server> >::const_iterator it = listeners.begin(); it != listeners.end();
+		 ++it, ++index)
+	{
+		_listeners[index].address = it->first.getAddress();
+		_listeners[index].servers = it->second;
+		// Socket options are set at accept, before the Host header picks a server. TCP ones mean nothing to a unix
+		// socket, which never batches small writes anyway.
+		if (it->first.getAddress().isUnix())
+		{
+			_listeners[index].tcpNoDelay = false;
+			_listeners[index].tcpNoPush = false;
+		}
+		else if (!it->second.empty())
+		{
+			_listeners[index].tcpNoDelay = it->second.front().isTcpNoDelay();
+			_listeners[index].tcpNoPush = it->second.front().isTcpNoPush();
+		}
+		for (std::vector<Server>::const_iterator server = it->second.begin(); server != it->second.end(); ++server)
+		{
+			size_t limit = server->getConnectionLimit(it->first.getAddress());
+			if (limit != 0 && (_listeners[index].connectionLimit == 0 || limit < _listeners[index].connectionLimit))
+				_listeners[index].connectionLimit = limit;
+		}
+	}
+}
+
+ConfigSnapshot::Listener::Listener()
+	: connectionLimit(0), tcpNoDelay(HTTP::DEFAULT_TCP_NODELAY), tcpNoPush(HTTP::DEFAULT_TCP_NOPUSH), connections(0)
+{
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+ConfigSnapshot::~ConfigSnapshot()
+{
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+void ConfigSnapshot::retain()
+{
+	__sync_add_and_fetch(&_refCount, 1);
+}
+
+void ConfigSnapshot::release()
+{
+	if (__sync_sub_and_fetch(&_refCount, 1) == 0)
+		delete this;
+}
+
+bool ConfigSnapshot::Listener::admit() const
+{
+	size_t count = __sync_add_and_fetch(&connections, 1);
+	if (connectionLimit == 0 || count <= connectionLimit)
+		return true;
+	__sync_sub_and_fetch(&connections, 1);
+	return false;
+}
+
+void ConfigSnapshot::Listener::join() const
+{
+	__sync_add_and_fetch(&connections, 1);
+}
+
+void ConfigSnapshot::Listener::leave() const
+{
+	__sync_sub_and_fetch(&connections, 1);
+}
+
+const ConfigSnapshot::Listener *ConfigSnapshot::findListener(const SocketAddress &address) const
+{
+	for (std::vector<Listener>::const_iterator it = _listeners.begin(); it != _listeners.end(); ++it)
+	{
+		if (it->address == address)
+			return &*it;
+	}
+	return NULL;
+}
+
+const GlobalConfig &ConfigSnapshot::getGlobalConfig() const
+{
+	return _globalConfig;
+}
+
+size_t ConfigSnapshot::getGeneration() const
+{
+	return _generation;
+}
+
+/* ************************************************************************** */
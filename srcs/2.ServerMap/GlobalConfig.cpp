@@ -0,0 +1,301 @@
+#include "../../includes/Core/GlobalConfig.hpp"
+#include "../../includes/HTTP/HTTP.hpp"
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+GlobalConfig::GlobalConfig()
+{
+	_workerProcesses = HTTP::DEFAULT_WORKER_PROCESSES;
+	_workerThreads = HTTP::DEFAULT_WORKER_THREADS;
+	_ioThreads = HTTP::DEFAULT_IO_THREADS;
+	_cpuAffinityAuto = false;
+	_cpuAffinityMasks = std::vector<std::string>();
+	_clientHeaderTimeout = HTTP::DEFAULT_CLIENT_HEADER_TIMEOUT_MS;
+	_clientBodyTimeout = HTTP::DEFAULT_CLIENT_BODY_TIMEOUT_MS;
+	_sendTimeout = HTTP::DEFAULT_SEND_TIMEOUT_MS;
+	_keepaliveTimeout = HTTP::DEFAULT_KEEPALIVE_TIMEOUT_MS;
+	_reloadDrainTimeout = HTTP::DEFAULT_RELOAD_DRAIN_TIMEOUT_MS;
+	_acceptBatch = HTTP::DEFAULT_ACCEPT_BATCH;
+	_workerConnections = HTTP::DEFAULT_WORKER_CONNECTIONS;
+	_sendBudget = HTTP::DEFAULT_SEND_BUDGET;
+	_recvBudget = HTTP::DEFAULT_RECV_BUDGET;
+	_requestBudget = HTTP::DEFAULT_REQUEST_BUDGET;
+	_eventBackend = EventBackend::EPOLL;
+
+	// Flags
+	_modified = false;
+}
+
+GlobalConfig::GlobalConfig(const GlobalConfig &src)
+{
+	*this = src;
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+GlobalConfig::~GlobalConfig()
+{
+}
+
+/*
+** --------------------------------- OVERLOAD ---------------------------------
+*/
+
+GlobalConfig &GlobalConfig::operator=(GlobalConfig const &rhs)
+{
+	if (this != &rhs)
+	{
+		_workerProcesses = rhs._workerProcesses;
+		_workerThreads = rhs._workerThreads;
+		_ioThreads = rhs._ioThreads;
+		_cpuAffinityAuto = rhs._cpuAffinityAuto;
+		_cpuAffinityMasks = rhs._cpuAffinityMasks;
+		_clientHeaderTimeout = rhs._clientHeaderTimeout;
+		_clientBodyTimeout = rhs._clientBodyTimeout;
+		_sendTimeout = rhs._sendTimeout;
+		_keepaliveTimeout = rhs._keepaliveTimeout;
+		_reloadDrainTimeout = rhs._reloadDrainTimeout;
+		_acceptBatch = rhs._acceptBatch;
+		_workerConnections = rhs._workerConnections;
+		_sendBudget = rhs._sendBudget;
+		_recvBudget = rhs._recvBudget;
+		_requestBudget = rhs._requestBudget;
+		_eventBackend = rhs._eventBackend;
+		_modified = rhs._modified;
+	}
+	return *this;
+}
+
+std::ostream &operator<<(std::ostream &o, GlobalConfig const &i)
+{
+	o << "--------------------------------" << std::endl;
+	o << "Worker processes: " << i.getWorkerProcesses() << std::endl;
+	o << "Worker threads: " << i.getWorkerThreads() << std::endl;
+	o << "I/O threads: " << i.getIoThreads() << std::endl;
+	o << "Worker cpu affinity: ";
+	if (i.isCpuAffinityAuto())
+		o << "auto";
+	for (std::vector<std::string>::const_iterator it = i.getCpuAffinityMasks().begin();
+		 it != i.getCpuAffinityMasks().end(); ++it)
+		o << *it << " ";
+	o << std::endl;
+	o << "Timeouts (ms): header " << i.getClientHeaderTimeout() << ", body " << i.getClientBodyTimeout() << ", send "
+	  << i.getSendTimeout() << ", keepalive " << i.getKeepaliveTimeout()
+	  << ", reload drain " << i.getReloadDrainTimeout() << std::endl;
+	o << "Accept batch: " << i.getAcceptBatch() << std::endl;
+	o << "Worker connections: ";
+	if (i.getWorkerConnections() == 0)
+		o << "auto";
+	else
+		o << i.getWorkerConnections();
+	o << std::endl;
+	o << "Per turn budgets: send " << i.getSendBudget() << " bytes, recv " << i.getRecvBudget() << " bytes, "
+	  << i.getRequestBudget() << " requests" << std::endl;
+	o << "Event backend: " << (i.getEventBackend() == EventBackend::IO_URING ? "io_uring" : "epoll") << std::endl;
+	o << "--------------------------------" << std::endl;
+	return o;
+}
+
+/*
+** --------------------------------- INVESTIGATORS ---------------------------------
+*/
+
+bool GlobalConfig::isModified() const
+{
+	return _modified;
+}
+
+bool GlobalConfig::isCpuAffinityAuto() const
+{
+	return _cpuAffinityAuto;
+}
+
+bool GlobalConfig::hasCpuAffinity() const
+{
+	return _cpuAffinityAuto || !_cpuAffinityMasks.empty();
+}
+
+/*
+** --------------------------------- GETTERS -----------------------------------
+*/
+
+size_t GlobalConfig::getWorkerProcesses() const
+{
+	return _workerProcesses;
+}
+
+size_t GlobalConfig::getWorkerThreads() const
+{
+	return _workerThreads;
+}
+
+size_t GlobalConfig::getIoThreads() const
+{
+	return _ioThreads;
+}
+
+const std::vector<std::string> &GlobalConfig::getCpuAffinityMasks() const
+{
+	return _cpuAffinityMasks;
+}
+
+size_t GlobalConfig::getClientHeaderTimeout() const
+{
+	return _clientHeaderTimeout;
+}
+
+size_t GlobalConfig::getClientBodyTimeout() const
+{
+	return _clientBodyTimeout;
+}
+
+size_t GlobalConfig::getSendTimeout() const
+{
+	return _sendTimeout;
+}
+
+size_t GlobalConfig::getKeepaliveTimeout() const
+{
+	return _keepaliveTimeout;
+}
+
+size_t GlobalConfig::getReloadDrainTimeout() const
+{
+	return _reloadDrainTimeout;
+}
+
+size_t GlobalConfig::getAcceptBatch() const
+{
+	return _acceptBatch;
+}
+
+size_t GlobalConfig::getWorkerConnections() const
+{
+	return _workerConnections;
+}
+
+size_t GlobalConfig::getSendBudget() const
+{
+	return _sendBudget;
+}
+
+size_t GlobalConfig::getRecvBudget() const
+{
+	return _recvBudget;
+}
+
+size_t GlobalConfig::getRequestBudget() const
+{
+	return _requestBudget;
+}
+
+EventBackend::Type GlobalConfig::getEventBackend() const
+{
+	return _eventBackend;
+}
+
+/*
+** --------------------------------- SETTERS ----------------------------------
+*/
+
+void GlobalConfig::setWorkerProcesses(size_t workerProcesses)
+{
+	_workerProcesses = workerProcesses;
+	_modified = true;
+}
+
+void GlobalConfig::setWorkerThreads(size_t workerThreads)
+{
+	_workerThreads = workerThreads;
+	_modified = true;
+}
+
+void GlobalConfig::setIoThreads(size_t ioThreads)
+{
+	_ioThreads = ioThreads;
+	_modified = true;
+}
+
+void GlobalConfig::setCpuAffinityAuto(bool cpuAffinityAuto)
+{
+	_cpuAffinityAuto = cpuAffinityAuto;
+	_modified = true;
+}
+
+void GlobalConfig::insertCpuAffinityMask(const std::string &mask)
+{
+	_cpuAffinityMasks.push_back(mask);
+	_modified = true;
+}
+
+void GlobalConfig::setClientHeaderTimeout(size_t timeoutMs)
+{
+	_clientHeaderTimeout = timeoutMs;
+	_modified = true;
+}
+
+void GlobalConfig::setClientBodyTimeout(size_t timeoutMs)
+{
+	_clientBodyTimeout = timeoutMs;
+	_modified = true;
+}
+
+void GlobalConfig::setSendTimeout(size_t timeoutMs)
+{
+	_sendTimeout = timeoutMs;
+	_modified = true;
+}
+
+void GlobalConfig::setKeepaliveTimeout(size_t timeoutMs)
+{
+	_keepaliveTimeout = timeoutMs;
+	_modified = true;
+}
+
+void GlobalConfig::setReloadDrainTimeout(size_t timeoutMs)
+{
+	_reloadDrainTimeout = timeoutMs;
+	_modified = true;
+}
+
+void GlobalConfig::setAcceptBatch(size_t acceptBatch)
+{
+	_acceptBatch = acceptBatch;
+	_modified = true;
+}
+
+void GlobalConfig::setWorkerConnections(size_t workerConnections)
+{
+	_workerConnections = workerConnections;
+	_modified = true;
+}
+
+void GlobalConfig::setSendBudget(size_t sendBudget)
+{
+	_sendBudget = sendBudget;
+	_modified = true;
+}
+
+void GlobalConfig::setRecvBudget(size_t recvBudget)
+{
+	_recvBudget = recvBudget;
+	_modified = true;
+}
+
+void GlobalConfig::setRequestBudget(size_t requestBudget)
+{
+	_requestBudget = requestBudget;
+	_modified = true;
+}
+
+void GlobalConfig::setEventBackend(EventBackend::Type eventBackend)
+{
+	_eventBackend = eventBackend;
+	_modified = true;
+}
+
+/* ************************************************************************** */
@@ -15,9 +15,13 @@ Location::Location(const std::string &path)
 	_statusPages = std::map<int, std::string>();
 	_redirect = std::pair<int, std::string>();
 	_indexes = TrieTree<std::string>();
-	_autoIndex = false;
+	_autoIndexValue = false;
 	_cgiPath = std::string();
 	_clientMaxBodySize = -1.0;
+	_hasLimitRate = false;
+	_limitRate = 0;
+	_hasLimitRateAfter = false;
+	_limitRateAfter = 0;
 	_cgiParams = std::map<std::string, std::string>();
 	_hasAutoIndex = false;
 
@@ -55,6 +59,10 @@ Location &Location::operator=(Location const &rhs)
 		_indexes = rhs._indexes;
 		_cgiPath = rhs._cgiPath;
 		_clientMaxBodySize = rhs._clientMaxBodySize;
+		_hasLimitRate = rhs._hasLimitRate;
+		_limitRate = rhs._limitRate;
+		_hasLimitRateAfter = rhs._hasLimitRateAfter;
+		_limitRateAfter = rhs._limitRateAfter;
 		_cgiParams = rhs._cgiParams;
 		_modified = rhs._modified;
 	}
@@ -135,6 +143,16 @@ bool Location::hasClientMaxBodySize() const
 	return _clientMaxBodySize >= 0.0;
 }
 
+bool Location::hasLimitRate() const
+{
+	return _hasLimitRate;
+}
+
+bool Location::hasLimitRateAfter() const
+{
+	return _hasLimitRateAfter;
+}
+
 bool Location::hasCgiParams() const
 {
 	return !_cgiParams.empty();
@@ -194,6 +212,16 @@ double Location::getClientMaxBodySize() const
 	return _clientMaxBodySize;
 }
 
+size_t Location::getLimitRate() const
+{
+	return _limitRate;
+}
+
+size_t Location::getLimitRateAfter() const
+{
+	return _limitRateAfter;
+}
+
 const std::map<std::string, std::string> &Location::getCgiParams() const
 {
 	return _cgiParams;
@@ -260,6 +288,20 @@ void Location::setClientMaxBodySize(double size)
 	_modified = true;
 }
 
+void Location::setLimitRate(size_t limitRate)
+{
+	_limitRate = limitRate;
+	_hasLimitRate = true;
+	_modified = true;
+}
+
+void Location::setLimitRateAfter(size_t limitRateAfter)
+{
+	_limitRateAfter = limitRateAfter;
+	_hasLimitRateAfter = true;
+	_modified = true;
+}
+
 void Location::setCgiParam(const std::string &key, const std::string &value)
 {
 	_cgiParams[key] = value;
@@ -9,6 +9,8 @@ Server::Server()
 {
 	_serverNames = TrieTree<std::string>();
 	_sockets = std::vector<SocketAddress>();
+	_connectionLimits = std::vector<std::pair<SocketAddress, size_t> >();
+	_listenOptions = std::vector<std::pair<SocketAddress, ListenOptions> >();
 	_rootPath = std::string();
 	_indexes = TrieTree<std::string>();
 	_autoIndexValue = HTTP::DEFAULT_AUTOINDEX;
@@ -17,6 +19,10 @@ Server::Server()
 	_statusPages = std::map<int, std::string>();
 	_locations = TrieTree<Location>();
 	_keepAlive = HTTP::DEFAULT_KEEP_ALIVE;
+	_tcpNoDelay = HTTP::DEFAULT_TCP_NODELAY;
+	_tcpNoPush = HTTP::DEFAULT_TCP_NOPUSH;
+	_limitRate = 0;
+	_limitRateAfter = 0;
 
 	// Flags
 	_modified = false;
@@ -46,6 +52,8 @@ Server &Server::operator=(Server const &rhs)
 	{
 		_serverNames = rhs._serverNames;
 		_sockets = rhs._sockets;
+		_connectionLimits = rhs._connectionLimits;
+		_listenOptions = rhs._listenOptions;
 		_rootPath = rhs._rootPath;
 		_indexes = rhs._indexes;
 		_hasAutoIndex = rhs._hasAutoIndex;
@@ -54,6 +62,10 @@ Server &Server::operator=(Server const &rhs)
 		_statusPages = rhs._statusPages;
 		_locations = rhs._locations;
 		_keepAlive = rhs._keepAlive;
+		_tcpNoDelay = rhs._tcpNoDelay;
+		_tcpNoPush = rhs._tcpNoPush;
+		_limitRate = rhs._limitRate;
+		_limitRateAfter = rhs._limitRateAfter;
 		_modified = rhs._modified;
 	}
 	return *this;
@@ -87,6 +99,9 @@ std::ostream &operator<<(std::ostream &o, Server const &i)
 	o << "Autoindex: " << (i.isAutoIndex() ? "true" : "false") << std::endl;
 	o << "Client max body size: " << i.getClientMaxBodySize() << std::endl;
 	o << "Keep alive: " << (i.isKeepAlive() ? "true" : "false") << std::endl;
+	o << "TCP nodelay: " << (i.isTcpNoDelay() ? "true" : "false") << ", nopush: " << (i.isTcpNoPush() ? "true" : "false")
+	  << std::endl;
+	o << "Limit rate: " << i.getLimitRate() << " bytes/s after " << i.getLimitRateAfter() << " bytes" << std::endl;
 	o << "Status pages: ";
 	for (std::map<int, std::string>::const_iterator it = i.getStatusPages().begin(); it != i.getStatusPages().end();
 		 ++it)
@@ -157,6 +172,27 @@ bool Server::isKeepAlive() const
 	return _keepAlive;
 }
 
+bool Server::isTcpNoDelay() const
+{
+	return _tcpNoDelay;
+}
+
+bool Server::isTcpNoPush() const
+{
+	return _tcpNoPush;
+}
+
+bool Server::hasListenOptions(const SocketAddress &socketAddress) const
+{
+	for (std::vector<std::pair<SocketAddress, ListenOptions> >::const_iterator it = _listenOptions.begin();
+		 it != _listenOptions.end(); ++it)
+	{
+		if (it->first == socketAddress)
+			return true;
+	}
+	return false;
+}
+
 bool Server::isModified() const
 {
 	return _modified;
@@ -176,6 +212,28 @@ const std::vector<SocketAddress> &Server::getSocketAddresses() const
 	return _sockets;
 }
 
+size_t Server::getConnectionLimit(const SocketAddress &socketAddress) const
+{
+	for (std::vector<std::pair<SocketAddress, size_t> >::const_iterator it = _connectionLimits.begin();
+		 it != _connectionLimits.end(); ++it)
+	{
+		if (it->first == socketAddress)
+			return it->second;
+	}
+	return 0;
+}
+
+ListenOptions Server::getListenOptions(const SocketAddress &socketAddress) const
+{
+	for (std::vector<std::pair<SocketAddress, ListenOptions> >::const_iterator it = _listenOptions.begin();
+		 it != _listenOptions.end(); ++it)
+	{
+		if (it->first == socketAddress)
+			return it->second;
+	}
+	return ListenOptions();
+}
+
 const std::string &Server::getRootPath() const
 {
 	return _rootPath;
@@ -190,6 +248,17 @@ double Server::getClientMaxBodySize() const
 {
 	return _clientMaxBodySize;
 }
+
+size_t Server::getLimitRate() const
+{
+	return _limitRate;
+}
+
+size_t Server::getLimitRateAfter() const
+{
+	return _limitRateAfter;
+}
+
 const std::string &Server::getStatusPath(int status) const
 {
 	if (!hasStatusPage(status))
@@ -247,6 +316,38 @@ void Server::insertSocketAddress(const SocketAddress &socketAddress)
 	}
 }
 
+void Server::setConnectionLimit(const SocketAddress &socketAddress, size_t limit)
+{
+	for (std::vector<std::pair<SocketAddress, size_t> >::iterator it = _connectionLimits.begin();
+		 it != _connectionLimits.end(); ++it)
+	{
+		if (it->first == socketAddress)
+		{
+			it->second = limit;
+			_modified = true;
+			return;
+		}
+	}
+	_connectionLimits.push_back(std::make_pair(socketAddress, limit));
+	_modified = true;
+}
+
+void Server::setListenOptions(const SocketAddress &socketAddress, const ListenOptions &options)
+{
+	for (std::vector<std::pair<SocketAddress, ListenOptions> >::iterator it = _listenOptions.begin();
+		 it != _listenOptions.end(); ++it)
+	{
+		if (it->first == socketAddress)
+		{
+			it->second = options;
+			_modified = true;
+			return;
+		}
+	}
+	_listenOptions.push_back(std::make_pair(socketAddress, options));
+	_modified = true;
+}
+
 void Server::insertIndex(const std::string &index)
 {
 	if (!hasIndex(index))
@@ -287,12 +388,36 @@ void Server::setKeepAlive(const bool &keepAlive)
 	_modified = true;
 }
 
+void Server::setTcpNoDelay(const bool &tcpNoDelay)
+{
+	_tcpNoDelay = tcpNoDelay;
+	_modified = true;
+}
+
+void Server::setTcpNoPush(const bool &tcpNoPush)
+{
+	_tcpNoPush = tcpNoPush;
+	_modified = true;
+}
+
 void Server::setClientMaxBodySize(const double &clientMaxBodySize)
 {
 	_clientMaxBodySize = clientMaxBodySize;
 	_modified = true;
 }
 
+void Server::setLimitRate(size_t limitRate)
+{
+	_limitRate = limitRate;
+	_modified = true;
+}
+
+void Server::setLimitRateAfter(size_t limitRateAfter)
+{
+	_limitRateAfter = limitRateAfter;
+	_modified = true;
+}
+
 void Server::setRoot(const std::string &root)
 {
 	_rootPath = root;
@@ -310,6 +435,8 @@ void Server::reset()
 {
 	_serverNames.clear();
 	_sockets.clear();
+	_connectionLimits.clear();
+	_listenOptions.clear();
 	_rootPath = std::string();
 	_indexes.clear();
 	_hasAutoIndex = false;
@@ -318,6 +445,10 @@ void Server::reset()
 	_statusPages.clear();
 	_locations.clear();
 	_keepAlive = HTTP::DEFAULT_KEEP_ALIVE;
+	_tcpNoDelay = HTTP::DEFAULT_TCP_NODELAY;
+	_tcpNoPush = HTTP::DEFAULT_TCP_NOPUSH;
+	_limitRate = 0;
+	_limitRateAfter = 0;
 	_modified = false;
 }
 
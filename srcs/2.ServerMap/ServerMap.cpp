@@ -1,17 +1,23 @@
 #include "../../includes/ConfigParser/ServerMap.hpp"
 #include "../../includes/Global/Logger.hpp"
+#include <unistd.h>
 
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
 */
 
-ServerMap::ServerMap(std::vector<Server> &servers)
+ServerMap::ServerMap() : _reusePort(false)
+{
+}
+
+// previous: map being replaced by a configuration reload, its sockets are taken over for addresses that stay
+ServerMap::ServerMap(std::vector<Server> &servers, bool reusePort, const ServerMap *previous) : _reusePort(reusePort)
 {
 	_servers = servers;
-	_buildServerMap();
+	_buildServerMap(previous);
 }
 
-ServerMap::ServerMap(const ServerMap &src) : _serverMap(src._serverMap)
+ServerMap::ServerMap(const ServerMap &src) : _serverMap(src._serverMap), _reusePort(src._reusePort)
 {
 }
 
@@ -33,13 +39,14 @@ ServerMap &ServerMap::operator=(ServerMap const &rhs)
 	{
 		_servers = rhs._servers;
 		_serverMap = rhs._serverMap;
+		_reusePort = rhs._reusePort;
 	}
 	return *this;
 }
 
 /* --------------------------------- Private Utilities --------------------------------- */
 
-void ServerMap::_buildServerMap()
+void ServerMap::_buildServerMap(const ServerMap *previous)
 {
 	for (std::vector<Server>::iterator server_it = _servers.begin(); server_it != _servers.end(); ++server_it)
 	{
@@ -57,13 +64,35 @@ void ServerMap::_buildServerMap()
 					break;
 				}
 			}
+			if (!found && previous != NULL)
+			{
+				// Same address as before the reload: keep the socket so its accept queue and bound port survive
+				for (std::map<ListeningSocket, std::vector<Server> >::const_iterator previous_it =
+						 previous->_serverMap.begin();
+					 previous_it != previous->_serverMap.end(); ++previous_it)
+				{
+					if (previous_it->first.getAddress() == *socketAddress_it)
+					{
+						_serverMap.insert(std::make_pair(previous_it->first, std::vector<Server>(1, *server_it)));
+						found = true;
+						break;
+					}
+				}
+			}
 			if (!found)
 			{
 				try
 				{
 					ListeningSocket listeningSocket(*socketAddress_it);
+					listeningSocket.setReusePort(_reusePort);
+					listeningSocket.setOptions(_resolveListenOptions(*socketAddress_it));
 					listeningSocket.bind();
-					listeningSocket.listen();
+					// A bound but non-listening socket reserves the address without joining the reuseport group. A unix
+					// socket path cannot be bound twice, so workers all share the one queue listening from the start.
+					if (!_reusePort || socketAddress_it->isUnix())
+						listeningSocket.listen();
+					if (_reusePort && socketAddress_it->isUnix())
+						listeningSocket.setShared(true);
 					_serverMap.insert(std::make_pair(listeningSocket, std::vector<Server>(1, *server_it)));
 				}
 				catch (const std::exception &e)
@@ -78,6 +107,100 @@ void ServerMap::_buildServerMap()
 	}
 }
 
+// Socket options belong to the address, not to one server: the first server that tunes it wins, whichever server
+// happened to open the socket
+ListenOptions ServerMap::_resolveListenOptions(const SocketAddress &address) const
+{
+	for (std::vector<Server>::const_iterator it = _servers.begin(); it != _servers.end(); ++it)
+	{
+		if (it->hasListenOptions(address))
+			return it->getListenOptions(address);
+	}
+	return ListenOptions();
+}
+
+// Called in each worker process: swaps every reserved socket for a private SO_REUSEPORT listener so the kernel
+// spreads incoming connections across the workers' accept queues. If that fails the worker listens on the
+// inherited socket instead, whose accept queue is then shared (and polled with EPOLLEXCLUSIVE)
+void ServerMap::reopenListeners()
+{
+	std::map<ListeningSocket, std::vector<Server> > reopened;
+	for (std::map<ListeningSocket, std::vector<Server> >::const_iterator it = _serverMap.begin();
+		 it != _serverMap.end(); ++it)
+	{
+		if (it->first.getAddress().isUnix())
+		{
+			reopened.insert(*it);
+			continue;
+		}
+		try
+		{
+			ListeningSocket listeningSocket(it->first.getAddress());
+			listeningSocket.setReusePort(true);
+			listeningSocket.setOptions(it->first.getOptions());
+			listeningSocket.bind();
+			listeningSocket.listen();
+			reopened.insert(std::make_pair(listeningSocket, it->second));
+		}
+		catch (const std::exception &e)
+		{
+			Logger::warning("ServerMap: Error reopening listening socket [" + it->first.getAddress().getPortString() +
+								"]: " + std::string(e.what()) + ", sharing the inherited socket",
+							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+			try
+			{
+				ListeningSocket inherited(it->first);
+				inherited.listen();
+				inherited.setShared(true);
+				reopened.insert(std::make_pair(inherited, it->second));
+			}
+			catch (const std::exception &listenError)
+			{
+				Logger::warning("ServerMap: Error listening on inherited socket [" +
+									it->first.getAddress().getPortString() + "]: " + std::string(listenError.what()),
+								__FILE__, __LINE__, __PRETTY_FUNCTION__);
+			}
+		}
+	}
+	_serverMap.swap(reopened);
+}
+
+// Worker side of a reload: addresses new to the configuration were only reserved, this worker listens on them
+// directly since the sockets are its own
+void ServerMap::listenReserved()
+{
+	std::map<ListeningSocket, std::vector<Server> > listening;
+	for (std::map<ListeningSocket, std::vector<Server> >::const_iterator it = _serverMap.begin();
+		 it != _serverMap.end(); ++it)
+	{
+		ListeningSocket listeningSocket(it->first);
+		try
+		{
+			if (!listeningSocket.isListening())
+				listeningSocket.listen();
+			listening.insert(std::make_pair(listeningSocket, it->second));
+		}
+		catch (const std::exception &e)
+		{
+			Logger::warning("ServerMap: Error listening on socket [" + it->first.getAddress().getPortString() +
+								"]: " + std::string(e.what()),
+							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		}
+	}
+	_serverMap.swap(listening);
+}
+
+// Final shutdown of the process that bound them: the files would otherwise only be cleaned up by the next start
+void ServerMap::removeUnixSockets() const
+{
+	for (std::map<ListeningSocket, std::vector<Server> >::const_iterator it = _serverMap.begin();
+		 it != _serverMap.end(); ++it)
+	{
+		if (it->first.getAddress().isUnix())
+			unlink(it->first.getAddress().getHost().c_str());
+	}
+}
+
 bool ServerMap::hasFd(int &fd) const
 {
 	for (std::map<ListeningSocket, std::vector<Server> >::const_iterator it = _serverMap.begin();
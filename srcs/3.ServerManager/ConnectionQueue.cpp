@@ -0,0 +1,84 @@
+#include "../../includes/Core/ConnectionQueue.hpp"
+#include "../../includes/Global/Logger.hpp"
+#include <cerrno>
+#include <stdint.h>
+#include <sys/eventfd.h>
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+ConnectionQueue::ConnectionQueue(size_t capacity) : _mask(0), _head(0), _tail(0)
+{
+	size_t rounded = 1;
+	while (rounded < capacity)
+		rounded <<= 1;
+	_slots.resize(rounded);
+	_mask = rounded - 1;
+	_eventFd = FileDescriptor::createEventFd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+ConnectionQueue::~ConnectionQueue()
+{
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+// Returns false when the ring is full, the caller keeps ownership of the fd
+bool ConnectionQueue::push(const PendingConnection &connection)
+{
+	size_t tail = _tail;
+	__sync_synchronize(); // observe the consumer's latest _head
+	if (tail - _head > _mask)
+		return false;
+	_slots[tail & _mask] = connection;
+	__sync_synchronize(); // slot contents visible before the new tail
+	_tail = tail + 1;
+	return true;
+}
+
+// Never blocks: the counter saturating would only mean the reactor already has a pending wakeup
+void ConnectionQueue::notify()
+{
+	uint64_t one = 1;
+	if (write(_eventFd.getFd(), &one, sizeof(one)) == -1 && errno != EAGAIN)
+		Logger::error("ConnectionQueue: Failed to signal eventfd: " + std::string(strerror(errno)), __FILE__, __LINE__,
+					  __PRETTY_FUNCTION__);
+}
+
+bool ConnectionQueue::pop(PendingConnection &connection)
+{
+	size_t head = _head;
+	__sync_synchronize(); // observe the producer's latest _tail
+	if (head == _tail)
+		return false;
+	__sync_synchronize(); // slot read after the tail that published it
+	connection = _slots[head & _mask];
+	__sync_synchronize(); // slot read completes before it is handed back to the producer
+	_head = head + 1;
+	return true;
+}
+
+void ConnectionQueue::drainNotifications()
+{
+	uint64_t counter = 0;
+	while (read(_eventFd.getFd(), &counter, sizeof(counter)) > 0)
+		;
+}
+
+/*
+** --------------------------------- ACCESSOR ---------------------------------
+*/
+
+int ConnectionQueue::getEventFd() const
+{
+	return _eventFd.getFd();
+}
+
+/* ************************************************************************** */
@@ -57,11 +57,12 @@ EpollManager::~EpollManager()
 ** --------------------------------- METHODS ----------------------------------
 */
 
-void EpollManager::addFd(int fd, uint32_t events)
+void EpollManager::addFd(EpollTag &tag, uint32_t events)
 {
+	int fd = tag.fd;
 	epoll_event event;
 	event.events = events;
-	event.data.fd = fd;
+	event.data.ptr = &tag;
 
 	Logger::debug("EpollManager: Adding fd " + StrUtils::toString(fd) + " with events " + StrUtils::toString(events),
 				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
@@ -73,16 +74,22 @@ void EpollManager::addFd(int fd, uint32_t events)
 		Logger::log(Logger::ERROR, ss.str());
 		throw std::runtime_error(ss.str());
 	}
+	tag.events = events;
 
 	Logger::debug("EpollManager: Successfully added fd " + StrUtils::toString(fd) + " to epoll", __FILE__, __LINE__,
 				  __PRETTY_FUNCTION__);
 }
 
-void EpollManager::modifyFd(int fd, uint32_t events)
+// EPOLL_CTL_MOD re-evaluates readiness, with EPOLLET this re-arms an edge for data that is already pending.
+// Skipped when the mask is unchanged: handlers drain to EAGAIN, so the next edge arrives without a re-arm.
+void EpollManager::modifyFd(EpollTag &tag, uint32_t events)
 {
+	if (tag.events == events)
+		return;
+	int fd = tag.fd;
 	epoll_event event;
 	event.events = events;
-	event.data.fd = fd;
+	event.data.ptr = &tag;
 
 	Logger::debug("EpollManager: Modifying fd " + StrUtils::toString(fd) + " with events " + StrUtils::toString(events),
 				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
@@ -94,6 +101,7 @@ void EpollManager::modifyFd(int fd, uint32_t events)
 		Logger::log(Logger::ERROR, ss.str());
 		throw std::runtime_error(ss.str());
 	}
+	tag.events = events;
 }
 
 void EpollManager::removeFd(int fd)
@@ -139,4 +147,9 @@ FileDescriptor &EpollManager::getFd()
 	return _epollFd;
 }
 
+const char *EpollManager::getName() const
+{
+	return "epoll";
+}
+
 /* ************************************************************************** */
@@ -0,0 +1,48 @@
+#include "../../includes/Core/EventBackend.hpp"
+#include "../../includes/Core/EpollManager.hpp"
+#include "../../includes/Core/IoUringBackend.hpp"
+#include "../../includes/Global/Logger.hpp"
+#include "../../includes/HTTP/HTTP.hpp"
+#include <exception>
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+EventBackend::~EventBackend()
+{
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+EventBackend *EventBackend::create(Type type)
+{
+	if (type == IO_URING)
+	{
+		try
+		{
+			return new IoUringBackend(HTTP::DEFAULT_IO_URING_ENTRIES);
+		}
+		catch (const std::exception &e)
+		{
+			Logger::warning("EventBackend: " + std::string(e.what()) + ", falling back to epoll", __FILE__, __LINE__,
+							__PRETTY_FUNCTION__);
+		}
+	}
+	return new EpollManager();
+}
+
+bool EventBackend::parseType(const std::string &name, Type &typeOut)
+{
+	if (name == "epoll")
+		typeOut = EPOLL;
+	else if (name == "io_uring")
+		typeOut = IO_URING;
+	else
+		return false;
+	return true;
+}
+
+/* ************************************************************************** */
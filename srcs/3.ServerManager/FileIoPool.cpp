@@ -0,0 +1,169 @@
+#include "../../includes/Core/FileIoPool.hpp"
+#include "../../includes/Core/IoCompletionQueue.hpp"
+#include "../../includes/Global/Logger.hpp"
+#include "../../includes/Global/StrUtils.hpp"
+#include "../../includes/HTTP/HTTP.hpp"
+#include <csignal>
+#include <cstring>
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+FileIoPool::Job::Job(IMethodHandler *handler, const HttpRequest &request, const HttpResponse &response,
+					 ConfigSnapshot &snapshot, Client &client)
+	: handler(handler), request(request), response(response), snapshot(&snapshot), client(&client),
+	  completions(NULL), cancelled(false), finished(false), next(NULL)
+{
+	snapshot.retain();
+	// Points into the connection, which may be gone by the time the job runs
+	this->request.setRemoteAddress(NULL);
+}
+
+// Workers inherit a fully blocked mask so process signals are only ever delivered to the event loops
+FileIoPool::FileIoPool(size_t threadCount, size_t capacity)
+	: _head(NULL), _tail(NULL), _queued(0), _capacity(capacity), _stopping(false)
+{
+	sigset_t blockAll;
+	sigset_t previous;
+	sigfillset(&blockAll);
+	pthread_sigmask(SIG_BLOCK, &blockAll, &previous);
+	for (size_t i = 0; i < threadCount; ++i)
+	{
+		pthread_t thread;
+		int error = pthread_create(&thread, NULL, _workerRoutine, this);
+		if (error != 0)
+		{
+			Logger::error("FileIoPool: Failed to start I/O thread " + StrUtils::toString(i) + ": " +
+							  std::string(strerror(error)),
+						  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+			break;
+		}
+		_threads.push_back(thread);
+	}
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+	if (_threads.empty())
+		Logger::warning("FileIoPool: No I/O threads started, file operations run on the event loop", __FILE__,
+						__LINE__, __PRETTY_FUNCTION__);
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+FileIoPool::Job::~Job()
+{
+	delete handler;
+	snapshot->release();
+}
+
+FileIoPool::~FileIoPool()
+{
+	stop();
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+// Runs on an I/O thread. The first part of a file body is read in here as well, so the sendfile() calls the loop
+// makes for it find the pages cached instead of waiting on the disk.
+void FileIoPool::Job::run()
+{
+	try
+	{
+		handler->handleRequest(request, response, request.getSelectedServer(), request.getSelectedLocation());
+		response.prefetchBody(HTTP::FILE_IO_PREFETCH_SIZE);
+	}
+	catch (const std::exception &e)
+	{
+		Logger::error("FileIoPool: " + request.getMethod() + " " + request.getUri() + " failed: " + e.what(),
+					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		response.setResponseDefaultBody(500, "Internal Server Error", request.getSelectedServer(),
+										request.getSelectedLocation(), HttpResponse::ERROR);
+	}
+}
+
+// Returns false when the queue is full or no thread would pick the job up, the caller still owns it
+bool FileIoPool::submit(Job *job)
+{
+	ScopedLock lock(_mutex);
+	if (_stopping || _threads.empty() || _queued >= _capacity)
+		return false;
+	job->next = NULL;
+	if (_tail != NULL)
+		_tail->next = job;
+	else
+		_head = job;
+	_tail = job;
+	++_queued;
+	_ready.signal();
+	return true;
+}
+
+// Lets every thread finish the job it is running and hands the queued ones back cancelled, so each loop can close
+// the connections that were waiting for them. submit() refuses from here on.
+void FileIoPool::stop()
+{
+	Job *queued = NULL;
+	{
+		ScopedLock lock(_mutex);
+		if (_stopping)
+			return;
+		_stopping = true;
+		queued = _head;
+		_head = NULL;
+		_tail = NULL;
+		_queued = 0;
+		_ready.broadcast();
+	}
+	for (std::vector<pthread_t>::iterator it = _threads.begin(); it != _threads.end(); ++it)
+		pthread_join(*it, NULL);
+	_threads.clear();
+	while (queued != NULL)
+	{
+		Job *next = queued->next;
+		queued->cancelled = true;
+		queued->completions->push(queued);
+		queued = next;
+	}
+}
+
+// Blocks until a job is queued, NULL once the pool is stopping
+FileIoPool::Job *FileIoPool::_take()
+{
+	ScopedLock lock(_mutex);
+	while (!_stopping && _head == NULL)
+		_ready.wait(_mutex);
+	if (_stopping)
+		return NULL;
+	Job *job = _head;
+	_head = job->next;
+	if (_head == NULL)
+		_tail = NULL;
+	--_queued;
+	return job;
+}
+
+void *FileIoPool::_workerRoutine(void *arg)
+{
+	FileIoPool *pool = static_cast<FileIoPool *>(arg);
+	Job *job;
+	while ((job = pool->_take()) != NULL)
+	{
+		job->run();
+		job->completions->push(job);
+	}
+	return NULL;
+}
+
+/*
+** --------------------------------- ACCESSOR ---------------------------------
+*/
+
+size_t FileIoPool::getThreadCount() const
+{
+	return _threads.size();
+}
+
+/* ************************************************************************** */
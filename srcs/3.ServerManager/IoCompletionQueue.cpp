@@ -0,0 +1,84 @@
+#include "../../includes/Core/IoCompletionQueue.hpp"
+#include "../../includes/Global/Logger.hpp"
+#include <cerrno>
+#include <stdint.h>
+#include <sys/eventfd.h>
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+IoCompletionQueue::IoCompletionQueue() : _top(NULL)
+{
+	_eventFd = FileDescriptor::createEventFd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+// Completions the loop never took belong to nobody else
+IoCompletionQueue::~IoCompletionQueue()
+{
+	FileIoPool::Job *job = takeAll();
+	while (job != NULL)
+	{
+		FileIoPool::Job *next = job->next;
+		delete job;
+		job = next;
+	}
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+void IoCompletionQueue::push(FileIoPool::Job *job)
+{
+	FileIoPool::Job *top;
+	do
+	{
+		top = _top;
+		job->next = top;
+	} while (!__sync_bool_compare_and_swap(&_top, top, job)); // full barrier, the job is visible before it is linked
+	if (top != NULL)
+		return; // the loop has a wakeup pending for the stack this job joined
+	uint64_t one = 1;
+	if (write(_eventFd.getFd(), &one, sizeof(one)) == -1 && errno != EAGAIN)
+		Logger::error("IoCompletionQueue: Failed to signal eventfd: " + std::string(strerror(errno)), __FILE__,
+					  __LINE__, __PRETTY_FUNCTION__);
+}
+
+// Oldest first, linked through next
+FileIoPool::Job *IoCompletionQueue::takeAll()
+{
+	FileIoPool::Job *job = __sync_lock_test_and_set(&_top, static_cast<FileIoPool::Job *>(NULL));
+	FileIoPool::Job *ordered = NULL;
+	while (job != NULL)
+	{
+		FileIoPool::Job *next = job->next;
+		job->next = ordered;
+		ordered = job;
+		job = next;
+	}
+	return ordered;
+}
+
+// Before takeAll(): a push that lands in between then still leaves a wakeup behind
+void IoCompletionQueue::drainNotifications()
+{
+	uint64_t counter = 0;
+	while (read(_eventFd.getFd(), &counter, sizeof(counter)) > 0)
+		;
+}
+
+/*
+** --------------------------------- ACCESSOR ---------------------------------
+*/
+
+int IoCompletionQueue::getEventFd() const
+{
+	return _eventFd.getFd();
+}
+
+/* ************************************************************************** */
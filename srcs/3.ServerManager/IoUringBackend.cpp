@@ -0,0 +1,300 @@
+#include "../../includes/Core/IoUringBackend.hpp"
+#include "../../includes/Global/Logger.hpp"
+#include "../../includes/Global/StrUtils.hpp"
+#include <cerrno>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+// user_data of requests whose completion carries no readiness (poll removals, timeouts)
+const uint64_t IGNORED_COMPLETION = ~static_cast<uint64_t>(0);
+
+// Flags only meaningful to epoll, POLL_ADD rejects or ignores them
+const uint32_t EPOLL_ONLY_FLAGS = EPOLLET | EPOLLONESHOT
+#ifdef EPOLLEXCLUSIVE
+								  | EPOLLEXCLUSIVE
+#endif
+	;
+
+uint64_t completionKey(int fd, uint32_t generation)
+{
+	return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+}
+
+// The kernel updates the rings concurrently, full barriers order index loads and stores against the entries
+unsigned loadAcquire(const unsigned *value)
+{
+	unsigned loaded = *const_cast<const volatile unsigned *>(value);
+	__sync_synchronize();
+	return loaded;
+}
+
+void storeRelease(unsigned *target, unsigned value)
+{
+	__sync_synchronize();
+	*const_cast<volatile unsigned *>(target) = value;
+}
+} // namespace
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+IoUringBackend::IoUringBackend(unsigned entries)
+	: _sqRing(MAP_FAILED), _sqRingSize(0), _cqRing(MAP_FAILED), _cqRingSize(0),
+	  _sqes(static_cast<struct io_uring_sqe *>(MAP_FAILED)), _sqesSize(0)
+{
+	struct io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	std::memset(&_timeout, 0, sizeof(_timeout));
+	int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+	if (fd == -1)
+		throw std::runtime_error("io_uring_setup failed: " + std::string(strerror(errno)));
+	_ringFd = FileDescriptor::createFromRaw(fd);
+	// Multishot poll predates IORING_FEAT_CQE_SKIP, kernels without the feature are left to epoll
+	if (!(params.features & IORING_FEAT_CQE_SKIP))
+		throw std::runtime_error("io_uring on this kernel lacks multishot poll support");
+
+	_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMmap && _cqRingSize > _sqRingSize)
+		_sqRingSize = _cqRingSize;
+	_sqRing = mmap(NULL, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (_sqRing == MAP_FAILED)
+		throw std::runtime_error("io_uring submission ring mmap failed: " + std::string(strerror(errno)));
+	if (singleMmap)
+		_cqRing = _sqRing;
+	else
+	{
+		_cqRing = mmap(NULL, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (_cqRing == MAP_FAILED)
+		{
+			munmap(_sqRing, _sqRingSize);
+			throw std::runtime_error("io_uring completion ring mmap failed: " + std::string(strerror(errno)));
+		}
+	}
+	_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	void *sqes = mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED)
+	{
+		if (_cqRing != _sqRing)
+			munmap(_cqRing, _cqRingSize);
+		munmap(_sqRing, _sqRingSize);
+		throw std::runtime_error("io_uring sqe array mmap failed: " + std::string(strerror(errno)));
+	}
+	_sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+	char *sq = static_cast<char *>(_sqRing);
+	_sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+	_sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+	_sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+	_sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+	_sqEntries = params.sq_entries;
+	char *cq = static_cast<char *>(_cqRing);
+	_cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+	_cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+	_cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+	_cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+
+	Logger::info("IoUringBackend: io_uring instance created with fd " + StrUtils::toString(fd) + ", " +
+					 StrUtils::toString(_sqEntries) + " submission entries",
+				 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+IoUringBackend::~IoUringBackend()
+{
+	munmap(_sqes, _sqesSize);
+	if (_cqRing != _sqRing)
+		munmap(_cqRing, _cqRingSize);
+	munmap(_sqRing, _sqRingSize);
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+// Returns a zeroed sqe at the tail of the submission ring, flushing the ring to the kernel when it is full
+struct io_uring_sqe *IoUringBackend::_nextSqe()
+{
+	unsigned tail = *_sqTail;
+	if (tail - loadAcquire(_sqHead) >= _sqEntries)
+	{
+		_enter(0);
+		if (tail - loadAcquire(_sqHead) >= _sqEntries)
+			throw std::runtime_error("io_uring submission ring is full");
+	}
+	unsigned index = tail & *_sqMask;
+	struct io_uring_sqe *sqe = &_sqes[index];
+	std::memset(sqe, 0, sizeof(*sqe));
+	_sqArray[index] = index;
+	storeRelease(_sqTail, tail + 1);
+	return sqe;
+}
+
+// Submits everything queued and optionally waits for completions, -1 with errno set on failure
+int IoUringBackend::_enter(unsigned minComplete)
+{
+	unsigned toSubmit = *_sqTail - loadAcquire(_sqHead);
+	unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+	if (toSubmit == 0 && flags == 0)
+		return 0;
+	return static_cast<int>(syscall(__NR_io_uring_enter, _ringFd.getFd(), toSubmit, minComplete, flags, NULL, 0));
+}
+
+IoUringBackend::Registration &IoUringBackend::_registration(int fd)
+{
+	if (static_cast<size_t>(fd) >= _registrations.size())
+		_registrations.resize(static_cast<size_t>(fd) + 1);
+	return _registrations[static_cast<size_t>(fd)];
+}
+
+void IoUringBackend::_arm(int fd)
+{
+	Registration &registration = _registration(fd);
+	registration.generation++;
+	registration.armed = true;
+	registration.rearm = false;
+	struct io_uring_sqe *sqe = _nextSqe();
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll32_events = registration.events;
+	sqe->len = IORING_POLL_ADD_MULTI;
+	sqe->user_data = completionKey(fd, registration.generation);
+}
+
+// Cancels the in-flight poll, its completion arrives with -ECANCELED under a stale generation and is dropped
+void IoUringBackend::_cancel(Registration &registration, int fd)
+{
+	if (!registration.armed)
+		return;
+	struct io_uring_sqe *sqe = _nextSqe();
+	sqe->opcode = IORING_OP_POLL_REMOVE;
+	sqe->fd = -1;
+	sqe->addr = completionKey(fd, registration.generation);
+	sqe->user_data = IGNORED_COMPLETION;
+	registration.armed = false;
+	registration.generation++;
+}
+
+void IoUringBackend::addFd(EpollTag &tag, uint32_t events)
+{
+	if (tag.fd < 0)
+		throw std::runtime_error("io_uring poll add failed for fd: " + StrUtils::toString(tag.fd));
+	Registration &registration = _registration(tag.fd);
+	_cancel(registration, tag.fd);
+	registration.tag = &tag;
+	registration.events = events & ~EPOLL_ONLY_FLAGS;
+	_arm(tag.fd);
+	tag.events = events;
+}
+
+// A delivered poll picks the new mask up when it is re-armed, an armed one is replaced
+void IoUringBackend::modifyFd(EpollTag &tag, uint32_t events)
+{
+	if (tag.events == events)
+		return;
+	Registration &registration = _registration(tag.fd);
+	registration.tag = &tag;
+	registration.events = events & ~EPOLL_ONLY_FLAGS;
+	if (registration.armed)
+	{
+		_cancel(registration, tag.fd);
+		_arm(tag.fd);
+	}
+	tag.events = events;
+}
+
+void IoUringBackend::removeFd(int fd)
+{
+	if (fd < 0 || static_cast<size_t>(fd) >= _registrations.size())
+		return;
+	Registration &registration = _registrations[static_cast<size_t>(fd)];
+	_cancel(registration, fd);
+	// Keep the generation so completions still in the ring cannot match a later registration of the fd
+	uint32_t generation = registration.generation;
+	registration = Registration();
+	registration.generation = generation;
+}
+
+int IoUringBackend::wait(std::vector<epoll_event> &events, int timeout)
+{
+	if (events.empty())
+		events.resize(128);
+
+	for (std::vector<int>::iterator it = _rearm.begin(); it != _rearm.end(); ++it)
+	{
+		Registration &registration = _registrations[static_cast<size_t>(*it)];
+		if (registration.tag != NULL && registration.rearm && !registration.armed)
+			_arm(*it);
+	}
+	_rearm.clear();
+
+	// Completions already in the ring are returned without blocking
+	unsigned minComplete = 0;
+	if (timeout != 0 && loadAcquire(_cqTail) == *_cqHead)
+	{
+		minComplete = 1;
+		if (timeout > 0)
+		{
+			// Completes after the first other completion or when the timeout expires, whichever comes first
+			_timeout.tv_sec = timeout / 1000;
+			_timeout.tv_nsec = static_cast<long long>(timeout % 1000) * 1000000;
+			struct io_uring_sqe *sqe = _nextSqe();
+			sqe->opcode = IORING_OP_TIMEOUT;
+			sqe->fd = -1;
+			sqe->addr = reinterpret_cast<uint64_t>(&_timeout);
+			sqe->len = 1;
+			sqe->off = 1;
+			sqe->user_data = IGNORED_COMPLETION;
+		}
+	}
+	if (_enter(minComplete) == -1 && errno != EINTR && errno != EBUSY && errno != EAGAIN)
+	{
+		std::string error = "io_uring_enter failed: " + std::string(strerror(errno));
+		Logger::log(Logger::ERROR, error);
+		throw std::runtime_error(error);
+	}
+
+	int readyCount = 0;
+	unsigned head = *_cqHead;
+	unsigned tail = loadAcquire(_cqTail);
+	while (head != tail && static_cast<size_t>(readyCount) < events.size())
+	{
+		const struct io_uring_cqe &cqe = _cqes[head & *_cqMask];
+		++head;
+		if (cqe.user_data == IGNORED_COMPLETION)
+			continue;
+		int fd = static_cast<int>(static_cast<uint32_t>(cqe.user_data));
+		uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 32);
+		if (fd < 0 || static_cast<size_t>(fd) >= _registrations.size())
+			continue;
+		Registration &registration = _registrations[static_cast<size_t>(fd)];
+		if (registration.tag == NULL || registration.generation != generation || cqe.res == -ECANCELED)
+			continue;
+		if (!(cqe.flags & IORING_CQE_F_MORE))
+		{
+			// The kernel ended the multishot poll (error or completion overflow), it is armed again next turn
+			registration.armed = false;
+			registration.rearm = true;
+			_rearm.push_back(fd);
+		}
+		events[readyCount].events = cqe.res < 0 ? static_cast<uint32_t>(EPOLLERR) : static_cast<uint32_t>(cqe.res);
+		events[readyCount].data.ptr = registration.tag;
+		++readyCount;
+	}
+	storeRelease(_cqHead, head);
+	return readyCount;
+}
+
+const char *IoUringBackend::getName() const
+{
+	return "io_uring";
+}
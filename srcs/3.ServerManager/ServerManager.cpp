@@ -1,18 +1,50 @@
 #include "../../includes/Core/ServerManager.hpp"
+#include "../../includes/CGI/CgiExecutor.hpp"
+#include "../../includes/ConfigParser/ConfigFileReader.hpp"
+#include "../../includes/ConfigParser/ConfigParser.hpp"
+#include "../../includes/ConfigParser/ConfigTokeniser.hpp"
+#include "../../includes/ConfigParser/ConfigTranslator.hpp"
+#include "../../includes/Core/MethodHandlerFactory.hpp"
+#include "../../includes/Global/DefaultStatusMap.hpp"
+#include "../../includes/Global/MimeTypeResolver.hpp"
+#include "../../includes/Global/PerformanceMonitor.hpp"
 #include "../../includes/Global/StrUtils.hpp"
+#include "../../includes/HTTP/HTTP.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <sched.h>
 #include <signal.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
 
 // Static member definition
-bool ServerManager::serverRunning = true;
+volatile bool ServerManager::serverRunning = true;
+volatile size_t ServerManager::_openConnections = 0;
 
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
 */
 
-ServerManager::ServerManager(ServerMap &serverMap) : _serverMap(serverMap)
+ServerManager::ServerManager(ServerMap &serverMap, const GlobalConfig &globalConfig, const std::string &configPath)
+	: _serverMap(serverMap), _clients(HTTP::DEFAULT_CLIENT_SLAB_SIZE), _timers(TimerWheel::monotonicMs()), _now(0),
+	  _events(HTTP::DEFAULT_EPOLL_EVENTS), _acceptPausedUntil(0), _connectionLimit(0), _shedLogAt(0),
+	  _globalConfig(globalConfig),
+	  _eventBackend(EventBackend::create(globalConfig.getEventBackend())), _configPath(configPath), _snapshot(NULL),
+	  _generation(0), _ioPool(NULL), _role(STANDALONE), _handoffQueue(NULL),
+	  _nextReactor(0)
+{
+}
+
+ServerManager::ServerManager(ConnectionQueue &handoffQueue, const GlobalConfig &globalConfig, FileIoPool *ioPool)
+	: _clients(HTTP::DEFAULT_CLIENT_SLAB_SIZE), _timers(TimerWheel::monotonicMs()), _now(0),
+	  _events(HTTP::DEFAULT_EPOLL_EVENTS), _acceptPausedUntil(0), _connectionLimit(0), _shedLogAt(0),
+	  _globalConfig(globalConfig),
+	  _eventBackend(EventBackend::create(globalConfig.getEventBackend())), _snapshot(NULL), _generation(0),
+	  _ioPool(ioPool), _role(REACTOR), _handoffQueue(&handoffQueue),
+	  _nextReactor(0)
 {
-	_epollManager = EpollManager();
-	_clients = std::map<int, Client>();
 }
 
 /*
@@ -21,6 +53,11 @@ ServerManager::ServerManager(ServerMap &serverMap) : _serverMap(serverMap)
 
 ServerManager::~ServerManager()
 {
+	if (_role != REACTOR)
+		delete _ioPool;
+	delete _eventBackend;
+	if (_snapshot != NULL)
+		_snapshot->release();
 }
 
 /*
@@ -33,12 +70,24 @@ void ServerManager::_addServerFdsToEpoll(ServerMap &serverMap)
 					  StrUtils::toString(serverMap.getServerMap().size()),
 				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 
+	// Sized up front, epoll keeps pointers into this vector
+	_listenerTags.clear();
+	_listenerTags.reserve(serverMap.getServerMap().size());
 	for (std::map<ListeningSocket, std::vector<Server> >::const_iterator it = serverMap.getServerMap().begin();
 		 it != serverMap.getServerMap().end(); ++it)
 	{
 		Logger::debug("ServerManager: Adding server fd: " + StrUtils::toString(it->first.getFd().getFd()) + " to epoll",
 					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
-		_epollManager.addFd(it->first.getFd().getFd());
+		_listenerTags.push_back(EpollTag(EpollTag::LISTENER, it->first.getFd().getFd(),
+										 const_cast<ConfigSnapshot::Listener *>(
+											 _snapshot->findListener(it->first.getAddress()))));
+		uint32_t events = EPOLLIN | EPOLLET;
+#ifdef EPOLLEXCLUSIVE
+		// Several workers wait on this accept queue, wake only one of them per connection
+		if (it->first.isShared())
+			events |= EPOLLEXCLUSIVE;
+#endif
+		_eventBackend->addFd(_listenerTags.back(), events);
 	}
 	Logger::debug("ServerManager: Added " + StrUtils::toString(serverMap.getServerMap().size()) +
 					  " server file descriptors to epoll",
@@ -52,61 +101,322 @@ void ServerManager::_handleEventLoop(int ready_events, std::vector<epoll_event>
 
 	for (int i = 0; i < ready_events; ++i)
 	{
-		int fd = events[i].data.fd;
-		Logger::debug("ServerManager: Processing event for fd: " + StrUtils::toString(fd) +
+		EpollTag &tag = *static_cast<EpollTag *>(events[i].data.ptr);
+		Logger::debug("ServerManager: Processing event for fd: " + StrUtils::toString(tag.fd) +
 						  ", events: " + StrUtils::toString(events[i].events),
 					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 
-		if (_serverMap.hasFd(fd))
+		switch (tag.type)
 		{
-			// Handle new connection
+		case EpollTag::LISTENER:
 			Logger::debug("ServerManager: This is a server fd, handling new connection", __FILE__, __LINE__,
 						  __PRETTY_FUNCTION__);
-			Logger::debug("ServerManager: Server fd: " + StrUtils::toString(fd) +
-							  ", events: " + StrUtils::toString(events[i].events),
-						  __FILE__, __LINE__, __PRETTY_FUNCTION__);
-			_handleNewConnection(fd);
-		}
-		else if (_clients.find(fd) != _clients.end())
-		{
-			// Handle existing client
+			_handleNewConnection(tag);
+			break;
+		case EpollTag::HANDOFF:
+			_acceptHandoffs();
+			break;
+		case EpollTag::SIGNAL:
+			_handleSignalFd();
+			break;
+		case EpollTag::FILE_IO:
+			_completeFileIo();
+			break;
+		case EpollTag::CLIENT:
+			// Harvested before a resumed client closed this turn, its released slot no longer holds a socket
+			if (tag.fd == -1)
+				break;
 			Logger::debug("ServerManager: This is a client fd, handling client event", __FILE__, __LINE__,
 						  __PRETTY_FUNCTION__);
-			_handleClientEvent(_clients.find(fd)->second, events[i]);
+			_handleClientEvent(*static_cast<Client *>(tag.owner), events[i]);
+			break;
 		}
-		else
+	}
+}
+
+// Edge triggered: a single notification may stand for several pending connections. Up to accept_batch of them
+// are taken per wakeup, a longer backlog is finished on the next loop turn so clients are not starved.
+void ServerManager::_handleNewConnection(EpollTag &listenerTag)
+{
+	Logger::debug("ServerManager: Handling new connection on server fd: " + StrUtils::toString(listenerTag.fd),
+				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	if (_now < _acceptPausedUntil)
+		return _deferAccept(listenerTag);
+	const ConfigSnapshot::Listener &listener = *static_cast<const ConfigSnapshot::Listener *>(listenerTag.owner);
+
+	for (size_t accepted = 0; accepted < _globalConfig.getAcceptBatch();)
+	{
+		// Accept new connection, already non-blocking and close-on-exec
+		SocketAddress remoteAddress;
+		FileDescriptor clientFdObj =
+			FileDescriptor::createFromAccept(listenerTag.fd, remoteAddress, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (!clientFdObj.isValid())
 		{
-			Logger::debug("ServerManager: Unknown fd: " + StrUtils::toString(fd), __FILE__, __LINE__,
-						  __PRETTY_FUNCTION__);
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+			{
+				Logger::warning("ServerManager: Out of resources accepting connections (" +
+									std::string(strerror(errno)) + "), pausing accept for " +
+									StrUtils::toString(HTTP::ACCEPT_PAUSE_MS) + "ms",
+								__FILE__, __LINE__, __PRETTY_FUNCTION__);
+				if (errno == EMFILE || errno == ENFILE)
+					_shedConnection(listenerTag.fd);
+				_acceptPausedUntil = _now + HTTP::ACCEPT_PAUSE_MS;
+				return _deferAccept(listenerTag);
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				Logger::error("ServerManager: Failed to accept connection: " + std::string(strerror(errno)), __FILE__,
+							  __LINE__, __PRETTY_FUNCTION__);
+			return;
+		}
+		++accepted;
+		if (!_admitConnection(listener))
+		{
+			_rejectConnection(clientFdObj, listener);
+			continue;
 		}
+		if (_role == ACCEPTOR)
+		{
+			_dispatchConnection(clientFdObj, remoteAddress, listener);
+			continue;
+		}
+		_registerClient(clientFdObj, remoteAddress, *_snapshot, listener);
+		Logger::debug("ServerManager: New client connected from " + remoteAddress.getHostString() + ":" +
+						  remoteAddress.getPortString() + " to server fd: " + StrUtils::toString(listenerTag.fd),
+					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 	}
+	// Batch used up before EAGAIN: no new edge will be raised for what is still queued
+	_deferAccept(listenerTag);
 }
 
-void ServerManager::_handleNewConnection(int serverFd)
+void ServerManager::_deferAccept(EpollTag &listenerTag)
 {
-	Logger::debug("ServerManager: Handling new connection on server fd: " + StrUtils::toString(serverFd), __FILE__,
-				  __LINE__, __PRETTY_FUNCTION__);
+	if (std::find(_pendingAccepts.begin(), _pendingAccepts.end(), &listenerTag) == _pendingAccepts.end())
+		_pendingAccepts.push_back(&listenerTag);
+}
 
-	// Accept new connection
+void ServerManager::_resumeAccepts()
+{
+	if (_pendingAccepts.empty() || _now < _acceptPausedUntil)
+		return;
+	std::vector<EpollTag *> pending;
+	pending.swap(_pendingAccepts);
+	for (std::vector<EpollTag *>::iterator it = pending.begin(); it != pending.end(); ++it)
+		_handleNewConnection(**it);
+}
+
+// Reserved fd trick: hand back the spare descriptor, accept the oldest queued connection and close it at once so
+// the peer gets an answer instead of hanging in the backlog, then take the spare again
+void ServerManager::_shedConnection(int listenerFd)
+{
+	if (!_reserveFd.isValid())
+		return;
+	_reserveFd = FileDescriptor();
 	SocketAddress remoteAddress;
-	FileDescriptor clientFdObj = FileDescriptor::createFromAccept(serverFd, remoteAddress);
-	if (!clientFdObj.isValid())
-		return Logger::error("ServerManager: Failed to accept connection: " + std::string(strerror(errno)), __FILE__,
-							 __LINE__, __PRETTY_FUNCTION__);
-	else if (!clientFdObj.setNonBlocking())
-		return Logger::error("ServerManager: Failed to set socket to non-blocking: " + std::string(strerror(errno)),
-							 __FILE__, __LINE__, __PRETTY_FUNCTION__);
-	// Create client object
-	Client client(clientFdObj, remoteAddress);
-	// Set potential servers for this client
-	client.setPotentialServers(_serverMap.getServersForFd(serverFd));
-	// Add client to epoll
-	_epollManager.addFd(client.getSocketFd(), EPOLLIN);
-	// Store client in map
-	_clients[client.getSocketFd()] = client;
-	Logger::debug("ServerManager: New client connected from " + remoteAddress.getHostString() + ":" +
-					  remoteAddress.getPortString() + " to server fd: " + StrUtils::toString(serverFd),
-				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	FileDescriptor shed = FileDescriptor::createFromAccept(listenerFd, remoteAddress, SOCK_CLOEXEC);
+	if (shed.isValid())
+		Logger::warning("ServerManager: Dropped connection from " + remoteAddress.getHostString() +
+							", out of file descriptors",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	shed = FileDescriptor();
+	_reserveFd = FileDescriptor::createFromOpen("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+// Lifts the soft RLIMIT_NOFILE toward the hard one: as far as worker_connections needs, or all the way when the
+// connection limit is left to be derived from it. Runs before any worker is forked so they all inherit it.
+void ServerManager::_raiseFileLimit() const
+{
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == -1)
+		return;
+	rlim_t wanted = limit.rlim_max;
+	if (_globalConfig.getWorkerConnections() != 0)
+		wanted = static_cast<rlim_t>(_globalConfig.getWorkerConnections() * HTTP::FDS_PER_CONNECTION +
+									 HTTP::RESERVED_FDS);
+	if (wanted > limit.rlim_max)
+		wanted = limit.rlim_max;
+	if (wanted == RLIM_INFINITY)
+		wanted = HTTP::OPEN_FILES_CEILING;
+	if (wanted <= limit.rlim_cur)
+		return;
+	rlim_t previous = limit.rlim_cur;
+	limit.rlim_cur = wanted;
+	if (setrlimit(RLIMIT_NOFILE, &limit) == -1)
+		return Logger::warning("ServerManager: Failed to raise the open file limit from " +
+								   StrUtils::toString(previous) + " to " + StrUtils::toString(wanted) + ": " +
+								   std::string(strerror(errno)),
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	Logger::info("ServerManager: Raised the open file limit from " + StrUtils::toString(previous) + " to " +
+					 StrUtils::toString(wanted),
+				 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// worker_connections, or what the open file limit can hold when it is unset or larger: connections have to be
+// turned away before accept() starts failing with EMFILE and every client degrades together
+size_t ServerManager::_resolveConnectionLimit() const
+{
+	size_t fdBound = HTTP::OPEN_FILES_CEILING / HTTP::FDS_PER_CONNECTION;
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+		fdBound = limit.rlim_cur > HTTP::RESERVED_FDS
+					  ? static_cast<size_t>(limit.rlim_cur - HTTP::RESERVED_FDS) / HTTP::FDS_PER_CONNECTION
+					  : 1;
+	size_t configured = _globalConfig.getWorkerConnections();
+	if (configured == 0)
+		return fdBound;
+	if (configured > fdBound)
+	{
+		Logger::warning("ServerManager: worker_connections " + StrUtils::toString(configured) +
+							" does not fit the open file limit, admitting at most " + StrUtils::toString(fdBound),
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		return fdBound;
+	}
+	return configured;
+}
+
+// Takes a process slot and a listener slot for a fresh connection. Only the accepting thread adds to the counters,
+// the reactor threads closing connections take away from them.
+bool ServerManager::_admitConnection(const ConfigSnapshot::Listener &listener)
+{
+	if (__sync_add_and_fetch(&_openConnections, 1) <= _connectionLimit && listener.admit())
+		return true;
+	__sync_sub_and_fetch(&_openConnections, 1);
+	return false;
+}
+
+void ServerManager::_releaseConnection(const ConfigSnapshot::Listener &listener)
+{
+	__sync_sub_and_fetch(&_openConnections, 1);
+	listener.leave();
+}
+
+// Over a limit: the canned 503 goes out from static storage and the socket is closed, without a Client slot,
+// parsing or a log line per connection. What already arrived of the request is read away first so close() sends a
+// FIN instead of a reset that could destroy the response before the peer reads it.
+void ServerManager::_rejectConnection(FileDescriptor &clientFd, const ConfigSnapshot::Listener &listener)
+{
+	static char discard[HTTP::DEFAULT_RECV_SIZE];
+	int fd = clientFd.getFd();
+	send(fd, HTTP::OVERLOAD_RESPONSE, sizeof(HTTP::OVERLOAD_RESPONSE) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+	shutdown(fd, SHUT_WR);
+	recv(fd, discard, sizeof(discard), MSG_DONTWAIT);
+	clientFd = FileDescriptor();
+	PERF_RECORD_REJECTED_CONNECTION();
+	if (_now < _shedLogAt)
+		return;
+	_shedLogAt = _now + HTTP::SHED_LOG_INTERVAL_MS;
+	if (listener.connectionLimit != 0 && listener.connections >= listener.connectionLimit)
+		Logger::warning("ServerManager: max_connections " + StrUtils::toString(listener.connectionLimit) +
+							" reached on " + listener.address.getHostString() + ":" +
+							listener.address.getPortString() + ", answering new connections with 503",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else
+		Logger::warning("ServerManager: worker_connections " + StrUtils::toString(_connectionLimit) +
+							" reached, answering new connections with 503",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// Next client deadline, or sooner when a listener or a client still has work left over from the previous turn or a
+// replaced configuration reaches its drain deadline
+int ServerManager::_pollTimeout() const
+{
+	int timeout = _timers.msUntilNext(_now);
+	if (!_drains.empty())
+	{
+		int drainWait = _drains.front().deadline > _now ? static_cast<int>(_drains.front().deadline - _now) : 0;
+		if (timeout < 0 || drainWait < timeout)
+			timeout = drainWait;
+	}
+	if (!_readyClients.empty())
+		return 0;
+	if (_pendingAccepts.empty())
+		return timeout;
+	int acceptWait = _acceptPausedUntil > _now ? static_cast<int>(_acceptPausedUntil - _now) : 0;
+	return (timeout < 0 || acceptWait < timeout) ? acceptWait : timeout;
+}
+
+// Binds a recycled slot to the socket, no Client is constructed or copied per connection
+void ServerManager::_registerClient(const FileDescriptor &clientFd, const SocketAddress &remoteAddress,
+									ConfigSnapshot &snapshot, const ConfigSnapshot::Listener &listener)
+{
+	Client *client = _clients.acquire(clientFd, remoteAddress, snapshot, listener, _now);
+	if (client == NULL)
+		return;
+	_eventBackend->addFd(client->getEpollTag(), EPOLLIN | EPOLLET);
+	_armClientTimer(*client);
+}
+
+void ServerManager::_closeClient(int fd)
+{
+	Client *client = _clients.find(fd);
+	if (client != NULL)
+	{
+		_timers.cancel(client->getTimer());
+		_releaseConnection(*client->getListener());
+		std::vector<Client *>::iterator ready = std::find(_readyClients.begin(), _readyClients.end(), client);
+		if (ready != _readyClients.end())
+			_readyClients.erase(ready);
+	}
+	_eventBackend->removeFd(fd);
+	_clients.release(fd);
+}
+
+// Every event re-arms the deadline of the phase the client is now in, header and keep-alive deadlines are
+// absolute for the phase so trickling bytes cannot extend them
+void ServerManager::_armClientTimer(Client &client)
+{
+	uint64_t deadline = 0;
+	switch (client.getTimerPhase())
+	{
+	case Client::HEADER_PHASE:
+		deadline = client.getPhaseStart() + _globalConfig.getClientHeaderTimeout();
+		break;
+	case Client::BODY_PHASE:
+		deadline = client.getLastProgress() + _globalConfig.getClientBodyTimeout();
+		break;
+	case Client::SEND_PHASE:
+		deadline = client.getLastProgress() + _globalConfig.getSendTimeout();
+		break;
+	case Client::KEEPALIVE_PHASE:
+		deadline = client.getPhaseStart() + _globalConfig.getKeepaliveTimeout();
+		break;
+	case Client::THROTTLE_PHASE:
+		deadline = client.getThrottledUntil();
+		break;
+	case Client::IO_PHASE:
+		deadline = client.getLastProgress() + _globalConfig.getSendTimeout();
+		break;
+	}
+	_timers.schedule(client.getTimer(), deadline);
+}
+
+void ServerManager::_expireClients()
+{
+	static const char *const phaseNames[] = {"header", "body", "send", "keepalive", "throttle", "io"};
+
+	_expired.clear();
+	_timers.advance(_now, _expired);
+	for (std::vector<void *>::iterator it = _expired.begin(); it != _expired.end(); ++it)
+	{
+		Client &client = *static_cast<Client *>(*it);
+		// Not a timeout: the rate limit lets the response send again
+		if (client.getTimerPhase() == Client::THROTTLE_PHASE)
+		{
+			epoll_event event;
+			event.events = EPOLLOUT;
+			event.data.ptr = &client.getEpollTag();
+			_handleClientEvent(client, event);
+			continue;
+		}
+		Logger::debug("ServerManager: Client " + client.getRemoteAddr().getHostString() + ":" +
+						  client.getRemoteAddr().getPortString() + " exceeded its " +
+						  phaseNames[client.getTimerPhase()] + " deadline, closing fd " +
+						  StrUtils::toString(client.getSocketFd()),
+					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		PERF_RECORD_TIMEOUT();
+		_closeClient(client.getSocketFd());
+	}
 }
 
 void ServerManager::_handleClientEvent(Client &client, epoll_event event)
@@ -115,34 +425,147 @@ void ServerManager::_handleClientEvent(Client &client, epoll_event event)
 	Logger::debug("ServerManager: Handling client event for client: " + client.getRemoteAddr().getHostString() + ":" +
 					  client.getRemoteAddr().getPortString(),
 				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
-	client.handleEvent(event);
+	client.handleEvent(event, _now);
+	_settleClient(client);
+}
+
+// Registers the interest and deadline the client's new state calls for, or closes it
+void ServerManager::_settleClient(Client &client)
+{
+	if (client.getSnapshot() != _snapshot && client.getCurrentState() != Client::DISCONNECTED)
+		_rebindClient(client);
 	switch (client.getCurrentState())
 	{
 	case Client::WAITING_FOR_EPOLLIN:
 	{
 		Logger::debug("ServerManager: Client is waiting for EPOLLIN, modifying epoll for EPOLLIN", __FILE__, __LINE__,
 					  __PRETTY_FUNCTION__);
-		_epollManager.modifyFd(client.getSocketFd(), EPOLLIN);
+		_eventBackend->modifyFd(client.getEpollTag(), EPOLLIN | EPOLLET);
+		_armClientTimer(client);
+		if (client.getYieldedEvents() != 0)
+			_deferClient(client);
 		break;
 	}
 	case Client::WAITING_FOR_EPOLLOUT:
 	{
 		Logger::debug("ServerManager: Client is waiting for EPOLLOUT, modifying epoll for EPOLLOUT", __FILE__, __LINE__,
 					  __PRETTY_FUNCTION__);
-		_epollManager.modifyFd(client.getSocketFd(), EPOLLOUT);
+		// A throttled connection is still writable, every ACK would raise another EPOLLOUT edge. It waits for its
+		// timer with no interest registered, errors and hang-ups are still reported.
+		if (client.getTimerPhase() == Client::THROTTLE_PHASE)
+			_eventBackend->modifyFd(client.getEpollTag(), EPOLLET);
+		else
+			_eventBackend->modifyFd(client.getEpollTag(), EPOLLOUT | EPOLLET);
+		_armClientTimer(client);
+		if (client.getYieldedEvents() != 0)
+			_deferClient(client);
+		break;
+	}
+	case Client::WAITING_FOR_IO:
+	{
+		const std::deque<FileIoPool::Job *> &jobs = client.getFileIoJobs();
+		for (std::deque<FileIoPool::Job *>::const_iterator it = jobs.begin(); it != jobs.end(); ++it)
+			if ((*it)->completions == NULL && !(*it)->finished)
+				_submitFileIo(**it);
+		// Responses queued ahead of the job keep flushing, nothing is read until it is back
+		if (client.hasQueuedResponses() && client.getTimerPhase() != Client::THROTTLE_PHASE)
+			_eventBackend->modifyFd(client.getEpollTag(), EPOLLOUT | EPOLLET);
+		else
+			_eventBackend->modifyFd(client.getEpollTag(), EPOLLET);
+		_armClientTimer(client);
+		if (client.getYieldedEvents() != 0)
+			_deferClient(client);
 		break;
 	}
 	case Client::DISCONNECTED:
 	{
 		Logger::debug("ServerManager: Client is disconnected, removing from epoll and clients map", __FILE__, __LINE__,
 					  __PRETTY_FUNCTION__);
-		_epollManager.removeFd(client.getSocketFd());
-		_clients.erase(client.getSocketFd());
+		_closeClient(client.getSocketFd());
 		break;
 	}
 	}
 }
 
+/*
+** ----------------------------- FILE I/O OFFLOADING -----------------------------
+*/
+
+// One pool per process, shared by every reactor thread. Worker processes start their own after fork(), threads do
+// not survive it.
+void ServerManager::_startIoPool()
+{
+	if (_globalConfig.getIoThreads() == 0)
+		return;
+	_ioPool = new FileIoPool(_globalConfig.getIoThreads(), HTTP::FILE_IO_QUEUE_SIZE);
+	Logger::info("ServerManager: Started " + StrUtils::toString(_ioPool->getThreadCount()) + " file I/O threads",
+				 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// Before the reactors are torn down: jobs still queued go back cancelled to loops that still exist
+void ServerManager::_stopIoPool()
+{
+	if (_ioPool != NULL)
+		_ioPool->stop();
+}
+
+// A full queue or a pool that is not running: the handler runs here, as it did before the pool existed. The job
+// still comes back through the completion queue so the client resumes the same way.
+void ServerManager::_submitFileIo(FileIoPool::Job &job)
+{
+	job.completions = &_completions;
+	if (_ioPool != NULL && _ioPool->submit(&job))
+		return;
+	job.run();
+	_completions.push(&job);
+}
+
+// Each finished job goes back to its connection if that connection is still the one waiting for it, a job whose
+// connection closed meanwhile is dropped. Client slots never move, the pointer stays valid either way. A cancelled
+// job leaves its connection disconnected.
+void ServerManager::_completeFileIo()
+{
+	_completions.drainNotifications();
+	FileIoPool::Job *job = _completions.takeAll();
+	while (job != NULL)
+	{
+		FileIoPool::Job *next = job->next;
+		Client &client = *job->client;
+		if (client.completeFileIo(*job, _now))
+			_settleClient(client);
+		else
+			delete job;
+		job = next;
+	}
+}
+
+// Same idea as an accept backlog: a client that used up its recv, request or send budget still has work that no
+// edge will announce again. It goes on the ready list and is resumed on the next loop turn, after every other ready
+// connection had its turn, so a pipelining or bulk client cannot hold the loop while small requests wait.
+void ServerManager::_deferClient(Client &client)
+{
+	if (std::find(_readyClients.begin(), _readyClients.end(), &client) == _readyClients.end())
+		_readyClients.push_back(&client);
+}
+
+void ServerManager::_resumeClients()
+{
+	if (_readyClients.empty())
+		return;
+	std::vector<Client *> ready;
+	ready.swap(_readyClients);
+	epoll_event event;
+	for (std::vector<Client *>::iterator it = ready.begin(); it != ready.end(); ++it)
+	{
+		// An epoll event may have served the client since it yielded
+		event.events = (*it)->getYieldedEvents();
+		if (event.events == 0)
+			continue;
+		event.data.ptr = &(*it)->getEpollTag();
+		_handleClientEvent(**it, event);
+	}
+}
+
 void ServerManager::run()
 {
 	Logger::info("ServerManager: Starting server manager", __FILE__, __LINE__, __PRETTY_FUNCTION__);
@@ -150,42 +573,647 @@ void ServerManager::run()
 	if (_serverMap.empty())
 		throw std::runtime_error("ServerManager: No servers to run");
 	_serverMap.printServerMap();
-	// Add server file descriptors to epoll
-	_addServerFdsToEpoll(_serverMap);
 
-	// Set up signal handlers
-	signal(SIGINT, _handleSignal);
-	signal(SIGTERM, _handleSignal);
+	_raiseFileLimit();
+	if (_globalConfig.getWorkerProcesses() > 1)
+		return _runMaster();
+	_runEventLoop();
+	_serverMap.removeUnixSockets();
+}
+
+void ServerManager::_runEventLoop()
+{
+	// Before any reactor thread exists, so SIGHUP is blocked in every thread of the process
+	if (_role != REACTOR)
+	{
+		_setupReloadSignal();
+		_snapshot = new ConfigSnapshot(_serverMap, _globalConfig, ++_generation);
+		_connectionLimit = _resolveConnectionLimit();
+		Logger::info("ServerManager: Admitting up to " + StrUtils::toString(_connectionLimit) + " connections",
+					 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		_startIoPool();
+	}
+	if (_role == STANDALONE && _globalConfig.getWorkerThreads() > 1)
+		_startReactors();
+
+	if (_role == REACTOR)
+	{
+		_handoffTag = EpollTag(EpollTag::HANDOFF, _handoffQueue->getEventFd(), _handoffQueue);
+		_eventBackend->addFd(_handoffTag, EPOLLIN | EPOLLET);
+	}
+	else
+	{
+		// Add server file descriptors to epoll
+		_addServerFdsToEpoll(_serverMap);
+		_reserveFd = FileDescriptor::createFromOpen("/dev/null", O_RDONLY | O_CLOEXEC);
 
-	// Main event loop
+		// Set up signal handlers
+		signal(SIGINT, _handleSignal);
+		signal(SIGTERM, _handleSignal);
+	}
+	// Jobs this loop's clients hand to the file I/O pool come back through this eventfd
+	_completionTag = EpollTag(EpollTag::FILE_IO, _completions.getEventFd(), &_completions);
+	_eventBackend->addFd(_completionTag, EPOLLIN | EPOLLET);
+
+	Logger::info("ServerManager: Event loop running on the " + std::string(_eventBackend->getName()) + " backend",
+				 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+
+	// Main event loop: sleep until the next event or the next client deadline, whichever comes first
 	while (serverRunning)
 	{
-		std::vector<epoll_event> events(100);			   // Max 100 events per iteration
-		int ready_events = _epollManager.wait(events, 30); // 1 second timeout
+		_now = TimerWheel::monotonicMs();
+		int ready_events = _eventBackend->wait(_events, _pollTimeout());
+		_now = TimerWheel::monotonicMs();
+		_resumeAccepts();
+		_resumeClients();
 		if (ready_events > 0)
 		{
-			_handleEventLoop(ready_events, events);
+			_handleEventLoop(ready_events, _events);
+		}
+		_expireClients();
+		CgiExecutor::reapDetached();
+		_drainClients();
+	}
+
+	if (_role != REACTOR)
+		_stopIoPool();
+	if (_role == ACCEPTOR)
+	{
+		Logger::info("ServerManager: Shutting down, waiting for reactor threads", __FILE__, __LINE__,
+					 __PRETTY_FUNCTION__);
+		_stopReactors();
+	}
+	Logger::info("ServerManager: Server manager stopped", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+/*
+** ------------------------------- REACTOR THREADS --------------------------------
+*/
+
+// Spawns the reactor threads and turns this instance into the acceptor. Process wide tables are built here, once,
+// so the reactors only ever read them.
+void ServerManager::_startReactors()
+{
+	size_t threadCount = _globalConfig.getWorkerThreads();
+	_warmSharedCaches();
+
+	// Reactors inherit a fully blocked mask so shutdown signals are always delivered to the acceptor
+	sigset_t blockAll;
+	sigset_t previous;
+	sigfillset(&blockAll);
+	pthread_sigmask(SIG_BLOCK, &blockAll, &previous);
+	for (size_t i = 0; i < threadCount; ++i)
+	{
+		Reactor reactor;
+		reactor.queue = new ConnectionQueue(HTTP::DEFAULT_HANDOFF_QUEUE_SIZE);
+		reactor.manager = new ServerManager(*reactor.queue, _globalConfig, _ioPool);
+		int error = pthread_create(&reactor.thread, NULL, _reactorRoutine, reactor.manager);
+		if (error != 0)
+		{
+			Logger::error("ServerManager: Failed to start reactor thread " + StrUtils::toString(i) + ": " +
+							  std::string(strerror(error)),
+						  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+			delete reactor.manager;
+			delete reactor.queue;
+			break;
 		}
-		std::vector<int> timedOutClients;
-		for (std::map<int, Client>::iterator it = _clients.begin(); it != _clients.end(); ++it)
+		_reactors.push_back(reactor);
+	}
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	if (_reactors.empty())
+		return Logger::warning("ServerManager: No reactor threads started, serving connections from the acceptor",
+							   __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	_role = ACCEPTOR;
+	Logger::info("ServerManager: Started " + StrUtils::toString(_reactors.size()) + " reactor threads", __FILE__,
+				 __LINE__, __PRETTY_FUNCTION__);
+}
+
+// Reactors check serverRunning once per wakeup and may be sleeping with no deadline armed, kick each one awake
+void ServerManager::_stopReactors()
+{
+	for (std::vector<Reactor>::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+		it->queue->notify();
+	for (std::vector<Reactor>::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+	{
+		pthread_join(it->thread, NULL);
+		delete it->manager;
+		// Connections accepted after the reactor stopped never got a Client, close them here
+		ConnectionQueue::PendingConnection pending;
+		while (it->queue->pop(pending))
 		{
-			if (it->second.isTimedOut())
+			if (pending.fd != -1)
 			{
-				timedOutClients.push_back(it->first);
+				close(pending.fd);
+				_releaseConnection(*pending.listener);
 			}
+			pending.snapshot->release();
 		}
-		for (std::vector<int>::iterator it = timedOutClients.begin(); it != timedOutClients.end(); ++it)
+		delete it->queue;
+	}
+	_reactors.clear();
+	_role = STANDALONE;
+}
+
+// Round robin over the reactors, skipping any whose queue is full. The acceptor never waits on a reactor.
+void ServerManager::_dispatchConnection(FileDescriptor &clientFd, const SocketAddress &remoteAddress,
+										const ConfigSnapshot::Listener &listener)
+{
+	ConnectionQueue::PendingConnection pending;
+	pending.remoteAddress = remoteAddress;
+	pending.snapshot = _snapshot;
+	pending.listener = &listener;
+	pending.fd = clientFd.release();
+	_snapshot->retain();
+	for (size_t attempt = 0; attempt < _reactors.size(); ++attempt)
+	{
+		Reactor &reactor = _reactors[_nextReactor];
+		_nextReactor = (_nextReactor + 1) % _reactors.size();
+		if (reactor.queue->push(pending))
+			return reactor.queue->notify();
+	}
+	Logger::warning("ServerManager: All reactor queues are full, dropping connection from " +
+						remoteAddress.getHostString(),
+					__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	close(pending.fd);
+	_releaseConnection(listener);
+	_snapshot->release();
+}
+
+// Reactor side of the handoff: wraps every queued socket into a Client owned by this thread. The newest
+// configuration generation seen, from a reload notice or a connection, becomes the reactor's current one.
+void ServerManager::_acceptHandoffs()
+{
+	_handoffQueue->drainNotifications();
+	ConnectionQueue::PendingConnection pending;
+	while (_handoffQueue->pop(pending))
+	{
+		if (_snapshot == NULL || pending.snapshot->getGeneration() > _snapshot->getGeneration())
 		{
-			Logger::debug("ServerManager: Client timed out, removing from epoll and clients map", __FILE__, __LINE__,
-						  __PRETTY_FUNCTION__);
-			Logger::debug("ServerManager: Client fd: " + StrUtils::toString(*it), __FILE__, __LINE__,
-						  __PRETTY_FUNCTION__);
-			_epollManager.removeFd(*it);
-			_clients.erase(*it);
+			pending.snapshot->retain();
+			_adoptSnapshot(pending.snapshot);
 		}
+		if (pending.fd != -1)
+		{
+			_registerClient(FileDescriptor::createFromRaw(pending.fd), pending.remoteAddress, *pending.snapshot,
+							*pending.listener);
+			Logger::debug("ServerManager: Reactor took client " + pending.remoteAddress.getHostString() + ":" +
+							  pending.remoteAddress.getPortString(),
+						  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		}
+		pending.snapshot->release();
 	}
+}
 
-	Logger::info("ServerManager: Server manager stopped", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+// Lazily built lookup tables are shared by every reactor, build them before any thread can race on the first use
+void ServerManager::_warmSharedCaches()
+{
+	MimeTypeResolver::initialize();
+	MimeTypeResolver::getMagicRules();
+	DefaultStatusMap::getStatusMessage(200);
+	MethodHandlerFactory::isMethodSupported("GET");
+}
+
+void *ServerManager::_reactorRoutine(void *arg)
+{
+	ServerManager *reactor = static_cast<ServerManager *>(arg);
+	try
+	{
+		reactor->_runEventLoop();
+	}
+	catch (const std::exception &e)
+	{
+		Logger::error("ServerManager: Reactor thread stopped: " + std::string(e.what()), __FILE__, __LINE__,
+					  __PRETTY_FUNCTION__);
+	}
+	return NULL;
+}
+
+/*
+** ---------------------------- CONFIGURATION RELOAD ----------------------------
+*/
+
+// SIGHUP is blocked and read from a signalfd in the event set, so a reload runs between two events instead of
+// interrupting one. Blocking it also keeps its default action (terminate) away from every thread.
+void ServerManager::_setupReloadSignal()
+{
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGHUP);
+	pthread_sigmask(SIG_BLOCK, &mask, NULL);
+	_signalFd = FileDescriptor::createSignalFd(mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	_signalTag = EpollTag(EpollTag::SIGNAL, _signalFd.getFd(), NULL);
+	_eventBackend->addFd(_signalTag, EPOLLIN | EPOLLET);
+}
+
+// Several SIGHUPs queued before the loop got to them make a single reload
+void ServerManager::_handleSignalFd()
+{
+	bool reload = false;
+	struct signalfd_siginfo info;
+	while (true)
+	{
+		ssize_t bytesRead = read(_signalFd.getFd(), &info, sizeof(info));
+		if (bytesRead == static_cast<ssize_t>(sizeof(info)))
+			reload = reload || info.ssi_signo == SIGHUP;
+		else if (bytesRead == -1 && errno == EINTR)
+			continue;
+		else
+			break;
+	}
+	if (reload)
+		_reloadConfig();
+}
+
+// Runs the startup pipeline again on the configuration file. Throws on any error, the caller then keeps the
+// running configuration.
+void ServerManager::_parseConfig(std::vector<Server> &servers, GlobalConfig &globalConfig) const
+{
+	if (_configPath.empty())
+		throw std::runtime_error("No configuration file to reload");
+	ConfigFileReader reader(_configPath);
+	ConfigTokeniser tokenizer(reader);
+	ConfigParser parser(tokenizer);
+	AST::ASTNode cfg = parser.parse();
+	if (cfg.children.empty())
+		throw std::runtime_error("No server blocks found in config file");
+	ConfigTranslator translator(cfg);
+	servers = translator.getServers();
+	if (servers.empty())
+		throw std::runtime_error("No valid server blocks found in config file");
+	globalConfig = translator.getGlobalConfig();
+}
+
+// The process and thread layout is fixed at startup, say so instead of silently ignoring the change
+void ServerManager::_warnRestartOnly(const GlobalConfig &globalConfig) const
+{
+	if (globalConfig.getWorkerProcesses() != _globalConfig.getWorkerProcesses() ||
+		globalConfig.getWorkerThreads() != _globalConfig.getWorkerThreads() ||
+		globalConfig.getIoThreads() != _globalConfig.getIoThreads())
+		Logger::warning("ServerManager: worker_processes, worker_threads and io_threads changes need a restart, "
+						"keeping " +
+							StrUtils::toString(_globalConfig.getWorkerProcesses()) + " x " +
+							StrUtils::toString(_globalConfig.getWorkerThreads()) + " with " +
+							StrUtils::toString(_globalConfig.getIoThreads()) + " I/O threads",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// Global settings a running event loop can pick up: timeouts, accept pacing and the connection limit
+void ServerManager::_applyGlobalConfig(const GlobalConfig &globalConfig)
+{
+	_globalConfig.setWorkerConnections(globalConfig.getWorkerConnections());
+	_globalConfig.setClientHeaderTimeout(globalConfig.getClientHeaderTimeout());
+	_globalConfig.setClientBodyTimeout(globalConfig.getClientBodyTimeout());
+	_globalConfig.setSendTimeout(globalConfig.getSendTimeout());
+	_globalConfig.setKeepaliveTimeout(globalConfig.getKeepaliveTimeout());
+	_globalConfig.setReloadDrainTimeout(globalConfig.getReloadDrainTimeout());
+	_globalConfig.setAcceptBatch(globalConfig.getAcceptBatch());
+}
+
+// Builds the next generation next to the running one and switches to it only once it is complete. Listeners whose
+// address is unchanged are carried over with their accept queue, connections keep the generation they were
+// accepted under until their current request is done.
+void ServerManager::_reloadConfig()
+{
+	Logger::info("ServerManager: Reloading configuration from " + _configPath, __FILE__, __LINE__,
+				 __PRETTY_FUNCTION__);
+	ServerMap serverMap;
+	GlobalConfig globalConfig;
+	try
+	{
+		std::vector<Server> servers;
+		_parseConfig(servers, globalConfig);
+		// Worker processes own their sockets, new addresses are bound with SO_REUSEPORT like their siblings' are
+		bool worker = _globalConfig.getWorkerProcesses() > 1;
+		serverMap = ServerMap(servers, worker, &_serverMap);
+		if (worker)
+			serverMap.listenReserved();
+		if (serverMap.empty())
+			throw std::runtime_error("No listening socket could be opened");
+	}
+	catch (const std::exception &e)
+	{
+		return Logger::error("ServerManager: Configuration reload failed, keeping the running configuration: " +
+								 std::string(e.what()),
+							 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	_warnRestartOnly(globalConfig);
+	// Connections decide whether to offload from their snapshot, it has to describe the pool actually running
+	globalConfig.setIoThreads(_globalConfig.getIoThreads());
+	_removeListeners();
+	_serverMap = serverMap;
+	_adoptSnapshot(new ConfigSnapshot(_serverMap, globalConfig, ++_generation));
+	_connectionLimit = _resolveConnectionLimit();
+	_addServerFdsToEpoll(_serverMap);
+	if (_role == ACCEPTOR)
+		_publishSnapshot();
+	Logger::info("ServerManager: Configuration generation " + StrUtils::toString(_generation) + " is live with " +
+					 StrUtils::toString(_serverMap.getServerMap().size()) + " listeners",
+				 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// Master side of a reload: checks the new configuration, keeps its reserved sockets in step for workers it will
+// respawn and has every running worker reload on its own
+void ServerManager::_reloadMaster()
+{
+	try
+	{
+		std::vector<Server> servers;
+		GlobalConfig globalConfig;
+		_parseConfig(servers, globalConfig);
+		ServerMap serverMap(servers, true, &_serverMap);
+		if (serverMap.empty())
+			throw std::runtime_error("No listening socket could be opened");
+		_warnRestartOnly(globalConfig);
+		_serverMap = serverMap;
+		_applyGlobalConfig(globalConfig);
+	}
+	catch (const std::exception &e)
+	{
+		return Logger::error("ServerManager: Configuration reload failed, workers keep the running configuration: " +
+								 std::string(e.what()),
+							 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	}
+	for (std::vector<pid_t>::const_iterator it = _workerPids.begin(); it != _workerPids.end(); ++it)
+	{
+		if (*it > 0)
+			kill(*it, SIGHUP);
+	}
+	Logger::info("ServerManager: Configuration reloaded, workers signalled", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// Listener tags point into the current snapshot and are rebuilt with the next one, dropped sockets close when the
+// old map goes away
+void ServerManager::_removeListeners()
+{
+	for (std::vector<EpollTag>::const_iterator it = _listenerTags.begin(); it != _listenerTags.end(); ++it)
+		_eventBackend->removeFd(it->fd);
+	_listenerTags.clear();
+	_pendingAccepts.clear();
+}
+
+// Takes over one reference to snapshot. The previous generation gets its drain deadline, connections idle between
+// requests move to the new one right away and the others when their request is done.
+void ServerManager::_adoptSnapshot(ConfigSnapshot *snapshot)
+{
+	ConfigSnapshot *previous = _snapshot;
+	_snapshot = snapshot;
+	_applyGlobalConfig(snapshot->getGlobalConfig());
+	if (previous == NULL)
+		return;
+	Drain drain;
+	drain.generation = previous->getGeneration();
+	drain.deadline = _now + _globalConfig.getReloadDrainTimeout();
+	_drains.push_back(drain);
+	previous->release();
+	// Backwards: closing a client moves the last live entry into its place
+	for (size_t i = _clients.size(); i-- > 0;)
+	{
+		Client &client = _clients.at(i);
+		_rebindClient(client);
+		if (client.getCurrentState() == Client::DISCONNECTED)
+			_closeClient(client.getSocketFd());
+	}
+}
+
+// Reactors learn about a reload through their handoff queue. A full queue is not waited on: the connections
+// filling it carry the new generation and switch the reactor over just as well.
+void ServerManager::_publishSnapshot()
+{
+	for (std::vector<Reactor>::iterator it = _reactors.begin(); it != _reactors.end(); ++it)
+	{
+		ConnectionQueue::PendingConnection notice;
+		notice.snapshot = _snapshot;
+		_snapshot->retain();
+		if (it->queue->push(notice))
+			it->queue->notify();
+		else
+			_snapshot->release();
+	}
+}
+
+// Between requests a connection of an older generation switches to the current one. If its listening address is
+// gone from the configuration it is closed instead, as soon as nothing is left to send.
+void ServerManager::_rebindClient(Client &client)
+{
+	if (client.getSnapshot() == _snapshot || !client.isBetweenRequests())
+		return;
+	if (!client.rebind(*_snapshot) && client.getCurrentState() == Client::WAITING_FOR_EPOLLIN)
+		client.setState(Client::DISCONNECTED);
+}
+
+// Connections still on a generation past its drain deadline are closed, requests in flight included
+void ServerManager::_drainClients()
+{
+	if (_drains.empty() || _drains.front().deadline > _now)
+		return;
+	size_t generation = 0;
+	while (!_drains.empty() && _drains.front().deadline <= _now)
+	{
+		generation = _drains.front().generation;
+		_drains.pop_front();
+	}
+	for (size_t i = _clients.size(); i-- > 0;)
+	{
+		Client &client = _clients.at(i);
+		if (client.getSnapshot()->getGeneration() > generation)
+			continue;
+		Logger::warning("ServerManager: Client " + client.getRemoteAddr().getHostString() + ":" +
+							client.getRemoteAddr().getPortString() + " still on configuration generation " +
+							StrUtils::toString(client.getSnapshot()->getGeneration()) + " after the drain deadline",
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+		_closeClient(client.getSocketFd());
+	}
+}
+
+/*
+** ------------------------------- MASTER / WORKERS --------------------------------
+*/
+
+// The master never accepts: it forks the workers, waits on them and respawns any that die until shutdown
+void ServerManager::_runMaster()
+{
+	size_t workerCount = _globalConfig.getWorkerProcesses();
+	Logger::info("ServerManager: Master " + StrUtils::toString(getpid()) + " starting " +
+					 StrUtils::toString(workerCount) + " worker processes",
+				 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+
+	// No SA_RESTART so a shutdown signal interrupts the blocking read() below
+	struct sigaction action;
+	std::memset(&action, 0, sizeof(action));
+	action.sa_handler = _handleSignal;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	// Worker exits and reload requests arrive through a signalfd. Workers inherit SIGHUP blocked, one sent before
+	// their own signalfd exists stays pending for it.
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigaddset(&mask, SIGHUP);
+	sigprocmask(SIG_BLOCK, &mask, NULL);
+	_signalFd = FileDescriptor::createSignalFd(mask, SFD_CLOEXEC);
+
+	_workerPids.assign(workerCount, -1);
+	_workerStartTimes.assign(workerCount, 0);
+	for (size_t i = 0; i < workerCount && serverRunning; ++i)
+	{
+		if (_spawnWorker(i) == 0)
+			return _runWorker(i);
+	}
+
+	while (serverRunning)
+	{
+		struct signalfd_siginfo info;
+		if (read(_signalFd.getFd(), &info, sizeof(info)) != static_cast<ssize_t>(sizeof(info)))
+		{
+			if (errno == EINTR)
+				continue;
+			Logger::error("ServerManager: Failed to read master signals: " + std::string(strerror(errno)), __FILE__,
+						  __LINE__, __PRETTY_FUNCTION__);
+			break;
+		}
+		if (info.ssi_signo == SIGHUP)
+		{
+			_reloadMaster();
+			continue;
+		}
+		// SIGCHLD coalesces, reap every worker that exited
+		int status = 0;
+		pid_t pid = 0;
+		while (serverRunning && (pid = waitpid(-1, &status, WNOHANG)) > 0)
+		{
+			if (_superviseExit(pid, status))
+				return;
+		}
+		if (pid == -1 && errno == ECHILD)
+		{
+			Logger::error("ServerManager: No workers left to supervise", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+			break;
+		}
+	}
+	_stopWorkers();
+	_serverMap.removeUnixSockets();
+	Logger::info("ServerManager: Master stopped", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// Logs a worker exit and respawns its slot. Returns true in the respawned child, which has already run its loop.
+bool ServerManager::_superviseExit(pid_t pid, int status)
+{
+	std::vector<pid_t>::iterator slot = std::find(_workerPids.begin(), _workerPids.end(), pid);
+	if (slot == _workerPids.end())
+		return false;
+	size_t index = static_cast<size_t>(slot - _workerPids.begin());
+	*slot = -1;
+	if (WIFSIGNALED(status))
+		Logger::warning("ServerManager: Worker " + StrUtils::toString(index) + " (pid " + StrUtils::toString(pid) +
+							") killed by signal " + StrUtils::toString(WTERMSIG(status)),
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	else
+		Logger::warning("ServerManager: Worker " + StrUtils::toString(index) + " (pid " + StrUtils::toString(pid) +
+							") exited with status " + StrUtils::toString(WEXITSTATUS(status)),
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+	if (!serverRunning)
+		return false;
+	// Back off a worker that dies straight after starting so a broken config does not fork bomb the host
+	if (std::time(NULL) - _workerStartTimes[index] < HTTP::WORKER_RESPAWN_BACKOFF_SECONDS)
+		sleep(HTTP::WORKER_RESPAWN_BACKOFF_SECONDS);
+	if (!serverRunning || _spawnWorker(index) != 0)
+		return false;
+	_runWorker(index);
+	return true;
+}
+
+// Runs in the child after fork(): takes its own SO_REUSEPORT listeners and drives a private epoll loop
+void ServerManager::_runWorker(size_t index)
+{
+	_workerPids.clear();
+	_workerStartTimes.clear();
+	// Do not outlive the master if it is killed without a chance to stop us
+	prctl(PR_SET_PDEATHSIG, SIGTERM);
+	if (_globalConfig.hasCpuAffinity())
+		_pinWorker(index);
+	// SIGHUP stays blocked for the worker's own signalfd, SIGCHLD is the master's business
+	_signalFd = FileDescriptor();
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigprocmask(SIG_UNBLOCK, &mask, NULL);
+	// An epoll instance inherited across fork() is shared with the master and every sibling, start a private one
+	delete _eventBackend;
+	_eventBackend = EventBackend::create(_globalConfig.getEventBackend());
+	_serverMap.reopenListeners();
+	if (_serverMap.empty())
+		throw std::runtime_error("ServerManager: Worker " + StrUtils::toString(index) + " has no listening sockets");
+	Logger::info("ServerManager: Worker " + StrUtils::toString(index) + " (pid " + StrUtils::toString(getpid()) +
+					 ") ready",
+				 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	_runEventLoop();
+}
+
+// Returns 0 in the child, the worker pid in the master and -1 if fork failed
+pid_t ServerManager::_spawnWorker(size_t index)
+{
+	pid_t pid = fork();
+	if (pid == -1)
+	{
+		Logger::error("ServerManager: Failed to fork worker " + StrUtils::toString(index) + ": " +
+						  std::string(strerror(errno)),
+					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		return -1;
+	}
+	if (pid == 0)
+		return 0;
+	_workerPids[index] = pid;
+	_workerStartTimes[index] = std::time(NULL);
+	Logger::info("ServerManager: Spawned worker " + StrUtils::toString(index) + " (pid " + StrUtils::toString(pid) +
+					 ")",
+				 __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	return pid;
+}
+
+// auto pins worker N to cpu N modulo the online cpus, explicit masks are used in order and the last one repeats
+void ServerManager::_pinWorker(size_t index) const
+{
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	if (_globalConfig.isCpuAffinityAuto())
+	{
+		long onlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+		CPU_SET(index % static_cast<size_t>(onlineCpus > 0 ? onlineCpus : 1), &cpuSet);
+	}
+	else
+	{
+		const std::vector<std::string> &masks = _globalConfig.getCpuAffinityMasks();
+		const std::string &mask = masks[std::min(index, masks.size() - 1)];
+		for (size_t bit = 0; bit < mask.size(); ++bit)
+		{
+			if (mask[mask.size() - 1 - bit] == '1')
+				CPU_SET(bit, &cpuSet);
+		}
+	}
+	if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == -1)
+		Logger::warning("ServerManager: Failed to pin worker " + StrUtils::toString(index) + ": " +
+							std::string(strerror(errno)),
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+void ServerManager::_stopWorkers()
+{
+	for (std::vector<pid_t>::const_iterator it = _workerPids.begin(); it != _workerPids.end(); ++it)
+	{
+		if (*it > 0)
+			kill(*it, SIGTERM);
+	}
+	for (std::vector<pid_t>::iterator it = _workerPids.begin(); it != _workerPids.end(); ++it)
+	{
+		if (*it <= 0)
+			continue;
+		while (waitpid(*it, NULL, 0) == -1 && errno == EINTR)
+			;
+		*it = -1;
+	}
 }
 
 bool ServerManager::isServerRunning()
@@ -201,6 +1229,6 @@ void ServerManager::setServerRunning(bool shouldRun)
 void ServerManager::_handleSignal(int signal)
 {
 	(void)signal;
-	Logger::info("ServerManager: Received signal, shutting down gracefully", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+	// No logging here: the Logger mutex may already be held by the interrupted thread
 	serverRunning = false;
 }
@@ -0,0 +1,173 @@
+#include "../../includes/Core/TimerWheel.hpp"
+#include <climits>
+#include <time.h>
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+TimerWheel::TimerWheel(uint64_t nowMs) : _current(nowMs / TICK_MS), _count(0)
+{
+	for (unsigned int level = 0; level < LEVELS; ++level)
+	{
+		for (unsigned int slot = 0; slot < SLOTS; ++slot)
+		{
+			_slots[level][slot].prev = &_slots[level][slot];
+			_slots[level][slot].next = &_slots[level][slot];
+		}
+	}
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+// Leaves the owners' nodes marked as disarmed so a late cancel() is harmless
+TimerWheel::~TimerWheel()
+{
+	for (unsigned int level = 0; level < LEVELS; ++level)
+	{
+		for (unsigned int slot = 0; slot < SLOTS; ++slot)
+		{
+			Timer &head = _slots[level][slot];
+			while (head.next != &head)
+				_unlink(*head.next);
+		}
+	}
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+void TimerWheel::_unlink(Timer &timer)
+{
+	timer.prev->next = timer.next;
+	timer.next->prev = timer.prev;
+	timer.prev = NULL;
+	timer.next = NULL;
+}
+
+// Picks the lowest level whose span covers the distance to expiry, timers past the horizon park in the top level
+// and are re-placed every time they cascade
+void TimerWheel::_place(Timer &timer)
+{
+	uint64_t expiry = timer.expiry < _current ? _current : timer.expiry;
+	uint64_t delta = expiry - _current;
+	unsigned int level = 0;
+	while (level < LEVELS - 1 && delta >= (static_cast<uint64_t>(1) << (SLOT_BITS * (level + 1))))
+		++level;
+	uint64_t horizon = static_cast<uint64_t>(1) << (SLOT_BITS * LEVELS);
+	if (delta >= horizon)
+		expiry = _current + horizon - 1;
+	Timer &head = _slots[level][(expiry >> (SLOT_BITS * level)) & (SLOTS - 1)];
+	timer.prev = head.prev;
+	timer.next = &head;
+	head.prev->next = &timer;
+	head.prev = &timer;
+}
+
+void TimerWheel::_cascade(unsigned int level, unsigned int slot)
+{
+	Timer &head = _slots[level][slot];
+	while (head.next != &head)
+	{
+		Timer &timer = *head.next;
+		_unlink(timer);
+		_place(timer);
+	}
+}
+
+// Deadlines round up to the next tick, a timer never fires early
+void TimerWheel::schedule(Timer &timer, uint64_t deadlineMs)
+{
+	if (timer.isArmed())
+		_unlink(timer);
+	else
+		++_count;
+	uint64_t tick = (deadlineMs + TICK_MS - 1) / TICK_MS;
+	timer.expiry = tick > _current ? tick : _current + 1;
+	_place(timer);
+}
+
+void TimerWheel::cancel(Timer &timer)
+{
+	if (!timer.isArmed())
+		return;
+	_unlink(timer);
+	--_count;
+}
+
+// Turns the wheel up to nowMs and appends the owner of every expired timer, expired timers are disarmed
+void TimerWheel::advance(uint64_t nowMs, std::vector<void *> &expired)
+{
+	uint64_t target = nowMs / TICK_MS;
+	while (_current < target)
+	{
+		if (_count == 0)
+		{
+			_current = target;
+			break;
+		}
+		++_current;
+		for (unsigned int level = 1; level < LEVELS; ++level)
+		{
+			if ((_current & ((static_cast<uint64_t>(1) << (SLOT_BITS * level)) - 1)) != 0)
+				break;
+			_cascade(level, static_cast<unsigned int>((_current >> (SLOT_BITS * level)) & (SLOTS - 1)));
+		}
+		Timer &head = _slots[0][_current & (SLOTS - 1)];
+		while (head.next != &head)
+		{
+			Timer &timer = *head.next;
+			_unlink(timer);
+			--_count;
+			expired.push_back(timer.owner);
+		}
+	}
+}
+
+int TimerWheel::msUntilNext(uint64_t nowMs) const
+{
+	if (_count == 0)
+		return -1;
+	uint64_t next = 0;
+	for (uint64_t step = 1; step <= SLOTS && next == 0; ++step)
+	{
+		const Timer &head = _slots[0][(_current + step) & (SLOTS - 1)];
+		if (head.next != &head)
+			next = _current + step;
+	}
+	// Nothing due in the lowest level: wake up for the first cascade that has work
+	for (unsigned int level = 1; level < LEVELS && next == 0; ++level)
+	{
+		uint64_t base = _current >> (SLOT_BITS * level);
+		for (uint64_t step = 1; step <= SLOTS && next == 0; ++step)
+		{
+			const Timer &head = _slots[level][(base + step) & (SLOTS - 1)];
+			if (head.next != &head)
+				next = (base + step) << (SLOT_BITS * level);
+		}
+	}
+	uint64_t nextMs = next * TICK_MS;
+	if (nextMs <= nowMs)
+		return 0;
+	uint64_t wait = nextMs - nowMs;
+	return wait > static_cast<uint64_t>(INT_MAX) ? INT_MAX : static_cast<int>(wait);
+}
+
+/*
+** --------------------------------- ACCESSOR ---------------------------------
+*/
+
+size_t TimerWheel::size() const
+{
+	return _count;
+}
+
+uint64_t TimerWheel::monotonicMs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1000 + static_cast<uint64_t>(now.tv_nsec) / 1000000;
+}
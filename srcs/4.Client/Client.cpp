@@ -4,7 +4,10 @@
 #include "../../includes/HTTP/HTTP.hpp"
 #include "../../includes/HTTP/HttpRequest.hpp"
 #include "../../includes/HTTP/HttpResponse.hpp"
+#include <algorithm>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <sys/epoll.h>
 #include <sys/resource.h>
 #include <sys/socket.h>
@@ -26,20 +29,30 @@ Client::Client()
 	_request = HttpRequest();
 	_response = HttpResponse();
 	_responseBuffer = std::deque<HttpResponse>();
-	long pageSize = sysconf(_SC_PAGESIZE);
-	if (pageSize == -1)
-	{
-		// handle error: fallback, throw, or use a default
-		perror("sysconf");
-		pageSize = 4096; // safe default on most systems
-	}
-	_receiveBuffer = std::vector<char>(static_cast<size_t>(pageSize)); // Is about 4KB depending on the system
+	_receiveBuffer = RingBuffer(HTTP::DEFAULT_RECV_SIZE);
+	_recvSize = HTTP::DEFAULT_RECV_SIZE;
+	_shortReads = 0;
 	_potentialServers = NULL;
+	_snapshot = NULL;
+	_listener = NULL;
 	_state = WAITING_FOR_EPOLLIN;
-	_lastActivity = time(NULL);
+	_epollTag = EpollTag(EpollTag::CLIENT, _clientFd.getFd(), this);
+	_phase = HEADER_PHASE;
+	_phaseStart = TimerWheel::monotonicMs();
+	_lastProgress = _phaseStart;
+	_idle = false;
+	_progressed = false;
+	_phaseRestart = false;
+	_sendYielded = false;
+	_recvYielded = false;
+	_parseYielded = false;
+	_corked = false;
+	_now = 0;
+	_throttledUntil = 0;
+	_timer.owner = this;
 }
 
-Client::Client(const Client &src)
+Client::Client(const Client &src) : _snapshot(NULL), _listener(NULL)
 {
 	*this = src;
 }
@@ -53,16 +66,27 @@ Client::Client(FileDescriptor socketFd, SocketAddress remoteAddress)
 	_request.setRemoteAddress(&_remoteAddress);
 	_response = HttpResponse();
 	_responseBuffer = std::deque<HttpResponse>();
-	long pageSize = sysconf(_SC_PAGESIZE);
-	if (pageSize == -1)
-	{
-		perror("sysconf");
-		pageSize = 4096;
-	}
-	_receiveBuffer = std::vector<char>(static_cast<size_t>(pageSize));
+	_receiveBuffer = RingBuffer(HTTP::DEFAULT_RECV_SIZE);
+	_recvSize = HTTP::DEFAULT_RECV_SIZE;
+	_shortReads = 0;
 	_potentialServers = NULL;
+	_snapshot = NULL;
+	_listener = NULL;
 	_state = WAITING_FOR_EPOLLIN;
-	_lastActivity = time(NULL);
+	_epollTag = EpollTag(EpollTag::CLIENT, _clientFd.getFd(), this);
+	_phase = HEADER_PHASE;
+	_phaseStart = TimerWheel::monotonicMs();
+	_lastProgress = _phaseStart;
+	_idle = false;
+	_progressed = false;
+	_phaseRestart = false;
+	_sendYielded = false;
+	_recvYielded = false;
+	_parseYielded = false;
+	_corked = false;
+	_now = 0;
+	_throttledUntil = 0;
+	_timer.owner = this;
 }
 
 /*
@@ -71,6 +95,9 @@ Client::Client(FileDescriptor socketFd, SocketAddress remoteAddress)
 
 Client::~Client()
 {
+	_dropFileIoJobs();
+	if (_snapshot != NULL)
+		_snapshot->release();
 }
 
 /*
@@ -89,11 +116,33 @@ Client &Client::operator=(const Client &rhs)
 		_response = rhs._response;
 		_responseBuffer = rhs._responseBuffer;
 		_receiveBuffer = rhs._receiveBuffer;
-		_holdingBuffer = rhs._holdingBuffer;
+		_recvSize = rhs._recvSize;
+		_shortReads = rhs._shortReads;
 		_potentialServers = rhs._potentialServers;
+		if (rhs._snapshot != NULL)
+			rhs._snapshot->retain();
+		if (_snapshot != NULL)
+			_snapshot->release();
+		_snapshot = rhs._snapshot;
+		_listener = rhs._listener;
 		_state = rhs._state;
-		_lastActivity = rhs._lastActivity;
 		_keepAlive = rhs._keepAlive;
+		// Never copied: the tag and the timer node identify this instance to epoll and the timer wheel
+		_epollTag = EpollTag(EpollTag::CLIENT, _clientFd.getFd(), this);
+		_phase = rhs._phase;
+		_phaseStart = rhs._phaseStart;
+		_lastProgress = rhs._lastProgress;
+		_idle = rhs._idle;
+		_progressed = false;
+		_phaseRestart = false;
+		_sendYielded = false;
+		_recvYielded = false;
+		_parseYielded = false;
+		_corked = rhs._corked;
+		_now = rhs._now;
+		_throttledUntil = rhs._throttledUntil;
+		_timer.owner = this;
+		_ioJobs.clear(); // a job answers the connection that made it
 	}
 	return *this;
 }
@@ -102,8 +151,89 @@ Client &Client::operator=(const Client &rhs)
 ** --------------------------------- METHODS ----------------------------------
 */
 
-void Client::handleEvent(epoll_event event)
+// Binds a recycled slot to a freshly accepted socket
+void Client::attach(const FileDescriptor &socketFd, const SocketAddress &remoteAddress, ConfigSnapshot &snapshot,
+					const ConfigSnapshot::Listener &listener, uint64_t now)
+{
+	_clientFd = socketFd;
+	_remoteAddress = remoteAddress;
+	_request.setRemoteAddress(&_remoteAddress);
+	snapshot.retain();
+	_snapshot = &snapshot;
+	_listener = &listener;
+	_potentialServers = &listener.servers;
+	_state = WAITING_FOR_EPOLLIN;
+	_keepAlive = HTTP::DEFAULT_KEEP_ALIVE;
+	_epollTag = EpollTag(EpollTag::CLIENT, _clientFd.getFd(), this);
+	_phase = HEADER_PHASE; // the first request head is timed from accept
+	_phaseStart = now;
+	_lastProgress = now;
+	_idle = false;
+	_sendYielded = false;
+	_recvYielded = false;
+	_parseYielded = false;
+	_corked = false;
+	_now = 0;
+	_throttledUntil = 0;
+	if (listener.tcpNoDelay)
+		_clientFd.setNoDelay();
+}
+
+// Closes the socket and clears per connection state, buffers keep their capacity for the next connection
+void Client::reset()
+{
+	_clientFd = FileDescriptor();
+	_remoteAddress = SocketAddress();
+	_request.reset();
+	_response.reset();
+	_responseBuffer.clear();
+	_receiveBuffer.clear();
+	_receiveBuffer.shrink(HTTP::DEFAULT_RECV_SIZE);
+	_recvSize = HTTP::DEFAULT_RECV_SIZE;
+	_shortReads = 0;
+	_potentialServers = NULL;
+	if (_snapshot != NULL)
+		_snapshot->release();
+	_snapshot = NULL;
+	_listener = NULL;
+	_state = DISCONNECTED;
+	_keepAlive = HTTP::DEFAULT_KEEP_ALIVE;
+	_corked = false;
+	_dropFileIoJobs();
+	_epollTag = EpollTag(EpollTag::CLIENT, -1, this);
+}
+
+// No request is being parsed, so nothing of the connection points into its configuration (queued responses are
+// self-contained)
+bool Client::isBetweenRequests() const
+{
+	return _request.getPotentialServers() == NULL;
+}
+
+// Moves the connection, and the listener slot it holds, onto a newer configuration generation. Only valid between
+// requests. False when its listening address is not part of the new generation.
+bool Client::rebind(ConfigSnapshot &snapshot)
+{
+	const ConfigSnapshot::Listener *listener = snapshot.findListener(_listener->address);
+	if (listener == NULL)
+		return false;
+	listener->join();
+	_listener->leave();
+	snapshot.retain();
+	_snapshot->release();
+	_snapshot = &snapshot;
+	_listener = listener;
+	_potentialServers = &listener->servers;
+	return true;
+}
+
+void Client::handleEvent(epoll_event event, uint64_t now)
 {
+	_progressed = false;
+	_phaseRestart = false;
+	_sendYielded = false;
+	_throttledUntil = 0;
+	_now = now;
 	if (event.events & EPOLLIN)
 		_handleBuffer();
 	if (event.events & EPOLLOUT)
@@ -122,17 +252,119 @@ void Client::handleEvent(epoll_event event)
 					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 		_state = DISCONNECTED;
 	}
-	updateActivity(); // base last activity time off of when event handled
+	// Queued responses may have gone out meanwhile, the connection still waits for its jobs
+	if (!_ioJobs.empty() && _state != DISCONNECTED)
+		_state = WAITING_FOR_IO;
+	_updatePhase(now);
+}
+
+// A job came back from the pool. Responses move to the send queue only from the front, so they leave in request
+// order whatever order the jobs finish in. Once none is out the requests still buffered are parsed. False when the
+// job is not one of this connection's (it closed meanwhile), the caller then deletes it.
+bool Client::completeFileIo(FileIoPool::Job &job, uint64_t now)
+{
+	if (std::find(_ioJobs.begin(), _ioJobs.end(), &job) == _ioJobs.end())
+		return false;
+	_progressed = false;
+	_phaseRestart = true;
+	_sendYielded = false;
+	_throttledUntil = 0;
+	_now = now;
+	job.finished = true;
+	if (job.cancelled)
+	{
+		_state = DISCONNECTED;
+		return true;
+	}
+	while (!_ioJobs.empty() && _ioJobs.front()->finished)
+	{
+		_responseBuffer.push_back(_ioJobs.front()->response);
+		delete _ioJobs.front();
+		_ioJobs.pop_front();
+		_state = WAITING_FOR_EPOLLOUT;
+	}
+	if (_ioJobs.empty() && _request.getParseState() != HttpRequest::PARSING_ERROR)
+		_handleRequest();
+	if (_state != DISCONNECTED && !_responseBuffer.empty())
+		_handleResponseBuffer();
+	if (!_ioJobs.empty() && _state != DISCONNECTED)
+		_state = WAITING_FOR_IO;
+	_updatePhase(now);
+	return true;
+}
+
+// Doubles the read size when a read fills it, halves it after RECV_SHRINK_READS reads in a row used under a quarter
+void Client::_adaptRecvSize(size_t bytesRead)
+{
+	if (bytesRead >= _recvSize)
+	{
+		_recvSize = std::min(_recvSize * 2, HTTP::MAX_RECV_SIZE);
+		_shortReads = 0;
+	}
+	else if (bytesRead < _recvSize / 4 && _recvSize > HTTP::MIN_RECV_SIZE)
+	{
+		if (++_shortReads >= HTTP::RECV_SHRINK_READS)
+		{
+			_recvSize = std::max(_recvSize / 2, HTTP::MIN_RECV_SIZE);
+			_shortReads = 0;
+		}
+	}
+	else
+		_shortReads = 0;
 }
 
+// Derives the deadline phase from the connection state, a phase change restarts its clock
+void Client::_updatePhase(uint64_t now)
+{
+	TimerPhase phase = HEADER_PHASE;
+	if ((_state == WAITING_FOR_EPOLLOUT || _state == WAITING_FOR_IO) && _throttledUntil != 0)
+		phase = THROTTLE_PHASE;
+	else if (_state == WAITING_FOR_EPOLLOUT)
+		phase = SEND_PHASE;
+	else if (_state == WAITING_FOR_IO)
+		phase = IO_PHASE;
+	else if (_idle)
+		phase = KEEPALIVE_PHASE;
+	else if (_request.getParseState() == HttpRequest::PARSING_BODY)
+		phase = BODY_PHASE;
+	// Several requests can be read and answered within one event, each completion starts the phase over
+	if (phase != _phase || _phaseRestart)
+	{
+		_phase = phase;
+		_phaseStart = now;
+		_lastProgress = now;
+	}
+	else if (_progressed)
+		_lastProgress = now;
+}
+
+// Reads until EAGAIN or until the recv budget is used up, then parses. Requests left over by the request budget are
+// parsed before anything more is read, so a pipelining client cannot pile up an unbounded backlog in memory.
 void Client::_handleBuffer()
 {
-	while (true)
+	// Nothing is read while requests are out on the I/O pool, the last completion resumes parsing
+	if (!_ioJobs.empty())
+		return;
+	size_t budget = _snapshot->getGlobalConfig().getRecvBudget();
+	size_t bytesThisTurn = 0;
+	// Unread bytes stay in the socket until the backlog is parsed, the turn that parses it reads them
+	_recvYielded = _parseYielded;
+	while (!_recvYielded)
 	{
-		ssize_t bytesRead = recv(_clientFd.getFd(), &_receiveBuffer[0], _receiveBuffer.size(), 0);
+		if (bytesThisTurn >= budget)
+		{
+			_recvYielded = true; // The socket may hold more, no edge will announce it
+			break;
+		}
+		_receiveBuffer.prepare(_recvSize);
+		ssize_t bytesRead = recv(_clientFd.getFd(), _receiveBuffer.writePtr(), _recvSize, 0);
 		if (bytesRead > 0)
 		{
-			_holdingBuffer.insert(_holdingBuffer.end(), _receiveBuffer.begin(), _receiveBuffer.begin() + bytesRead);
+			_progressed = true;
+			_idle = false;
+			_receiveBuffer.commit(bytesRead);
+			_adaptRecvSize(bytesRead);
+			bytesThisTurn += bytesRead;
 		}
 		else if (bytesRead == 0)
 		{
@@ -142,38 +374,61 @@ void Client::_handleBuffer()
 			_state = DISCONNECTED;
 			return;
 		}
-		else // No idea if EGAIN or something else due to project restrictions just have to assume its EGAIN and process
-			 // as normal
-		{
+		else if (errno == EINTR)
+			continue;
+		else if (errno == EAGAIN || errno == EWOULDBLOCK) // Drained, the edge is consumed
 			break;
+		else
+		{
+			Logger::warning("Client: " + _remoteAddress.getHostString() + ":" + _remoteAddress.getPortString() +
+								" receive failed: " + std::string(strerror(errno)),
+							__FILE__, __LINE__, __PRETTY_FUNCTION__);
+			_state = DISCONNECTED;
+			return;
 		}
 	}
 	// Parse the request
 	_handleRequest();
+	// A large upload can leave a big allocation behind, it goes once everything in it is parsed
+	_receiveBuffer.shrink(2 * HTTP::MAX_RECV_SIZE);
+	// Write first: send completed responses right away, EPOLLOUT is only armed if the socket would block
+	if (_state == WAITING_FOR_EPOLLOUT || (_state == WAITING_FOR_IO && !_responseBuffer.empty()))
+		_handleResponseBuffer();
 }
 
 void Client::_handleRequest()
 {
-	while (!_holdingBuffer.empty())
+	size_t budget = _snapshot->getGlobalConfig().getRequestBudget();
+	size_t parsed = 0;
+	_parseYielded = false;
+	// A request held back until the jobs ahead of it were done goes first
+	if (_request.getParseState() == HttpRequest::PARSING_COMPLETE)
+	{
+		if (!_dispatchRequest())
+			return;
+		++parsed;
+	}
+	while (!_receiveBuffer.empty())
 	{
+		if (parsed >= budget)
+		{
+			_parseYielded = true;
+			return;
+		}
 		// Set/refresh current potential servers if not set for the request yet
 		if (_request.getPotentialServers() == NULL)
 			_request.setPotentialServers(_potentialServers);
-		HttpRequest::ParseState parseState = _request.parseBuffer(_holdingBuffer, _response);
+		HttpRequest::ParseState parseState = _request.parseBuffer(_receiveBuffer, _response);
 		switch (parseState)
 		{
 		case HttpRequest::PARSING_COMPLETE:
-			_routeRequest();
-			_responseBuffer.push_back(_response);
-			_response.reset();
-			_request.reset();
-			// Set state to waiting for epollout here as we know we have responses ready
-			_state = WAITING_FOR_EPOLLOUT;
+			++parsed;
+			if (!_dispatchRequest())
+				return;
 			break;
 		case HttpRequest::PARSING_ERROR:
 			// Any errors here are considered fatal and denote an immediate disconnect
-			_responseBuffer.push_back(_response);
-			_state = WAITING_FOR_EPOLLOUT;
+			_queueResponse(_response);
 			return;
 		case HttpRequest::PARSING_URI:
 		case HttpRequest::PARSING_HEADERS:
@@ -186,6 +441,50 @@ void Client::_handleRequest()
 	}
 }
 
+// Answers the complete request in _request, on the loop or through a job for the I/O pool. Only GETs go out side by
+// side: a request that changes files waits until every job ahead of it is back, and nothing is parsed past it until
+// it is answered, so a pipelined PUT or DELETE never races a GET of the same file. False when parsing stops here.
+bool Client::_dispatchRequest()
+{
+	bool readOnly = _request.getMethod() == "GET";
+	if (!_ioJobs.empty() && !readOnly)
+	{
+		_state = WAITING_FOR_IO;
+		return false;
+	}
+	size_t pending = _ioJobs.size();
+	_routeRequest();
+	_phaseRestart = true;
+	bool offloaded = _ioJobs.size() > pending;
+	if (offloaded)
+		_limitResponseRate(_ioJobs.back()->request, _ioJobs.back()->response);
+	else
+	{
+		_limitResponseRate(_request, _response);
+		_queueResponse(_response);
+	}
+	_response.reset();
+	_request.reset();
+	if (offloaded)
+		_state = WAITING_FOR_IO;
+	return !offloaded || readOnly;
+}
+
+// Straight to the send queue, unless jobs are out: then it waits behind them as an already finished job
+void Client::_queueResponse(const HttpResponse &response)
+{
+	if (_ioJobs.empty())
+	{
+		_responseBuffer.push_back(response);
+		_state = WAITING_FOR_EPOLLOUT;
+		return;
+	}
+	FileIoPool::Job *ready = new FileIoPool::Job(NULL, HttpRequest(), response, *_snapshot, *this);
+	ready->finished = true;
+	_ioJobs.push_back(ready);
+	_state = WAITING_FOR_IO;
+}
+
 void Client::_routeRequest()
 {
 	// change keep alive setting depending on found server
@@ -198,8 +497,9 @@ void Client::_routeRequest()
 	{
 		location = _request.getSelectedServer()->getLocation(_request.getUri());
 		_request.setSelectedLocation(location);
-		Logger::debug("Client: Matched location: " + location->getPath() + " for URI: " + _request.getUri(), __FILE__,
-					  __LINE__, __PRETTY_FUNCTION__);
+		if (location)
+			Logger::debug("Client: Matched location: " + location->getPath() + " for URI: " + _request.getUri(),
+						  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 	}
 	catch (const std::exception &e)
 	{
@@ -243,7 +543,14 @@ void Client::_routeRequest()
 
 	// Use method handlers
 	IMethodHandler *handler = MethodHandlerFactory::createHandler(_request.getMethod());
-	if (handler)
+	if (handler && _snapshot->getGlobalConfig().getIoThreads() != 0 && handler->canOffload(_request, location))
+	{
+		// Handled on the file I/O pool, the server manager submits the job once this event is done
+		Logger::debug("Client: Offloading " + _request.getMethod() + " " + _request.getUri() + " to the I/O pool",
+					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		_ioJobs.push_back(new FileIoPool::Job(handler, _request, _response, *_snapshot, *this));
+	}
+	else if (handler)
 	{
 		Logger::debug("Client: Created handler for method: " + _request.getMethod(), __FILE__, __LINE__,
 					  __PRETTY_FUNCTION__);
@@ -259,15 +566,41 @@ void Client::_routeRequest()
 	}
 }
 
-// Write up to 4096 worth of response to the client each time this is called
-// Highlevel consideration is to flush the response buffer so EPOLLOUT takes priority over EPOLLIN
+// A job still out on the pool is dropped by the loop when it returns, the others have no other owner
+void Client::_dropFileIoJobs()
+{
+	for (std::deque<FileIoPool::Job *>::iterator it = _ioJobs.begin(); it != _ioJobs.end(); ++it)
+		if ((*it)->completions == NULL || (*it)->finished)
+			delete *it;
+	_ioJobs.clear();
+}
+
+// limit_rate of the matched location, else of the server
+void Client::_limitResponseRate(const HttpRequest &request, HttpResponse &response)
+{
+	const Server *server = request.getSelectedServer();
+	if (server == NULL)
+		return;
+	const Location *location = request.getSelectedLocation();
+	size_t rate = location != NULL && location->hasLimitRate() ? location->getLimitRate() : server->getLimitRate();
+	size_t after = location != NULL && location->hasLimitRateAfter() ? location->getLimitRateAfter()
+																	  : server->getLimitRateAfter();
+	if (rate != 0)
+		response.setRateLimit(rate, after);
+}
+
+// Flushes queued responses until the queue is empty or the socket would block. Under edge triggered epoll no
+// further EPOLLOUT arrives until the kernel buffer fills, so stopping early would stall the connection.
 void Client::_handleResponseBuffer()
 {
 	Logger::debug("Client: Handling response buffer for client: " + _remoteAddress.getHostString() + ":" +
 					  _remoteAddress.getPortString(),
 				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
-	errno = 0;
 	ssize_t totalBytesSent = 0;
+	size_t budget = _snapshot->getGlobalConfig().getSendBudget();
+	// Nothing queued is expected while the next response is still on the I/O pool
+	if (_responseBuffer.empty() && !_ioJobs.empty())
+		return;
 	// SafeGuard should never occur
 	if (_responseBuffer.empty())
 	{
@@ -277,33 +610,57 @@ void Client::_handleResponseBuffer()
 		_state = WAITING_FOR_EPOLLIN;
 		return;
 	}
-	HttpResponse &response = _responseBuffer.front();
-	while (totalBytesSent < HTTP::DEFAULT_SEND_SIZE && !_responseBuffer.empty())
+	// Pipelined responses leave in one write, what remains (file bodies, budget) goes through the loop below
+	if (_responseBuffer.size() > 1 && _keepAlive && !_sendCoalesced(totalBytesSent, budget))
+		return;
+	while (!_responseBuffer.empty())
 	{
-		response.sendResponse(_clientFd, totalBytesSent);
+		HttpResponse &response = _responseBuffer.front();
+		// A file body would otherwise leave its head alone in a short segment
+		if (_listener->tcpNoPush && !_corked && response.isStreamed())
+			_corked = _clientFd.setCork();
+		// A rate limited response gets what its bucket holds, an empty bucket parks the connection on its timer
+		size_t limit = budget;
+		if (response.isRateLimited())
+		{
+			size_t allowance = response.rateAllowance(_now);
+			if (allowance == 0)
+			{
+				_state = WAITING_FOR_EPOLLOUT;
+				_throttledUntil = response.getRateResumeAt();
+				return;
+			}
+			limit = std::min(budget, static_cast<size_t>(totalBytesSent) + allowance);
+		}
+		ssize_t sentBefore = totalBytesSent;
+		errno = 0;
+		response.sendResponse(_clientFd, totalBytesSent, limit);
+		if (response.isRateLimited())
+			response.chargeRate(static_cast<size_t>(totalBytesSent - sentBefore));
+		if (totalBytesSent > 0)
+			_progressed = true;
 		switch (response.getSendingState())
 		{
 		case HttpResponse::RESPONSE_SENDING_COMPLETE:
 		{
-			switch (response.getResponseType())
+			// Flush the tail of the body now rather than after the cork's 200ms ceiling
+			if (_corked)
+				_corked = !_clientFd.unsetCork();
+			if (response.closesConnection())
 			{
-			case HttpResponse::SUCCESS:
-			case HttpResponse::ERROR:
-				_responseBuffer.pop_front();  // Clear response from buffer when its done
-				if (!_responseBuffer.empty()) // If the response buffer is not empty set the next response to send
-				{
-					response = _responseBuffer.front();
-					_state = WAITING_FOR_EPOLLOUT;
-				}
-				else
-					_state = WAITING_FOR_EPOLLIN; // else ready to continue processing data
-				if (!_keepAlive)
-					_state = DISCONNECTED; // If keep alive is false however then we disconnect the client
-				break;
-			case HttpResponse::FATAL_ERROR:
 				_state = DISCONNECTED;
 				return;
 			}
+			_responseBuffer.pop_front(); // Clear response from buffer when its done
+			_phaseRestart = true;
+			if (!_keepAlive)
+			{
+				_state = DISCONNECTED; // If keep alive is false however then we disconnect the client
+				return;
+			}
+			// Keep flushing if more responses are queued, else ready to continue processing data
+			_state = _responseBuffer.empty() ? WAITING_FOR_EPOLLIN : WAITING_FOR_EPOLLOUT;
+			_idle = _responseBuffer.empty() && _receiveBuffer.empty();
 			break;
 		}
 		case HttpResponse::RESPONSE_SENDING_ERROR: // Fatal error encountered sending the response immediately
@@ -314,23 +671,134 @@ void Client::_handleResponseBuffer()
 				__FILE__, __LINE__, __PRETTY_FUNCTION__);
 			_state = DISCONNECTED;
 			return;
+		case HttpResponse::RESPONSE_FORMATTING_MESSAGE:
 		case HttpResponse::RESPONSE_SENDING_MESSAGE:
 		case HttpResponse::RESPONSE_SENDING_BODY:
-		{
-			// In the middle of sending the response only ends here if 4096 bytes where reached
+			// Socket would block, resume on the next EPOLLOUT edge. Or the budget ran out first, then the server
+			// manager resumes the connection next turn since no edge is coming.
 			_state = WAITING_FOR_EPOLLOUT;
+			if (limit < budget && static_cast<size_t>(totalBytesSent) >= limit)
+				_throttledUntil = response.getRateResumeAt();
+			else
+				_sendYielded = static_cast<size_t>(totalBytesSent) >= budget;
+			return;
+		default:
+			return;
+		}
+	}
+}
+
+// Gathers the buffered part of every queued response into one sendmsg(), returns false when nothing more can be
+// sent this turn (socket full, connection done or failed)
+bool Client::_sendCoalesced(ssize_t &totalBytesSent, size_t budget)
+{
+	struct iovec iov[HTTP::MAX_COALESCED_IOV];
+	size_t count = 0;
+	size_t gathered = 0;
+	size_t responses = 0;
+	size_t allowance = budget - static_cast<size_t>(totalBytesSent);
+	for (std::deque<HttpResponse>::iterator it = _responseBuffer.begin();
+		 it != _responseBuffer.end() && allowance > 0 && count + HttpResponse::BUFFERED_IOV_COUNT <= HTTP::MAX_COALESCED_IOV;
+		 ++it)
+	{
+		// Its bucket decides how much of it may go, the send loop takes it from here
+		if (it->isRateLimited())
+			break;
+		it->formatMessage();
+		it->inlineBody(HTTP::COALESCED_INLINE_LIMIT);
+		size_t used = it->gatherBuffered(&iov[count], allowance);
+		if (used == 0)
 			break;
+		for (size_t i = count; i < count + used; ++i)
+		{
+			gathered += iov[i].iov_len;
+			allowance -= iov[i].iov_len;
 		}
-		default:
+		count += used;
+		++responses;
+		// A file body has to follow its own head, and nothing is sent past a response that ends the connection
+		if (it->isStreamed() || it->closesConnection())
 			break;
+	}
+	if (responses < 2)
+		return true;
+
+	struct msghdr message;
+	std::memset(&message, 0, sizeof(message));
+	message.msg_iov = iov;
+	message.msg_iovlen = count;
+	ssize_t bytesSent = sendmsg(_clientFd.getFd(), &message, MSG_NOSIGNAL);
+	if (bytesSent == -1)
+	{
+		if (errno == EINTR)
+			return true;
+		_state = WAITING_FOR_EPOLLOUT;
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return false;
+		Logger::error("Client: Fatal error encountered while sending responses for client: " +
+						  _remoteAddress.getHostString() + ":" + _remoteAddress.getPortString() + ": " +
+						  strerror(errno),
+					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		_state = DISCONNECTED;
+		return false;
+	}
+	_progressed = true;
+	totalBytesSent += bytesSent;
+
+	// Hand the written bytes back to the responses in order, dropping the ones that are done
+	size_t left = static_cast<size_t>(bytesSent);
+	while (left > 0 && !_responseBuffer.empty())
+	{
+		HttpResponse &response = _responseBuffer.front();
+		size_t taken = std::min(left, response.bufferedRemaining());
+		response.consumeBuffered(taken);
+		left -= taken;
+		if (response.getSendingState() != HttpResponse::RESPONSE_SENDING_COMPLETE)
+			break;
+		if (response.closesConnection())
+		{
+			_state = DISCONNECTED;
+			return false;
 		}
+		_responseBuffer.pop_front();
+		_phaseRestart = true;
+	}
+	if (_responseBuffer.empty())
+	{
+		_state = WAITING_FOR_EPOLLIN;
+		_idle = _receiveBuffer.empty();
+		return false;
 	}
+	_state = WAITING_FOR_EPOLLOUT;
+	// A short write means the socket buffer is full, the next EPOLLOUT edge resumes
+	return static_cast<size_t>(bytesSent) == gathered;
 }
 
 /*
 ** --------------------------------- ACCESSORS --------------------------------
 */
 
+// Events the connection still has work for although epoll will not report them again: the server manager resumes
+// it with these on the next loop turn
+uint32_t Client::getYieldedEvents() const
+{
+	if ((_state == WAITING_FOR_EPOLLOUT || _state == WAITING_FOR_IO) && _sendYielded)
+		return EPOLLOUT;
+	if (_state == WAITING_FOR_EPOLLIN && (_recvYielded || _parseYielded))
+		return EPOLLIN;
+	return 0;
+}
+
+const std::deque<FileIoPool::Job *> &Client::getFileIoJobs() const
+{
+	return _ioJobs;
+}
+
+bool Client::hasQueuedResponses() const
+{
+	return !_responseBuffer.empty();
+}
+
 Client::ClientState Client::getCurrentState() const
 {
 	return _state;
@@ -341,14 +809,39 @@ void Client::setState(ClientState newState)
 	_state = newState;
 }
 
-void Client::updateActivity()
+int Client::getSocketFd() const
+{
+	return _clientFd.getFd();
+}
+
+EpollTag &Client::getEpollTag()
 {
-	_lastActivity = time(NULL);
+	return _epollTag;
 }
 
-int Client::getSocketFd() const
+TimerWheel::Timer &Client::getTimer()
 {
-	return _clientFd.getFd();
+	return _timer;
+}
+
+Client::TimerPhase Client::getTimerPhase() const
+{
+	return _phase;
+}
+
+uint64_t Client::getPhaseStart() const
+{
+	return _phaseStart;
+}
+
+uint64_t Client::getThrottledUntil() const
+{
+	return _throttledUntil;
+}
+
+uint64_t Client::getLastProgress() const
+{
+	return _lastProgress;
 }
 
 const SocketAddress &Client::getRemoteAddr() const
@@ -361,13 +854,18 @@ const std::vector<Server> &Client::getPotentialServers() const
 	return *_potentialServers;
 }
 
-void Client::setPotentialServers(const std::vector<Server> &potentialServers)
+ConfigSnapshot *Client::getSnapshot() const
 {
-	_potentialServers = &potentialServers;
+	return _snapshot;
+}
+
+const ConfigSnapshot::Listener *Client::getListener() const
+{
+	return _listener;
 }
 
-bool Client::isTimedOut() const
+void Client::setPotentialServers(const std::vector<Server> &potentialServers)
 {
-	time_t currentTime = time(NULL);
-	return (currentTime - _lastActivity) > 30; // 30 second timeout
+	_potentialServers = &potentialServers;
 }
+
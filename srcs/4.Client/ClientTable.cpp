@@ -0,0 +1,106 @@
+#include "../../includes/Core/ClientTable.hpp"
+#include "../../includes/Global/Logger.hpp"
+#include "../../includes/Global/StrUtils.hpp"
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+ClientTable::ClientTable(size_t preallocated)
+{
+	_grow(preallocated);
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+ClientTable::~ClientTable()
+{
+	for (std::vector<Client *>::iterator it = _slots.begin(); it != _slots.end(); ++it)
+		delete *it;
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+void ClientTable::_grow(size_t count)
+{
+	_slots.reserve(_slots.size() + count);
+	_free.reserve(_free.size() + count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		_slots.push_back(new Client());
+		_free.push_back(_slots.back());
+	}
+}
+
+// Takes a free slot (allocating more when the slab is exhausted) and binds it to the socket
+Client *ClientTable::acquire(const FileDescriptor &socketFd, const SocketAddress &remoteAddress,
+							 ConfigSnapshot &snapshot, const ConfigSnapshot::Listener &listener, uint64_t now)
+{
+	int fd = socketFd.getFd();
+	if (fd < 0)
+		return NULL;
+	size_t index = static_cast<size_t>(fd);
+	if (index < _byFd.size() && _byFd[index] != NULL)
+	{
+		Logger::warning("ClientTable: fd " + StrUtils::toString(fd) + " is still live, recycling its slot", __FILE__,
+						__LINE__, __PRETTY_FUNCTION__);
+		release(fd);
+	}
+	if (_free.empty())
+		_grow(_slots.empty() ? 1 : _slots.size()); // double the slab
+	if (index >= _byFd.size())
+	{
+		_byFd.resize(index + 1, NULL);
+		_livePosition.resize(index + 1, 0);
+	}
+
+	Client *client = _free.back();
+	_free.pop_back();
+	client->attach(socketFd, remoteAddress, snapshot, listener, now);
+	_byFd[index] = client;
+	_livePosition[index] = _live.size();
+	_live.push_back(client);
+	return client;
+}
+
+// Closes the connection and returns its slot to the free list, buffers keep their capacity for the next user
+void ClientTable::release(int fd)
+{
+	Client *client = find(fd);
+	if (client == NULL)
+		return;
+	size_t index = static_cast<size_t>(fd);
+	size_t position = _livePosition[index];
+	Client *last = _live.back();
+	_live[position] = last;
+	_livePosition[static_cast<size_t>(last->getSocketFd())] = position;
+	_live.pop_back();
+	_byFd[index] = NULL;
+	client->reset();
+	_free.push_back(client);
+}
+
+Client *ClientTable::find(int fd) const
+{
+	if (fd < 0 || static_cast<size_t>(fd) >= _byFd.size())
+		return NULL;
+	return _byFd[static_cast<size_t>(fd)];
+}
+
+/*
+** --------------------------------- ACCESSOR ---------------------------------
+*/
+
+size_t ClientTable::size() const
+{
+	return _live.size();
+}
+
+Client &ClientTable::at(size_t index) const
+{
+	return *_live[index];
+}
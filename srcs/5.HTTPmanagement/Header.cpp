@@ -1,6 +1,7 @@
 #include "../../includes/HTTP/Header.hpp"
 #include "../../includes/Global/StrUtils.hpp"
 #include <cstddef>
+#include <cstring>
 
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
@@ -48,50 +49,21 @@ Header::~Header()
 void Header::_parseRawHeader()
 {
 	// Break down the raw header into directive, values, and parameters
+	const char *error = check(_rawHeader.data(), _rawHeader.size());
+	if (error != NULL)
+		throw std::invalid_argument(error);
 
-	if (_rawHeader.empty())
-		throw std::invalid_argument("Empty raw header");
-	// Directive extraction and validation and normalization
+	// Directive normalization
 	size_t colonPos = _rawHeader.find(':');
-	if (colonPos == std::string::npos)
-		throw std::invalid_argument("No colon found in raw header");
-	_directive = _rawHeader.substr(0, colonPos);
-	if (!StrUtils::isValidToken(_directive))
-		throw std::invalid_argument("Directive is not a valid token");
-	_directive = StrUtils::toLowerCase(_directive);
-
-	// Extract raw values by iterating through till first ; or end of string
-	size_t valuesStart = colonPos + 1;
-	size_t valuesEnd = std::string::npos;
-	bool inComment = false;
-	for (std::string::iterator it = _rawHeader.begin(); it != _rawHeader.end(); ++it)
-	{
-		if (*it == '(')
-			inComment = true;
-		else if (*it == ')')
-			inComment = false;
-		else if (*it == ';' && !inComment)
-		{
-			valuesEnd = it - _rawHeader.begin();
-			break;
-		}
-	}
-	bool hasParameters = true;
-	if (valuesEnd == std::string::npos)
-	{
-		valuesEnd = _rawHeader.length();
-		hasParameters = false;
-	}
+	_directive = StrUtils::toLowerCase(_rawHeader.substr(0, colonPos));
 
+	// Extract raw values up to the first ; outside a comment
+	size_t valuesStart = colonPos + 1;
+	size_t valuesEnd = findParameters(_rawHeader.data(), valuesStart, _rawHeader.length());
 	std::string rawValues = _rawHeader.substr(valuesStart, valuesEnd - valuesStart);
-	if (rawValues.empty())
-		throw std::invalid_argument("Empty values");
 	_values = StrUtils::splitString(rawValues, ',');
 	for (size_t i = 0; i < _values.size(); i++)
 	{
-		// Verify that value is not empty
-		if (_values[i].empty())
-			throw std::invalid_argument("Empty value");
 		// Trim token of any intial valid whitespace
 		_values[i] = StrUtils::trimLeadingSpaces(_values[i]);
 		// Header values can contain spaces and other characters, so we don't validate them as tokens
@@ -99,50 +71,114 @@ void Header::_parseRawHeader()
 		// _values[i] = StrUtils::toLowerCase(_values[i]);
 	}
 
-	if (hasParameters)
+	if (valuesEnd < _rawHeader.length())
 	{
 		// Extract parameters by iterating through till end of string
-		size_t parametersStart = valuesEnd + 1;
-		size_t parametersEnd = _rawHeader.length();
-		std::string rawParameters = _rawHeader.substr(parametersStart, parametersEnd - parametersStart);
-		if (rawParameters.empty())
-			throw std::invalid_argument("Empty parameters");
-		std::vector<std::string> parameters = StrUtils::splitString(rawParameters, ';');
+		std::vector<std::string> parameters = StrUtils::splitString(_rawHeader.substr(valuesEnd + 1), ';');
 		for (size_t i = 0; i < parameters.size(); i++)
 		{
-			if (parameters[i].empty())
-				throw std::invalid_argument("Empty parameter");
 			parameters[i] = StrUtils::trimLeadingSpaces(parameters[i]);
-
 			size_t equalSignPos = parameters[i].find('=');
-			if (equalSignPos == std::string::npos)
-				throw std::invalid_argument("No equal sign found in parameter");
-
-			std::string key = parameters[i].substr(0, equalSignPos);
-			if (!StrUtils::isValidToken(key))
-				throw std::invalid_argument("Parameter key is not a valid token");
-			key = StrUtils::toLowerCase(key);
-
+			std::string key = StrUtils::toLowerCase(parameters[i].substr(0, equalSignPos));
 			std::string value = parameters[i].substr(equalSignPos + 1);
-			if (value.empty())
-				throw std::invalid_argument("Empty parameter value");
 			// Loop through values to check if they are quoted
-			else if (value[0] == '\"' && value[value.length() - 1] == '\"')
+			if (value[0] == '\"' && value[value.length() - 1] == '\"')
 			{
 				// remove the quotes from the value
 				value = value.substr(1, value.length() - 2);
 				printf("Value after removing quotes: %s\n", value.c_str());
 				// decode the value
 				value = StrUtils::percentDecode(value);
-				// check if the value has control characters
-				if (StrUtils::hasControlCharacters(value))
-					throw std::invalid_argument("Parameter value has control characters");
 			}
 			_parameters.push_back(std::make_pair(key, value));
 		}
 	}
 }
 
+// Offset of the ; that starts the parameters of a header line, ignoring any inside a (comment). End when there are
+// none.
+size_t Header::findParameters(const char *line, size_t from, size_t length)
+{
+	bool inComment = false;
+	for (size_t i = from; i < length; ++i)
+	{
+		if (line[i] == '(')
+			inComment = true;
+		else if (line[i] == ')')
+			inComment = false;
+		else if (line[i] == ';' && !inComment)
+			return i;
+	}
+	return length;
+}
+
+// The request parser validates every line with this and only builds Header objects for the lines a caller asks for
+const char *Header::check(const char *line, size_t length)
+{
+	if (length == 0)
+		return "Empty raw header";
+	// Directive validation
+	const char *colon = static_cast<const char *>(std::memchr(line, ':', length));
+	if (colon == NULL)
+		return "No colon found in raw header";
+	for (const char *it = line; it != colon; ++it)
+		if (!StrUtils::isValidTokenCharacter(*it))
+			return "Directive is not a valid token";
+
+	// Values: none of the comma separated ones may be empty
+	size_t valuesStart = colon - line + 1;
+	size_t valuesEnd = findParameters(line, valuesStart, length);
+	if (valuesEnd == valuesStart)
+		return "Empty values";
+	size_t start = valuesStart;
+	for (size_t i = valuesStart; i <= valuesEnd; ++i)
+	{
+		if (i < valuesEnd && line[i] != ',')
+			continue;
+		if (i == start)
+			return "Empty value";
+		start = i + 1;
+	}
+	if (valuesEnd == length)
+		return NULL;
+
+	// Parameters: key=value pairs separated by ;
+	if (valuesEnd + 1 == length)
+		return "Empty parameters";
+	start = valuesEnd + 1;
+	for (size_t i = start; i <= length; ++i)
+	{
+		if (i < length && line[i] != ';')
+			continue;
+		if (i == start)
+			return "Empty parameter";
+		size_t keyStart = start;
+		while (keyStart < i && (line[keyStart] == ' ' || line[keyStart] == '\t' || line[keyStart] == '\r' ||
+								line[keyStart] == '\n'))
+			++keyStart;
+		if (keyStart == i) // all whitespace is kept as is
+			keyStart = start;
+		const char *equalSign = static_cast<const char *>(std::memchr(line + keyStart, '=', i - keyStart));
+		if (equalSign == NULL)
+			return "No equal sign found in parameter";
+		for (const char *it = line + keyStart; it != equalSign; ++it)
+			if (!StrUtils::isValidTokenCharacter(*it))
+				return "Parameter key is not a valid token";
+		const char *value = equalSign + 1;
+		size_t valueLength = line + i - value;
+		if (valueLength == 0)
+			return "Empty parameter value";
+		if (value[0] == '"' && value[valueLength - 1] == '"')
+		{
+			std::string quoted = valueLength < 2 ? std::string() : std::string(value + 1, valueLength - 2);
+			if (StrUtils::hasControlCharacters(StrUtils::percentDecode(quoted)))
+				return "Parameter value has control characters";
+		}
+		start = i + 1;
+	}
+	return NULL;
+}
+
 /*
 ** --------------------------------- METHODS ----------------------------------
 */
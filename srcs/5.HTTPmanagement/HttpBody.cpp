@@ -59,10 +59,10 @@ HttpBody &HttpBody::operator=(HttpBody const &rhs)
 ** --------------------------------- METHODS ----------------------------------
 */
 
-void HttpBody::parseBuffer(std::vector<char> &buffer, HttpResponse &response)
+void HttpBody::parseBuffer(RingBuffer &buffer, HttpResponse &response)
 {
 	Logger::debug("HttpBody: parseBuffer called, body type: " + StrUtils::toString(_bodyType) +
-					  ", buffer size: " + StrUtils::toString(buffer.size()),
+					  ", buffer size: " + StrUtils::toString(buffer.readable()),
 				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 	if (_bodyType == BODY_TYPE_NO_BODY)
 	{
@@ -77,7 +77,7 @@ void HttpBody::parseBuffer(std::vector<char> &buffer, HttpResponse &response)
 		_bodyState = BODY_PARSING_ERROR;
 }
 
-HttpBody::BodyState HttpBody::_parseContentLengthBody(std::vector<char> &buffer, HttpResponse &response)
+HttpBody::BodyState HttpBody::_parseContentLengthBody(RingBuffer &buffer, HttpResponse &response)
 {
 	Logger::debug(
 		"HttpBody: parseContentLengthBody called, expected body size: " + StrUtils::toString(_expectedBodySize) +
@@ -93,9 +93,9 @@ HttpBody::BodyState HttpBody::_parseContentLengthBody(std::vector<char> &buffer,
 											HttpResponse::FATAL_ERROR);
 			return BODY_PARSING_ERROR;
 		}
-		ssize_t bytes_to_copy = std::min(bytes_needed, static_cast<ssize_t>(buffer.size()));
-		_rawBody.insert(_rawBody.end(), buffer.begin(), buffer.begin() + bytes_to_copy);
-		buffer.erase(buffer.begin(), buffer.begin() + bytes_to_copy);
+		ssize_t bytes_to_copy = std::min(bytes_needed, static_cast<ssize_t>(buffer.readable()));
+		_rawBody.insert(_rawBody.end(), buffer.data(), buffer.data() + bytes_to_copy);
+		buffer.consume(bytes_to_copy);
 		_rawBodySize += bytes_to_copy;
 		if (_rawBodySize > _expectedBodySize)
 		{
@@ -123,9 +123,9 @@ HttpBody::BodyState HttpBody::_parseContentLengthBody(std::vector<char> &buffer,
 		}
 		else
 		{
-			ssize_t bytes_to_copy = std::min(bytes_needed, static_cast<ssize_t>(buffer.size()));
-			_tempFile.append(buffer, buffer.begin(), buffer.begin() + bytes_to_copy);
-			buffer.erase(buffer.begin(), buffer.begin() + bytes_to_copy);
+			ssize_t bytes_to_copy = std::min(bytes_needed, static_cast<ssize_t>(buffer.readable()));
+			_tempFile.append(buffer.data(), bytes_to_copy);
+			buffer.consume(bytes_to_copy);
 			_rawBodySize += bytes_to_copy;
 		}
 	}
@@ -135,7 +135,7 @@ HttpBody::BodyState HttpBody::_parseContentLengthBody(std::vector<char> &buffer,
 		return BODY_PARSING;
 }
 
-HttpBody::BodyState HttpBody::_parseChunkedBody(std::vector<char> &buffer, HttpResponse &response)
+HttpBody::BodyState HttpBody::_parseChunkedBody(RingBuffer &buffer, HttpResponse &response)
 {
 	while (!buffer.empty())
 	{
@@ -145,12 +145,10 @@ HttpBody::BodyState HttpBody::_parseChunkedBody(std::vector<char> &buffer, HttpR
 		{
 			Logger::debug("HttpBody: Chunk size state", __FILE__, __LINE__, __PRETTY_FUNCTION__);
 			// Chunked size line validation
-			std::vector<char>::iterator it = std::search(buffer.begin(), buffer.end(), HTTP::CRLF, HTTP::CRLF + 2);
-			Logger::debug("HttpBody: Chunk size line search result: " + StrUtils::toString(it - buffer.begin()),
-						  __FILE__, __LINE__, __PRETTY_FUNCTION__);
-			if (it == buffer.end()) // If the CRLF is not found, we need more data
+			size_t lineEnd = buffer.search(HTTP::CRLF, 2);
+			if (lineEnd == RingBuffer::npos) // If the CRLF is not found, we need more data
 			{
-				if (buffer.size() > 18) // Limit hex number size to 16 characters (8 bytes) + 2 for \r\n
+				if (buffer.readable() > 18) // Limit hex number size to 16 characters (8 bytes) + 2 for \r\n
 				{
 					Logger::debug("Chunked transfer encoding size string exceeded limit", __FILE__, __LINE__,
 								  __PRETTY_FUNCTION__);
@@ -161,8 +159,8 @@ HttpBody::BodyState HttpBody::_parseChunkedBody(std::vector<char> &buffer, HttpR
 				return BODY_PARSING;
 			}
 			// Extract size line
-			std::string sizeLine(buffer.begin(), it);
-			buffer.erase(buffer.begin(), it + 2);
+			std::string sizeLine(buffer.data(), lineEnd);
+			buffer.consume(lineEnd + 2);
 			if (sizeLine.empty())
 			{
 				Logger::debug("Empty chunk size line", __FILE__, __LINE__, __PRETTY_FUNCTION__);
@@ -200,12 +198,11 @@ HttpBody::BodyState HttpBody::_parseChunkedBody(std::vector<char> &buffer, HttpR
 		case CHUNK_DATA: // Use a modified form of content length body parsing
 		{
 			// We search for the CRLF in the buffer to find the end of the chunk data
-			std::vector<char>::iterator extractableBytes =
-				std::search(buffer.begin(), buffer.end(), HTTP::CRLF, HTTP::CRLF + 2);
+			size_t extractableBytes = buffer.search(HTTP::CRLF, 2);
 			// If the CRLF is not found, we need more data
-			if (extractableBytes == buffer.end())
+			if (extractableBytes == RingBuffer::npos)
 			{
-				if (buffer.size() >
+				if (buffer.readable() >
 					static_cast<size_t>(_expectedBodySize)) // If the buffer size is greater than the expected body size
 															// a fatal error is returned
 				{
@@ -219,7 +216,7 @@ HttpBody::BodyState HttpBody::_parseChunkedBody(std::vector<char> &buffer, HttpR
 			}
 			if (!_isUsingTempFile)
 			{
-				_rawBody.insert(_rawBody.end(), buffer.begin(), extractableBytes);
+				_rawBody.insert(_rawBody.end(), buffer.data(), buffer.data() + extractableBytes);
 				if (_rawBodySize >= HTTP::DEFAULT_CLIENT_MAX_BODY_SIZE)
 				{
 					_isUsingTempFile = true;
@@ -229,19 +226,19 @@ HttpBody::BodyState HttpBody::_parseChunkedBody(std::vector<char> &buffer, HttpR
 			}
 			else
 			{
-				_tempFile.append(buffer, buffer.begin(), extractableBytes);
+				_tempFile.append(buffer.data(), extractableBytes);
 			}
-			buffer.erase(buffer.begin(), extractableBytes + 2); // Clear the buffer up to the CRLF
+			buffer.consume(extractableBytes + 2); // Clear the buffer up to the CRLF
 			_chunkState = CHUNK_SIZE;
 			break;
 		}
 		case CHUNK_TRAILERS: // TODO: Instead of discarding the trailers as a bonus we could parse them
 		{
-			std::vector<char>::iterator it = std::search(buffer.begin(), buffer.end(), HTTP::CRLF, HTTP::CRLF + 2);
-			_rawBodySize += it - buffer.begin();
-			if (it == buffer.end())
+			size_t lineEnd = buffer.search(HTTP::CRLF, 2);
+			_rawBodySize += lineEnd == RingBuffer::npos ? buffer.readable() : lineEnd;
+			if (lineEnd == RingBuffer::npos)
 			{
-				if (buffer.size() > HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE)
+				if (buffer.readable() > HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE)
 				{
 					Logger::debug("Chunked transfer encoding trailers line too long", __FILE__, __LINE__,
 								  __PRETTY_FUNCTION__);
@@ -251,13 +248,13 @@ HttpBody::BodyState HttpBody::_parseChunkedBody(std::vector<char> &buffer, HttpR
 				}
 				return BODY_PARSING;
 			}
-			else if (it == buffer.begin()) // If its /r/n then chunks are complete
+			else if (lineEnd == 0) // If its /r/n then chunks are complete
 			{
-				buffer.erase(buffer.begin(), it + 2);
+				buffer.consume(2);
 				_chunkState = CHUNK_COMPLETE;
 				return BODY_PARSING_COMPLETE;
 			}
-			else if (it - buffer.begin() > HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE)
+			else if (lineEnd > static_cast<size_t>(HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE))
 			{
 				Logger::debug("Chunked transfer encoding trailers line too long", __FILE__, __LINE__,
 							  __PRETTY_FUNCTION__);
@@ -265,7 +262,7 @@ HttpBody::BodyState HttpBody::_parseChunkedBody(std::vector<char> &buffer, HttpR
 												HttpResponse::FATAL_ERROR);
 				return BODY_PARSING_ERROR;
 			}
-			buffer.erase(buffer.begin(), it + 2); // Clear the buffer up to the CRLF
+			buffer.consume(lineEnd + 2); // Clear the buffer up to the CRLF
 			break;
 		}
 		case CHUNK_COMPLETE:
@@ -5,6 +5,44 @@
 #include "../../includes/HTTP/HttpResponse.hpp"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+
+namespace
+{
+bool namesEqual(const char *a, const char *b, size_t length)
+{
+	for (size_t i = 0; i < length; ++i)
+		if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+			return false;
+	return true;
+}
+
+// Next comma separated value of a header line, leading whitespace trimmed the way Header trims it. cursor starts
+// past the colon, end is where the parameters start. False past the last value.
+bool nextValue(const char *line, size_t end, size_t &cursor, const char *&value, size_t &length)
+{
+	if (cursor > end)
+		return false;
+	size_t stop = cursor;
+	while (stop < end && line[stop] != ',')
+		++stop;
+	size_t first = cursor;
+	while (first < stop &&
+		   (line[first] == ' ' || line[first] == '\t' || line[first] == '\r' || line[first] == '\n'))
+		++first;
+	if (first == stop) // all whitespace is kept as is
+		first = cursor;
+	value = line + first;
+	length = stop - first;
+	cursor = stop + 1;
+	return true;
+}
+
+bool valueEquals(const char *value, size_t length, const char *expected)
+{
+	return std::strlen(expected) == length && std::memcmp(value, expected, length) == 0;
+}
+} // namespace
 
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
@@ -14,7 +52,9 @@ HttpHeaders::HttpHeaders()
 {
 	_headersState = HEADERS_PARSING;
 	_headers = std::vector<Header>();
+	_headersBuilt = false;
 	_rawHeadersSize = 0;
+	std::fill(_known, _known + KnownHeaders::COUNT, -1);
 }
 
 HttpHeaders::HttpHeaders(HttpHeaders const &src)
@@ -39,7 +79,11 @@ HttpHeaders &HttpHeaders::operator=(HttpHeaders const &rhs)
 	if (this != &rhs)
 	{
 		_headersState = rhs._headersState;
+		_raw = rhs._raw;
+		_fields = rhs._fields;
+		std::copy(rhs._known, rhs._known + KnownHeaders::COUNT, _known);
 		_headers = rhs._headers;
+		_headersBuilt = rhs._headersBuilt;
 		_rawHeadersSize = rhs._rawHeadersSize;
 	}
 	return *this;
@@ -49,22 +93,22 @@ HttpHeaders &HttpHeaders::operator=(HttpHeaders const &rhs)
 ** --------------------------------- METHODS ----------------------------------
 */
 
-void HttpHeaders::parseBuffer(std::vector<char> &buffer, HttpResponse &response, HttpBody &body)
+// Each line is checked where it lies in the receive buffer and copied once into _raw, which keeps its capacity
+// across the requests of a connection. Only spans are recorded, Header objects are built on demand.
+void HttpHeaders::parseBuffer(RingBuffer &buffer, HttpResponse &response, HttpBody &body)
 {
-	Logger::debug("HttpHeaders: Parsing buffer, size: " + StrUtils::toString(buffer.size()), __FILE__, __LINE__,
+	Logger::debug("HttpHeaders: Parsing buffer, size: " + StrUtils::toString(buffer.readable()), __FILE__, __LINE__,
 				  __PRETTY_FUNCTION__);
-	std::string bufferStr(buffer.begin(), buffer.end());
-	Logger::debug("HttpHeaders: Buffer content: " + bufferStr, __FILE__, __LINE__, __PRETTY_FUNCTION__);
 
 	// Continue parsing headers until we find empty line or run out of data
 	while (_headersState == HEADERS_PARSING && !buffer.empty())
 	{
-		std::vector<char>::iterator it = std::search(buffer.begin(), buffer.end(), HTTP::CRLF, HTTP::CRLF + 2);
-		if (it == buffer.end())
+		size_t lineEnd = buffer.search(HTTP::CRLF, 2);
+		if (lineEnd == RingBuffer::npos)
 		{
 			Logger::debug("HttpHeaders: No CRLF found, waiting for more data", __FILE__, __LINE__, __PRETTY_FUNCTION__);
 			// If it can't be found check that the buffer has not currently exceeded the size limit of a header
-			if (buffer.size() > HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE)
+			if (buffer.readable() > HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE)
 			{
 				response.setResponseDefaultBody(413, "Request Header Too Large", NULL, NULL, HttpResponse::FATAL_ERROR);
 				Logger::debug("Header size limit exceeded", __FILE__, __LINE__, __PRETTY_FUNCTION__);
@@ -75,20 +119,16 @@ void HttpHeaders::parseBuffer(std::vector<char> &buffer, HttpResponse &response,
 			return;
 		}
 
-		// Extract header data from buffer
-		std::string rawHeader;
-		rawHeader.assign(buffer.begin(), it);
-		Logger::debug("HttpHeaders: Found header line: '" + rawHeader + "'", __FILE__, __LINE__, __PRETTY_FUNCTION__);
-		buffer.erase(buffer.begin(), it + 2);
-		if (rawHeader.empty())
+		if (lineEnd == 0)
 		{
+			buffer.consume(2);
 			Logger::debug("HttpHeaders: Empty line found, headers complete", __FILE__, __LINE__, __PRETTY_FUNCTION__);
 			parseAllHeaders(response, body);
 			_headersState = HEADERS_PARSING_COMPLETE;
 			Logger::log(Logger::DEBUG, "Headers parsing complete");
 			return;
 		}
-		else if (rawHeader.size() + 2 > HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE)
+		else if (lineEnd + 2 > HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE)
 		{
 			response.setResponseDefaultBody(413, "Request Line Header Too Large", NULL, NULL,
 											HttpResponse::FATAL_ERROR);
@@ -96,7 +136,7 @@ void HttpHeaders::parseBuffer(std::vector<char> &buffer, HttpResponse &response,
 			_headersState = HEADERS_PARSING_ERROR;
 			return;
 		}
-		_rawHeadersSize += rawHeader.size() + 2;
+		_rawHeadersSize += lineEnd + 2;
 		if (_rawHeadersSize > HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE)
 		{
 			response.setResponseDefaultBody(413, "Request headers total size too large", NULL, NULL,
@@ -107,7 +147,8 @@ void HttpHeaders::parseBuffer(std::vector<char> &buffer, HttpResponse &response,
 		}
 
 		// Parse headers
-		parseHeaderLine(rawHeader, response);
+		parseHeaderLine(buffer.data(), lineEnd, response);
+		buffer.consume(lineEnd + 2);
 		if (_headersState == HEADERS_PARSING_ERROR)
 		{
 			return;
@@ -115,60 +156,59 @@ void HttpHeaders::parseBuffer(std::vector<char> &buffer, HttpResponse &response,
 	}
 }
 
-void HttpHeaders::parseHeaderLine(const std::string &rawHeader, HttpResponse &response)
+void HttpHeaders::parseHeaderLine(const char *line, size_t length, HttpResponse &response)
 {
-	try
+	const char *error = Header::check(line, length);
+	if (error != NULL)
 	{
-		Header header(rawHeader);
-		for (std::vector<Header>::iterator it = _headers.begin(); it != _headers.end(); ++it)
-		{
-			if (*it == header)
-			{
-				if (isSingletonHeader(header.getDirective()))
-				{
-					Logger::debug("Singleton header " + header.getDirective() + " found multiple times", __FILE__,
-								  __LINE__, __PRETTY_FUNCTION__);
-					_headersState = HEADERS_PARSING_ERROR;
-					response.setResponseDefaultBody(400, "Duplicate singleton header found", NULL, NULL,
-													HttpResponse::FATAL_ERROR);
-					return;
-				}
-				it->merge(header);
-				return;
-			}
-		}
-		_headers.push_back(header); // If the header is not found, add it to the list
+		Logger::log(Logger::ERROR, "Error parsing header: " + std::string(error));
+		response.setResponseDefaultBody(400, "Error parsing header: " + std::string(error), NULL, NULL,
+										HttpResponse::FATAL_ERROR);
+		_headersState = HEADERS_PARSING_ERROR;
+		return;
 	}
-	catch (const std::exception &e)
+	Field field;
+	field.offset = _raw.size();
+	field.length = length;
+	field.nameLength = static_cast<const char *>(std::memchr(line, ':', length)) - line;
+	field.id = KnownHeaders::lookup(line, field.nameLength);
+	// A repeated header is merged into its first line when Header objects are built
+	if (KnownHeaders::isSingleton(field.id) && _known[field.id] != -1)
 	{
-		Logger::log(Logger::ERROR, "Error parsing header: " + std::string(e.what()));
-		response.setResponseDefaultBody(400, "Error parsing header: " + std::string(e.what()), NULL, NULL,
-										HttpResponse::FATAL_ERROR);
+		Logger::debug("Singleton header " + StrUtils::toLowerCase(std::string(line, field.nameLength)) +
+						  " found multiple times",
+					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 		_headersState = HEADERS_PARSING_ERROR;
+		response.setResponseDefaultBody(400, "Duplicate singleton header found", NULL, NULL,
+										HttpResponse::FATAL_ERROR);
+		return;
 	}
+	if (field.id != KnownHeaders::UNKNOWN && _known[field.id] == -1)
+		_known[field.id] = static_cast<int>(_fields.size());
+	_raw.append(line, length);
+	_fields.push_back(field);
 }
 
-// Checks all headers for special characters
+// Checks the headers the parser itself acts on, straight from their spans. Each is looked at once, on the first line
+// carrying its name, in the order they arrived.
 void HttpHeaders::parseAllHeaders(HttpResponse &response, HttpBody &body)
 {
 	bool hostFound = false;
-	for (std::vector<Header>::iterator it = _headers.begin(); it != _headers.end(); ++it)
+	const Field *contentLength = _findField(KnownHeaders::CONTENT_LENGTH);
+	const Field *transferEncoding = _findField(KnownHeaders::TRANSFER_ENCODING);
+	for (std::vector<Field>::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
 	{
-		std::string headerName = it->getDirective();
-		std::vector<std::string> headerValues = it->getValues();
-		if (headerName == "content-length")
+		const char *line = _raw.data() + it->offset;
+		if (it->id == KnownHeaders::UNKNOWN || _findField(it->id) != &*it)
+			continue;
+		size_t cursor = it->nameLength + 1;
+		size_t valuesEnd = Header::findParameters(line, cursor, it->length);
+		const char *value;
+		size_t valueLength;
+		nextValue(line, valuesEnd, cursor, value, valueLength);
+		if (&*it == contentLength)
 		{
-			bool hasTransferEncoding = false;
-			for (std::vector<Header>::const_iterator headerIt = _headers.begin(); headerIt != _headers.end();
-				 ++headerIt)
-			{
-				if (headerIt->getDirective() == "transfer-encoding")
-				{
-					hasTransferEncoding = true;
-					break;
-				}
-			}
-			if (hasTransferEncoding)
+			if (transferEncoding != NULL)
 			{
 				Logger::debug("Content-Length and Transfer-Encoding headers cannot be used together", __FILE__,
 							  __LINE__, __PRETTY_FUNCTION__);
@@ -178,14 +218,14 @@ void HttpHeaders::parseAllHeaders(HttpResponse &response, HttpBody &body)
 												NULL, NULL, HttpResponse::FATAL_ERROR);
 				return;
 			}
+			std::string digits(value, valueLength);
 			char *endPtr;
-			ssize_t contentLength = std::strtol(headerValues[0].c_str(), &endPtr, 10);
+			ssize_t contentLength = std::strtol(digits.c_str(), &endPtr, 10);
 			if (*endPtr != '\0' || contentLength < 0)
 			{
-				Logger::debug("Invalid Content-Length header: " + headerValues[0], __FILE__, __LINE__,
-							  __PRETTY_FUNCTION__);
+				Logger::debug("Invalid Content-Length header: " + digits, __FILE__, __LINE__, __PRETTY_FUNCTION__);
 				_headersState = HEADERS_PARSING_ERROR;
-				response.setResponseDefaultBody(400, "Invalid Content-Length header: " + headerValues[0], NULL, NULL,
+				response.setResponseDefaultBody(400, "Invalid Content-Length header: " + digits, NULL, NULL,
 												HttpResponse::FATAL_ERROR);
 				return;
 			}
@@ -199,19 +239,9 @@ void HttpHeaders::parseAllHeaders(HttpResponse &response, HttpBody &body)
 				body.setBodyType(HttpBody::BODY_TYPE_NO_BODY);
 			}
 		}
-		else if (headerName == "transfer-encoding")
+		else if (&*it == transferEncoding)
 		{
-			bool hasContentLength = false;
-			for (std::vector<Header>::const_iterator headerIt = _headers.begin(); headerIt != _headers.end();
-				 ++headerIt)
-			{
-				if (headerIt->getDirective() == "content-length")
-				{
-					hasContentLength = true;
-					break;
-				}
-			}
-			if (hasContentLength)
+			if (contentLength != NULL)
 			{
 				Logger::debug("Content-Length and Transfer-Encoding headers cannot be used together", __FILE__,
 							  __LINE__, __PRETTY_FUNCTION__);
@@ -221,51 +251,59 @@ void HttpHeaders::parseAllHeaders(HttpResponse &response, HttpBody &body)
 												NULL, NULL, HttpResponse::FATAL_ERROR);
 				return;
 			}
-			// As per requirements, only chunked is supported
-			if (std::find(headerValues.begin(), headerValues.end(), "chunked") != headerValues.end())
+			// As per requirements, only chunked is supported, in any value of any Transfer-Encoding line
+			bool chunked = false;
+			for (std::vector<Field>::const_iterator field = it; field != _fields.end() && !chunked; ++field)
+			{
+				const char *fieldLine = _raw.data() + field->offset;
+				if (field->id != KnownHeaders::TRANSFER_ENCODING)
+					continue;
+				size_t fieldCursor = field->nameLength + 1;
+				size_t fieldEnd = Header::findParameters(fieldLine, fieldCursor, field->length);
+				const char *coding;
+				size_t codingLength;
+				while (!chunked && nextValue(fieldLine, fieldEnd, fieldCursor, coding, codingLength))
+					chunked = valueEquals(coding, codingLength, "chunked");
+			}
+			if (chunked)
 			{
 				body.setBodyType(HttpBody::BODY_TYPE_CHUNKED);
 			}
 			else
 			{
-				Logger::debug("Invalid Transfer-Encoding header: " + headerValues[0], __FILE__, __LINE__,
-							  __PRETTY_FUNCTION__);
+				Logger::debug("Invalid Transfer-Encoding header: " + std::string(value, valueLength), __FILE__,
+							  __LINE__, __PRETTY_FUNCTION__);
 				_headersState = HEADERS_PARSING_ERROR;
-				response.setResponseDefaultBody(400, "Invalid Transfer-Encoding header: " + headerValues[0], NULL, NULL,
-												HttpResponse::FATAL_ERROR);
+				response.setResponseDefaultBody(400,
+												"Invalid Transfer-Encoding header: " + std::string(value, valueLength),
+												NULL, NULL, HttpResponse::FATAL_ERROR);
 				return;
 			}
 		}
-		else if (headerName == "connection")
+		else if (it->id == KnownHeaders::CONNECTION)
 		{
-			if (headerValues[0] == "close")
+			if (valueEquals(value, valueLength, "close"))
 			{
 				response.setHeader(Header("Connection: close"));
 			}
-			else if (headerValues[0] == "keep-alive")
+			else if (valueEquals(value, valueLength, "keep-alive"))
 			{
 				response.setHeader(Header("Connection: keep-alive"));
 			}
 			else
 			{
-				Logger::debug("Invalid Connection header: " + headerValues[0], __FILE__, __LINE__, __PRETTY_FUNCTION__);
+				Logger::debug("Invalid Connection header: " + std::string(value, valueLength), __FILE__, __LINE__,
+							  __PRETTY_FUNCTION__);
 				_headersState = HEADERS_PARSING_ERROR;
-				response.setResponseDefaultBody(400, "Invalid Connection header: " + headerValues[0], NULL, NULL,
-												HttpResponse::FATAL_ERROR);
+				response.setResponseDefaultBody(400, "Invalid Connection header: " + std::string(value, valueLength),
+												NULL, NULL, HttpResponse::FATAL_ERROR);
 				return;
 			}
 		}
-		else if (headerName == "host")
+		else if (it->id == KnownHeaders::HOST)
 		{
+			// Host header is required for HTTP/1.1, Header::check() already refused an empty one
 			hostFound = true;
-			// Host header is required for HTTP/1.1
-			if (headerValues.empty())
-			{
-				Logger::debug("Empty Host header", __FILE__, __LINE__, __PRETTY_FUNCTION__);
-				_headersState = HEADERS_PARSING_ERROR;
-				response.setResponseDefaultBody(400, "Empty Host header", NULL, NULL, HttpResponse::FATAL_ERROR);
-				return;
-			}
 		}
 	}
 	if (!hostFound)
@@ -280,10 +318,57 @@ void HttpHeaders::parseAllHeaders(HttpResponse &response, HttpBody &body)
 
 bool HttpHeaders::isSingletonHeader(const std::string &headerName) const
 {
-	std::vector<std::string> singletonHeaders(HTTP::SINGLETON_HEADERS,
-											  HTTP::SINGLETON_HEADERS +
-												  sizeof(HTTP::SINGLETON_HEADERS) / sizeof(HTTP::SINGLETON_HEADERS[0]));
-	return std::find(singletonHeaders.begin(), singletonHeaders.end(), headerName) != singletonHeaders.end();
+	return isSingletonHeader(headerName.data(), headerName.size());
+}
+
+bool HttpHeaders::isSingletonHeader(const char *name, size_t length)
+{
+	return KnownHeaders::isSingleton(KnownHeaders::lookup(name, length));
+}
+
+// First line carrying the name, compared case-insensitively. Known names come straight from their slot, only the
+// others are searched for.
+const HttpHeaders::Field *HttpHeaders::_findField(const char *name, size_t length) const
+{
+	KnownHeaders::Id id = KnownHeaders::lookup(name, length);
+	if (id != KnownHeaders::UNKNOWN)
+		return _findField(id);
+	for (std::vector<Field>::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
+		if (it->id == KnownHeaders::UNKNOWN && it->nameLength == length &&
+			namesEqual(_raw.data() + it->offset, name, length))
+			return &*it;
+	return NULL;
+}
+
+const HttpHeaders::Field *HttpHeaders::_findField(KnownHeaders::Id id) const
+{
+	return _known[id] == -1 ? NULL : &_fields[_known[id]];
+}
+
+// First value of the line as Header::getValues()[0] has it, pointing into _raw
+bool HttpHeaders::_firstValue(const Field &field, const char *&value, size_t &length) const
+{
+	const char *line = _raw.data() + field.offset;
+	size_t cursor = field.nameLength + 1;
+	return nextValue(line, Header::findParameters(line, cursor, field.length), cursor, value, length);
+}
+
+// Same Header objects the parser used to keep: one per name, repeated lines merged into the first
+void HttpHeaders::_buildHeaders() const
+{
+	if (_headersBuilt)
+		return;
+	_headers.clear();
+	for (std::vector<Field>::const_iterator field = _fields.begin(); field != _fields.end(); ++field)
+	{
+		Header header(_raw.substr(field->offset, field->length));
+		std::vector<Header>::iterator it = std::find(_headers.begin(), _headers.end(), header);
+		if (it != _headers.end())
+			it->merge(header);
+		else
+			_headers.push_back(header);
+	}
+	_headersBuilt = true;
 }
 
 /*
@@ -297,11 +382,13 @@ int HttpHeaders::getHeadersState() const
 
 const std::vector<Header> &HttpHeaders::getHeaders() const
 {
+	_buildHeaders();
 	return _headers;
 }
 
 const Header *HttpHeaders::getHeader(const std::string &headerName) const
 {
+	_buildHeaders();
 	for (std::vector<Header>::const_iterator it = _headers.begin(); it != _headers.end(); ++it)
 	{
 		if (it->getDirective() == headerName)
@@ -312,6 +399,45 @@ const Header *HttpHeaders::getHeader(const std::string &headerName) const
 	return NULL;
 }
 
+// First value of the header as Header::getValues()[0] has it, pointing into the parsed lines. Nothing is built.
+bool HttpHeaders::getValue(const char *headerName, const char *&value, size_t &length) const
+{
+	const Field *field = _findField(headerName, std::strlen(headerName));
+	return field != NULL && _firstValue(*field, value, length);
+}
+
+bool HttpHeaders::getValue(KnownHeaders::Id id, const char *&value, size_t &length) const
+{
+	const Field *field = _findField(id);
+	return field != NULL && _firstValue(*field, value, length);
+}
+
+size_t HttpHeaders::getFieldCount() const
+{
+	return _fields.size();
+}
+
+// Lowercase name and first value of a line, the way getHeaders() would hold them. False for a line repeating an
+// earlier name, its values only exist merged into that first line.
+bool HttpHeaders::getField(size_t index, KnownHeaders::Id &id, std::string &name, const char *&value,
+						   size_t &length) const
+{
+	const Field &field = _fields[index];
+	const char *line = _raw.data() + field.offset;
+	if (_findField(line, field.nameLength) != &field)
+		return false;
+	id = field.id;
+	if (id != KnownHeaders::UNKNOWN)
+		name = KnownHeaders::name(id);
+	else
+	{
+		name.assign(line, field.nameLength);
+		for (size_t i = 0; i < name.size(); ++i)
+			name[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[i])));
+	}
+	return _firstValue(field, value, length);
+}
+
 size_t HttpHeaders::getHeadersSize() const
 {
 	return _rawHeadersSize;
@@ -324,5 +450,10 @@ size_t HttpHeaders::getHeadersSize() const
 void HttpHeaders::reset()
 {
 	_headersState = HEADERS_PARSING;
+	_raw.clear();
+	_fields.clear();
+	std::fill(_known, _known + KnownHeaders::COUNT, -1);
 	_headers.clear();
+	_headersBuilt = false;
+	_rawHeadersSize = 0;
 }
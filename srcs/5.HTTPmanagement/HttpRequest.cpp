@@ -10,12 +10,12 @@
 ** ------------------------------- CONSTRUCTOR --------------------------------
 */
 
-HttpRequest::HttpRequest()
+HttpRequest::HttpRequest() : _remoteAddress(NULL)
 {
 	reset();
 }
 
-HttpRequest::HttpRequest(const HttpRequest &src)
+HttpRequest::HttpRequest(const HttpRequest &src) : _remoteAddress(NULL)
 {
 	*this = src;
 }
@@ -40,8 +40,13 @@ HttpRequest &HttpRequest::operator=(const HttpRequest &rhs)
 		_headers = rhs._headers;
 		_body = rhs._body;
 		_parseState = rhs._parseState;
+		_internalRedirectDepth = rhs._internalRedirectDepth;
 		_potentialServers = rhs._potentialServers;
 		_selectedServer = rhs._selectedServer;
+		_selectedServerHost = rhs._selectedServerHost;
+		_selectedServerPort = rhs._selectedServerPort;
+		_selectedLocation = rhs._selectedLocation;
+		_remoteAddress = rhs._remoteAddress;
 	}
 	return *this;
 }
@@ -59,14 +64,15 @@ bool HttpRequest::_identifyServer(HttpResponse &response)
 		response.setResponseDefaultBody(500, "Internal Server Error", NULL, NULL, HttpResponse::FATAL_ERROR);
 		return false;
 	}
-	const Header *hostHeader = _headers.getHeader("host");
-	if (hostHeader == NULL)
+	const char *host;
+	size_t hostLength;
+	if (!_headers.getValue(KnownHeaders::HOST, host, hostLength))
 	{
 		Logger::error("HttpRequest: No host header found", __FILE__, __LINE__, __PRETTY_FUNCTION__);
 		response.setResponseDefaultBody(400, "No host header found", NULL, NULL, HttpResponse::FATAL_ERROR);
 		return false;
 	}
-	std::string hostValue = (!hostHeader->getValues().empty()) ? hostHeader->getValues()[0] : "<none>";
+	std::string hostValue(host, hostLength);
 
 	// Parse host and optional port from Host header
 	std::string hostPart = hostValue;
@@ -147,12 +153,12 @@ bool HttpRequest::_identifyServer(HttpResponse &response)
 *----------------------------------
 */
 
-HttpRequest::ParseState HttpRequest::parseBuffer(std::vector<char> &holdingBuffer, HttpResponse &response)
+HttpRequest::ParseState HttpRequest::parseBuffer(RingBuffer &holdingBuffer, HttpResponse &response)
 {
 	PERF_SCOPED_TIMER(http_request_parsing);
 
 	Logger::debug("HttpRequest: parseBuffer called, state: " + StrUtils::toString(_parseState) +
-					  ", buffer size: " + StrUtils::toString(holdingBuffer.size()),
+					  ", buffer size: " + StrUtils::toString(holdingBuffer.readable()),
 				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 
 	// Continue parsing until complete or need more data
@@ -199,9 +205,10 @@ HttpRequest::ParseState HttpRequest::parseBuffer(std::vector<char> &holdingBuffe
 			{
 				if (!_identifyServer(response))
 				{
-					const Header *hostHeader = _headers.getHeader("host");
+					const char *host;
+					size_t hostLength;
 					std::string hostValue =
-						(hostHeader && !hostHeader->getValues().empty()) ? hostHeader->getValues()[0] : "<none>";
+						_headers.getValue(KnownHeaders::HOST, host, hostLength) ? std::string(host, hostLength) : "<none>";
 					Logger::error("HttpRequest: Failed to identify server for host value: " + hostValue, __FILE__,
 								  __LINE__, __PRETTY_FUNCTION__);
 					_parseState = PARSING_ERROR;
@@ -356,32 +363,37 @@ const std::map<std::string, std::vector<std::string> > &HttpRequest::getQueryPar
 	return _uri.getQueryParameters();
 };
 
-std::string HttpRequest::getQueryString() const
+const std::string &HttpRequest::getQueryString() const
 {
 	return _uri.getQueryString();
 };
 
 // URI accessors
-std::string HttpRequest::getMethod() const
+const std::string &HttpRequest::getMethod() const
 {
 	return _uri.getMethod();
 };
 
-std::string HttpRequest::getUri() const
+const std::string &HttpRequest::getUri() const
 {
 	return _uri.getURI();
 };
 
-std::string HttpRequest::getRawUri() const
+const std::string &HttpRequest::getRawUri() const
 {
 	return _uri.getRawURI();
 };
 
-std::string HttpRequest::getVersion() const
+const std::string &HttpRequest::getVersion() const
 {
 	return _uri.getVersion();
 };
 
+const HttpHeaders &HttpRequest::getHeaderFields() const
+{
+	return _headers;
+}
+
 std::map<std::string, std::vector<std::string> > HttpRequest::getHeaders() const
 {
 	std::map<std::string, std::vector<std::string> > result;
@@ -6,6 +6,11 @@
 #include "../../includes/Global/Logger.hpp"
 #include "../../includes/Global/StrUtils.hpp"
 #include "../../includes/HTTP/HTTP.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
 */
@@ -40,10 +45,22 @@ HttpResponse &HttpResponse::operator=(HttpResponse const &rhs)
 		_statusMessage = rhs._statusMessage;
 		_version = rhs._version;
 		_headers = rhs._headers;
+		std::copy(rhs._known, rhs._known + KnownHeaders::COUNT, _known);
 		_body = rhs._body;
 		_streamBody = rhs._streamBody;
 		_bodyFileDescriptor = rhs._bodyFileDescriptor;
+		_sendfileBody = rhs._sendfileBody;
+		_bodyOffset = rhs._bodyOffset;
+		_bodyRemaining = rhs._bodyRemaining;
+		_pipeBody = rhs._pipeBody;
+		_passThrough = rhs._passThrough;
+		_closeDelimited = rhs._closeDelimited;
+		_limitRate = rhs._limitRate;
+		_limitRateAfter = rhs._limitRateAfter;
+		_rateTokens = rhs._rateTokens;
+		_rateRefilledAt = rhs._rateRefilledAt;
 		_rawResponse = rhs._rawResponse;
+		_sendOffset = rhs._sendOffset;
 		_sendingState = rhs._sendingState;
 		_responseType = rhs._responseType;
 	}
@@ -54,6 +71,37 @@ HttpResponse &HttpResponse::operator=(HttpResponse const &rhs)
 ** --------------------------------- PRIVATE METHODS ----------------------------------
 */
 
+// Known names are found through their slot, the others by a scan. Only unknown ones can match in the scan.
+Header *HttpResponse::_findHeader(const Header &header)
+{
+	KnownHeaders::Id id = KnownHeaders::lookup(header.getDirective());
+	if (id != KnownHeaders::UNKNOWN)
+		return _known[id] == -1 ? NULL : &_headers[_known[id]];
+	for (std::vector<Header>::iterator it = _headers.begin(); it != _headers.end(); ++it)
+		if (*it == header)
+			return &*it;
+	return NULL;
+}
+
+void HttpResponse::_appendHeader(const Header &header)
+{
+	KnownHeaders::Id id = KnownHeaders::lookup(header.getDirective());
+	if (id != KnownHeaders::UNKNOWN)
+		_known[id] = static_cast<int>(_headers.size());
+	_headers.push_back(header);
+}
+
+void HttpResponse::_indexHeaders()
+{
+	std::fill(_known, _known + KnownHeaders::COUNT, -1);
+	for (size_t i = 0; i < _headers.size(); ++i)
+	{
+		KnownHeaders::Id id = KnownHeaders::lookup(_headers[i].getDirective());
+		if (id != KnownHeaders::UNKNOWN && _known[id] == -1)
+			_known[id] = static_cast<int>(i);
+	}
+}
+
 void HttpResponse::_getDateHeader()
 {
 	std::time_t now = std::time(0);
@@ -87,34 +135,31 @@ void HttpResponse::_setVersionHeader()
 // Replaces a header if it exists else inserts it
 void HttpResponse::setHeader(const Header &header)
 {
-	for (std::vector<Header>::iterator it = _headers.begin(); it != _headers.end(); ++it)
+	Header *existing = _findHeader(header);
+	if (existing != NULL)
 	{
-		if (*it == header)
-		{
-			*it = header;
-			return;
-		}
+		*existing = header;
+		return;
 	}
-	_headers.push_back(header);
+	_appendHeader(header);
 }
 // Inserts/mergers a header if it exists
 void HttpResponse::insertHeader(const Header &header)
 {
-	for (std::vector<Header>::iterator it = _headers.begin(); it != _headers.end(); ++it)
+	Header *existing = _findHeader(header);
+	if (existing != NULL)
 	{
-		if (*it == header)
-		{
-			it->merge(header);
-			return;
-		}
+		existing->merge(header);
+		return;
 	}
-	_headers.push_back(header);
+	_appendHeader(header);
 }
 
 void HttpResponse::setBody(const std::string &body)
 {
 	_body = body;
 	_streamBody = false;
+	_pipeBody = false;
 	setHeader(Header("content-type: text/html"));
 	setHeader(Header("content-length: " + StrUtils::toString(body.length())));
 }
@@ -128,6 +173,7 @@ void HttpResponse::setResponseDefaultBody(int statusCode, const std::string &sta
 	_responseType = responseType;
 	_body = DefaultStatusMap::getStatusBody(_statusCode);
 	_streamBody = false;
+	_pipeBody = false;
 	setHeader(Header("content-type: " + HTTP_RESPONSE_DEFAULT::CONTENT_TYPE));
 	setHeader(Header("content-length: " + StrUtils::toString(_body.length())));
 	if (location && location->hasStatusPage(_statusCode))
@@ -160,6 +206,7 @@ void HttpResponse::setResponseCustomBody(int statusCode, const std::string &stat
 	_responseType = responseType;
 	_body = body;
 	_streamBody = false;
+	_pipeBody = false;
 	setHeader(Header("content-type: " + contentType));
 	setHeader(Header("content-length: " + StrUtils::toString(body.length())));
 }
@@ -175,10 +222,42 @@ void HttpResponse::setResponseFile(int statusCode, const std::string &statusMess
 	Logger::debug("HttpResponse: Setting response file: " + filePath, __FILE__, __LINE__, __PRETTY_FUNCTION__);
 	_bodyFileDescriptor = FileDescriptor::createFromOpen(filePath.c_str(), O_RDONLY);
 	_streamBody = true;
+	_pipeBody = false;
 	setHeader(Header("content-type: " + contentType));
 	setHeader(Header("content-length: " + StrUtils::toString(_bodyFileDescriptor.getFileSize())));
 }
 
+// Used when the body is the rest of a CGI's stdout, prefix is what was read along with its headers.
+// Without a length from the script the body runs until the pipe closes and the connection closes after it.
+void HttpResponse::setResponseStream(const FileDescriptor &pipe, const std::string &prefix, ssize_t contentLength)
+{
+	_body = prefix;
+	_bodyFileDescriptor = pipe;
+	_streamBody = true;
+	_pipeBody = true;
+	_closeDelimited = contentLength < 0;
+	if (_closeDelimited)
+	{
+		setHeader(Header("connection: close"));
+		return;
+	}
+	if (_body.size() > static_cast<size_t>(contentLength))
+		_body.resize(static_cast<size_t>(contentLength));
+	_bodyRemaining = contentLength - static_cast<off_t>(_body.size());
+	setHeader(Header("content-length: " + StrUtils::toString(contentLength)));
+}
+
+// Used for NPH CGI output, which already holds its status line and headers and goes out untouched
+void HttpResponse::setResponsePassThrough(const FileDescriptor &pipe, const std::string &output)
+{
+	_body = output;
+	_bodyFileDescriptor = pipe;
+	_streamBody = pipe.isOpen();
+	_pipeBody = _streamBody;
+	_passThrough = true;
+	_closeDelimited = true;
+}
+
 // Used when a redirect is needed
 void HttpResponse::setRedirectResponse(const std::string &redirectPath, ResponseType responseType)
 {
@@ -223,9 +302,22 @@ void HttpResponse::reset()
 	_statusCode = HTTP_RESPONSE_DEFAULT::DEFAULT_STATUS_CODE;
 	_statusMessage = HTTP_RESPONSE_DEFAULT::DEFAULT_STATUS_MESSAGE;
 	_headers.clear();
+	std::fill(_known, _known + KnownHeaders::COUNT, -1);
 	_body = "";
+	_rawResponse.clear();
+	_sendOffset = 0;
 	_streamBody = false;
 	_bodyFileDescriptor = FileDescriptor();
+	_sendfileBody = false;
+	_bodyOffset = 0;
+	_bodyRemaining = 0;
+	_pipeBody = false;
+	_passThrough = false;
+	_closeDelimited = false;
+	_limitRate = 0;
+	_limitRateAfter = 0;
+	_rateTokens = 0;
+	_rateRefilledAt = 0;
 	_sendingState = RESPONSE_FORMATTING_MESSAGE;
 	_responseType = SUCCESS;
 	_getDateHeader();
@@ -279,6 +371,32 @@ HttpResponse::SendingState HttpResponse::getSendingState() const
 	return _sendingState;
 }
 
+bool HttpResponse::isStreamed() const
+{
+	return _streamBody;
+}
+
+// A failed response, or a body whose end only the closed connection can mark
+bool HttpResponse::closesConnection() const
+{
+	return _responseType == FATAL_ERROR || _closeDelimited;
+}
+
+bool HttpResponse::isRateLimited() const
+{
+	return _limitRate != 0;
+}
+
+// When the bucket holds a window's worth again. Only meaningful once rateAllowance() came up short.
+uint64_t HttpResponse::getRateResumeAt() const
+{
+	size_t window = _rateWindow();
+	if (_rateTokens >= window)
+		return _rateRefilledAt;
+	uint64_t missing = window - _rateTokens;
+	return _rateRefilledAt + (missing * 1000 + _limitRate - 1) / _limitRate;
+}
+
 HttpResponse::ResponseType HttpResponse::getResponseType() const
 {
 	return _responseType;
@@ -311,6 +429,7 @@ void HttpResponse::setVersion(const std::string &version)
 void HttpResponse::setHeaders(const std::vector<Header> &headers)
 {
 	_headers = headers;
+	_indexHeaders();
 }
 
 void HttpResponse::setRawResponse(const std::string &rawResponse)
@@ -360,52 +479,267 @@ void HttpResponse::setBody(const Location *location, const Server *server)
 		_body = DefaultStatusMap::getStatusBody(_statusCode);
 }
 
-void HttpResponse::sendResponse(const FileDescriptor &clientFd, ssize_t &totalBytesSent)
+// Regular files go out with sendfile() from an offset kept here, so the file position is never touched and no byte
+// crosses user space. Anything else (a FIFO or character device reached through a status page or a symlink)
+// falls back to read() + send() through a stack buffer.
+void HttpResponse::_prepareBodyStream()
+{
+	struct stat fileStat;
+	if (_pipeBody)
+		return;
+	_bodyOffset = 0;
+	_sendfileBody = fstat(_bodyFileDescriptor.getFd(), &fileStat) == 0 && S_ISREG(fileStat.st_mode);
+	_bodyRemaining = _sendfileBody ? fileStat.st_size : 0;
+}
+
+// Head and in-memory body go out in one vectored write straight from their own buffers, a partial write only
+// moves _sendOffset. sendmsg() rather than writev() for MSG_NOSIGNAL.
+void HttpResponse::_sendBuffered(int socketFd, ssize_t &totalBytesSent, size_t budget)
+{
+	struct iovec iov[BUFFERED_IOV_COUNT];
+	struct msghdr message;
+	std::memset(&message, 0, sizeof(message));
+	message.msg_iov = iov;
+	message.msg_iovlen = gatherBuffered(iov, budget - static_cast<size_t>(totalBytesSent));
+	ssize_t bytesSent = sendmsg(socketFd, &message, MSG_NOSIGNAL);
+	if (bytesSent > 0)
+	{
+		totalBytesSent += bytesSent;
+		consumeBuffered(static_cast<size_t>(bytesSent));
+	}
+	else if (bytesSent == -1 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+		_sendingState = RESPONSE_SENDING_ERROR;
+}
+
+void HttpResponse::_sendfileChunk(int socketFd, ssize_t &totalBytesSent, size_t budget)
 {
-	while (_sendingState != RESPONSE_SENDING_COMPLETE && _sendingState != RESPONSE_SENDING_ERROR &&
-		   totalBytesSent < HTTP::DEFAULT_SEND_SIZE)
+	if (_bodyRemaining <= 0)
+	{
+		_sendingState = RESPONSE_SENDING_COMPLETE;
+		return;
+	}
+	size_t chunk = budget - static_cast<size_t>(totalBytesSent);
+	if (static_cast<off_t>(chunk) > _bodyRemaining)
+		chunk = static_cast<size_t>(_bodyRemaining);
+	ssize_t bytesSent = sendfile(socketFd, _bodyFileDescriptor.getFd(), &_bodyOffset, chunk);
+	if (bytesSent > 0)
+	{
+		totalBytesSent += bytesSent;
+		_bodyRemaining -= bytesSent;
+	}
+	else if (bytesSent == 0) // File shrank below the announced content-length, the response cannot be completed
+		_sendingState = RESPONSE_SENDING_ERROR;
+	else if (errno == EINVAL || errno == ENOSYS)
 	{
+		// The file system cannot splice this file, continue from the same offset through the copy path
+		_sendfileBody = false;
+		if (lseek(_bodyFileDescriptor.getFd(), _bodyOffset, SEEK_SET) == -1)
+			_sendingState = RESPONSE_SENDING_ERROR;
+	}
+	else if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+		_sendingState = RESPONSE_SENDING_ERROR;
+}
+
+void HttpResponse::_copyChunk(int socketFd, ssize_t &totalBytesSent, size_t budget)
+{
+	char buffer[HTTP::DEFAULT_SEND_SIZE];
+	size_t chunk = std::min(sizeof(buffer), budget - static_cast<size_t>(totalBytesSent));
+	ssize_t bytesRead = read(_bodyFileDescriptor.getFd(), buffer, chunk);
+	if (bytesRead < 0)
+	{
+		if (errno != EINTR)
+			_sendingState = RESPONSE_SENDING_ERROR;
+		return;
+	}
+	if (bytesRead == 0)
+	{
+		_sendingState = RESPONSE_SENDING_COMPLETE;
+		return;
+	}
+	ssize_t bytesSent = send(socketFd, buffer, bytesRead, MSG_NOSIGNAL);
+	if (bytesSent == -1 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+	{
+		_sendingState = RESPONSE_SENDING_ERROR;
+		return;
+	}
+	if (bytesSent > 0)
+		totalBytesSent += bytesSent;
+	else
+		bytesSent = 0;
+	// Rewind whatever the socket did not take so the next edge resends it
+	if (bytesSent < bytesRead)
+		lseek(_bodyFileDescriptor.getFd(), bytesSent - bytesRead, SEEK_CUR);
+}
+
+// Moves CGI output from its pipe to the socket without passing through user space. The pipe is polled first since
+// splice() reports an empty pipe and a full socket with the same EAGAIN, and only a full socket may wait for the
+// next EPOLLOUT edge. A script that goes quiet past CGI_STREAM_TIMEOUT_MS fails the response.
+void HttpResponse::_spliceChunk(int socketFd, ssize_t &totalBytesSent, size_t budget)
+{
+	if (!_closeDelimited && _bodyRemaining <= 0)
+	{
+		_sendingState = RESPONSE_SENDING_COMPLETE;
+		return;
+	}
+	struct pollfd source;
+	source.fd = _bodyFileDescriptor.getFd();
+	source.events = POLLIN;
+	source.revents = 0;
+	int ready = poll(&source, 1, HTTP::CGI_STREAM_TIMEOUT_MS);
+	if (ready <= 0)
+	{
+		if (ready == 0 || errno != EINTR)
+		{
+			Logger::error("HttpResponse: CGI output stalled", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+			_sendingState = RESPONSE_SENDING_ERROR;
+		}
+		return;
+	}
+	size_t chunk = budget - static_cast<size_t>(totalBytesSent);
+	if (!_closeDelimited && static_cast<off_t>(chunk) > _bodyRemaining)
+		chunk = static_cast<size_t>(_bodyRemaining);
+	ssize_t bytesSent = splice(source.fd, NULL, socketFd, NULL, chunk, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+	if (bytesSent > 0)
+	{
+		totalBytesSent += bytesSent;
+		if (!_closeDelimited)
+			_bodyRemaining -= bytesSent;
+	}
+	else if (bytesSent == 0) // The script closed its stdout, which only ends a body of unknown length
+		_sendingState = _closeDelimited ? RESPONSE_SENDING_COMPLETE : RESPONSE_SENDING_ERROR;
+	else if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+		_sendingState = RESPONSE_SENDING_ERROR;
+}
+
+// In-memory body bytes: all of it, or for a pipe the part read along with the CGI headers
+size_t HttpResponse::_bufferedBodySize() const
+{
+	return (!_streamBody || _pipeBody) ? _body.size() : 0;
+}
+
+// Serializes the status line and headers, the body stays where it is
+void HttpResponse::formatMessage()
+{
+	if (_sendingState != RESPONSE_FORMATTING_MESSAGE)
+		return;
+	if (_passThrough) // The body carries its own head
+		_rawResponse.clear();
+	else
+	{
+		_rawResponse = _version + " " + StrUtils::toString(_statusCode) + " " + _statusMessage + "\r\n";
+		for (std::vector<Header>::const_iterator it = _headers.begin(); it != _headers.end(); ++it)
+		{
+			_rawResponse += it->getDirective() + ": " + it->getValues()[0] + "\r\n";
+		}
+		_rawResponse += "\r\n";
+	}
+	_version.clear();
+	_statusMessage.clear();
+	_headers.clear();
+	std::fill(_known, _known + KnownHeaders::COUNT, -1);
+	// An in-memory body is sent from _body as it is, a streamed one from its file
+	_sendOffset = 0;
+	if (_streamBody && _bodyFileDescriptor.isOpen())
+		_prepareBodyStream();
+	_sendingState = RESPONSE_SENDING_MESSAGE;
+}
+
+// Bytes of the head and in-memory body not yet sent
+size_t HttpResponse::bufferedRemaining() const
+{
+	if (_sendingState != RESPONSE_SENDING_MESSAGE)
+		return 0;
+	return _rawResponse.size() + _bufferedBodySize() - _sendOffset;
+}
+
+// Points up to BUFFERED_IOV_COUNT iovecs at the unsent head and in-memory body, at most allowance bytes in total
+size_t HttpResponse::gatherBuffered(struct iovec *iov, size_t allowance) const
+{
+	size_t headSize = _rawResponse.size();
+	size_t bodySize = _bufferedBodySize();
+	size_t count = 0;
+	if (_sendingState != RESPONSE_SENDING_MESSAGE)
+		return 0;
+	if (_sendOffset < headSize && allowance > 0)
+	{
+		iov[count].iov_base = const_cast<char *>(_rawResponse.data()) + _sendOffset;
+		iov[count].iov_len = std::min(headSize - _sendOffset, allowance);
+		allowance -= iov[count].iov_len;
+		++count;
+	}
+	if (bodySize > 0 && allowance > 0)
+	{
+		size_t bodyOffset = _sendOffset > headSize ? _sendOffset - headSize : 0;
+		iov[count].iov_base = const_cast<char *>(_body.data()) + bodyOffset;
+		iov[count].iov_len = std::min(bodySize - bodyOffset, allowance);
+		++count;
+	}
+	return count;
+}
+
+// Reads a small regular file body into memory so it can share a gathered write with the responses around it.
+// Anything unexpected leaves the body to the streaming path, which reports it.
+bool HttpResponse::inlineBody(size_t limit)
+{
+	if (_sendingState != RESPONSE_SENDING_MESSAGE || !_streamBody || !_sendfileBody ||
+		static_cast<size_t>(_bodyRemaining) > limit)
+		return false;
+	std::string body(static_cast<size_t>(_bodyRemaining), '\0');
+	size_t filled = 0;
+	while (filled < body.size())
+	{
+		ssize_t bytesRead = pread(_bodyFileDescriptor.getFd(), &body[filled], body.size() - filled, _bodyOffset + filled);
+		if (bytesRead < 0 && errno == EINTR)
+			continue;
+		if (bytesRead <= 0)
+			return false;
+		filled += static_cast<size_t>(bytesRead);
+	}
+	_body.swap(body);
+	_streamBody = false;
+	_sendfileBody = false;
+	_bodyRemaining = 0;
+	_bodyFileDescriptor = FileDescriptor();
+	return true;
+}
+
+// Blocks until the first length bytes of a file body are in the page cache, for callers that may wait on the disk
+void HttpResponse::prefetchBody(size_t length) const
+{
+	if (!_streamBody || _pipeBody || !_bodyFileDescriptor.isOpen())
+		return;
+	if (readahead(_bodyFileDescriptor.getFd(), 0, length) == -1)
+		Logger::debug("HttpResponse: readahead failed: " + std::string(strerror(errno)), __FILE__, __LINE__,
+					  __PRETTY_FUNCTION__);
+}
+
+// Accounts for bytes of a gathered write, never more than bufferedRemaining()
+void HttpResponse::consumeBuffered(size_t bytes)
+{
+	_sendOffset += bytes;
+	if (_sendOffset == _rawResponse.size() + _bufferedBodySize())
+		_sendingState = _streamBody ? RESPONSE_SENDING_BODY : RESPONSE_SENDING_COMPLETE;
+}
+
+// Sends until the response completes, fails, the socket would block (the caller then waits for the next EPOLLOUT
+// edge) or totalBytesSent reaches budget (the caller then yields the connection to the others for a turn)
+void HttpResponse::sendResponse(const FileDescriptor &clientFd, ssize_t &totalBytesSent, size_t budget)
+{
+	while (_sendingState != RESPONSE_SENDING_COMPLETE && _sendingState != RESPONSE_SENDING_ERROR)
+	{
+		if (static_cast<size_t>(totalBytesSent) >= budget)
+			return;
 		switch (_sendingState)
 		{
 		case RESPONSE_FORMATTING_MESSAGE:
-		{
-			// Translate response data into a http string format assume content type and length are set if needed
-			_rawResponse = _version + " " + StrUtils::toString(_statusCode) + " " + _statusMessage + "\r\n";
-			_version.clear();
-			_statusMessage.clear();
-			for (std::vector<Header>::const_iterator it = _headers.begin(); it != _headers.end(); ++it)
-			{
-				_rawResponse += it->getDirective() + ": " + it->getValues()[0] + "\r\n";
-			}
-			_rawResponse += "\r\n";
-			_headers.clear();
-			// Append body if its already in memory
-			if (!_streamBody)
-			{
-				_rawResponse += _body;
-				_body.clear();
-			}
-			_sendingState = RESPONSE_SENDING_MESSAGE;
+			formatMessage();
 			break;
-		}
 		case RESPONSE_SENDING_MESSAGE:
 		{
-			ssize_t sendBufferSize = HTTP::DEFAULT_SEND_SIZE - totalBytesSent;
-			if (sendBufferSize == 0)
-				return;
-			std::string bytesToSend = _rawResponse.substr(0, sendBufferSize);
-			ssize_t bytesSent = send(clientFd.getFd(), bytesToSend.c_str(), bytesToSend.length(), 0);
-			if (bytesSent > 0)
-			{
-				totalBytesSent += bytesSent;
-				_rawResponse = _rawResponse.substr(bytesSent);
-				if (_rawResponse.empty() && !_streamBody)
-					_sendingState = RESPONSE_SENDING_COMPLETE;
-				else if (_rawResponse.empty() && _streamBody) // Case body is being streamed, still more to send
-					_sendingState = RESPONSE_SENDING_BODY;
-			}
-			else
-				_sendingState = RESPONSE_SENDING_ERROR;
+			errno = 0;
+			_sendBuffered(clientFd.getFd(), totalBytesSent, budget);
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return; // Kernel buffer full
 			break;
 		}
 		case RESPONSE_SENDING_BODY:
@@ -416,24 +750,15 @@ void HttpResponse::sendResponse(const FileDescriptor &clientFd, ssize_t &totalBy
 				_sendingState = RESPONSE_SENDING_ERROR;
 				return;
 			}
-			std::string buffer;
-			ssize_t sendBufferSize = HTTP::DEFAULT_SEND_SIZE - totalBytesSent;
-			if (sendBufferSize == 0)
-				return;
-			buffer.resize(sendBufferSize); // Read the remaining bytes needed to send
-			ssize_t bytesRead = _bodyFileDescriptor.readFile(buffer);
-			if (bytesRead < 0)
-				_sendingState = RESPONSE_SENDING_ERROR;
-			else if (bytesRead == 0)
-				_sendingState = RESPONSE_SENDING_COMPLETE;
-			else if (bytesRead > 0)
-			{
-				ssize_t bytesSent = send(clientFd.getFd(), buffer.c_str(), buffer.length(), 0);
-				if (bytesSent > 0)
-					totalBytesSent += bytesSent;
-				else
-					_sendingState = RESPONSE_SENDING_ERROR;
-			}
+			errno = 0;
+			if (_pipeBody)
+				_spliceChunk(clientFd.getFd(), totalBytesSent, budget);
+			else if (_sendfileBody)
+				_sendfileChunk(clientFd.getFd(), totalBytesSent, budget);
+			else
+				_copyChunk(clientFd.getFd(), totalBytesSent, budget);
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return; // Kernel buffer full
 			break;
 		}
 		default:
@@ -442,4 +767,50 @@ void HttpResponse::sendResponse(const FileDescriptor &clientFd, ssize_t &totalBy
 	}
 }
 
+void HttpResponse::setRateLimit(size_t rate, size_t after)
+{
+	_limitRate = rate;
+	_limitRateAfter = after;
+	_rateTokens = 0;
+	_rateRefilledAt = 0;
+}
+
+// Bytes sent per wake-up: waking for less would cost a timer and a syscall per handful of bytes
+size_t HttpResponse::_rateWindow() const
+{
+	return std::max(_limitRate * HTTP::LIMIT_RATE_WINDOW_MS / 1000, static_cast<size_t>(1));
+}
+
+// Brings the bucket up to now and returns how many bytes may be sent. The refill clock only advances by the time
+// the credited bytes stand for, so rates that do not divide a millisecond lose nothing to rounding. The bucket holds
+// two windows so a wake-up a tick late still gets its full share.
+size_t HttpResponse::rateAllowance(uint64_t now)
+{
+	size_t window = _rateWindow();
+	if (_rateRefilledAt == 0)
+	{
+		_rateTokens = _limitRateAfter + window;
+		_rateRefilledAt = now;
+		return _rateTokens;
+	}
+	size_t capacity = 2 * window;
+	uint64_t accrued = (now - _rateRefilledAt) * _limitRate / 1000;
+	if (_rateTokens >= capacity || _rateTokens + accrued >= capacity)
+	{
+		_rateTokens = std::max(_rateTokens, capacity);
+		_rateRefilledAt = now;
+	}
+	else if (accrued > 0)
+	{
+		_rateTokens += accrued;
+		_rateRefilledAt += accrued * 1000 / _limitRate;
+	}
+	return _rateTokens;
+}
+
+void HttpResponse::chargeRate(size_t bytes)
+{
+	_rateTokens -= std::min(bytes, _rateTokens);
+}
+
 /* ************************************************************************** */
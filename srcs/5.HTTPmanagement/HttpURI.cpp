@@ -1,11 +1,28 @@
 #include "../../includes/HTTP/HttpURI.hpp"
+#include "../../includes/Global/CharScan.hpp"
 #include "../../includes/Global/Logger.hpp"
 #include "../../includes/Global/StrUtils.hpp"
 #include "../../includes/HTTP/HTTP.hpp"
 #include "../../includes/HTTP/HttpResponse.hpp"
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 
+namespace
+{
+// Next whitespace separated word of the request line from cursor on, as operator>> would read it
+bool nextWord(const std::string &line, size_t &cursor, size_t &offset, size_t &length)
+{
+	while (cursor < line.size() && CharScan::is(static_cast<unsigned char>(line[cursor]), CharScan::SPACE))
+		++cursor;
+	offset = cursor;
+	while (cursor < line.size() && !CharScan::is(static_cast<unsigned char>(line[cursor]), CharScan::SPACE))
+		++cursor;
+	length = cursor - offset;
+	return length != 0;
+}
+} // namespace
+
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
 */
@@ -14,12 +31,19 @@ HttpURI::HttpURI()
 {
 	_uriState = URI_PARSING;
 	_uriSize = 0;
+	_targetOffset = 0;
+	_targetLength = 0;
+	_versionOffset = 0;
+	_versionLength = 0;
 	_method.clear();
 	_URI.clear();
 	_rawURI.clear();
 	_version.clear();
+	_queryOffset = 0;
+	_queryLength = 0;
 	_queryParameters.clear();
 	_queryString.clear();
+	_queryParsed = true;
 }
 
 HttpURI::HttpURI(const HttpURI &other)
@@ -44,12 +68,20 @@ HttpURI &HttpURI::operator=(const HttpURI &other)
 	if (this != &other)
 	{
 		_uriState = other._uriState;
+		_requestLine = other._requestLine;
+		_targetOffset = other._targetOffset;
+		_targetLength = other._targetLength;
+		_versionOffset = other._versionOffset;
+		_versionLength = other._versionLength;
 		_method = other._method;
 		_URI = other._URI;
 		_rawURI = other._rawURI;
 		_version = other._version;
+		_queryOffset = other._queryOffset;
+		_queryLength = other._queryLength;
 		_queryParameters = other._queryParameters;
 		_queryString = other._queryString;
+		_queryParsed = other._queryParsed;
 		_uriSize = other._uriSize;
 	}
 	return *this;
@@ -57,13 +89,13 @@ HttpURI &HttpURI::operator=(const HttpURI &other)
 /*
 ** --------------------------------- METHODS ----------------------------------
 */
-void HttpURI::parseBuffer(std::vector<char> &buffer, HttpResponse &response)
+void HttpURI::parseBuffer(RingBuffer &buffer, HttpResponse &response)
 {
-	std::vector<char>::iterator it = std::search(buffer.begin(), buffer.end(), HTTP::CRLF, HTTP::CRLF + 2);
-	if (it == buffer.end())
+	size_t lineEnd = buffer.search(HTTP::CRLF, 2);
+	if (lineEnd == RingBuffer::npos)
 	{
 		// If it can't be found check that the buffer has not currently exceeded the size limit of a header
-		if (buffer.size() > HTTP::DEFAULT_CLIENT_MAX_REQUEST_LINE_SIZE)
+		if (buffer.readable() > HTTP::DEFAULT_CLIENT_MAX_REQUEST_LINE_SIZE)
 		{
 			response.setResponseDefaultBody(413, "Request URI Too Large", NULL, NULL, HttpResponse::FATAL_ERROR);
 			Logger::debug("URI size limit exceeded", __FILE__, __LINE__, __PRETTY_FUNCTION__);
@@ -75,34 +107,38 @@ void HttpURI::parseBuffer(std::vector<char> &buffer, HttpResponse &response)
 	}
 
 	// Extract request line up to the CLRF
-	std::string requestLine(buffer.begin(), it);
-	if (requestLine.size() + 2 > HTTP::DEFAULT_CLIENT_MAX_REQUEST_LINE_SIZE)
+	if (lineEnd + 2 > HTTP::DEFAULT_CLIENT_MAX_REQUEST_LINE_SIZE)
 	{
 		response.setResponseDefaultBody(413, "Request URI Too Large", NULL, NULL, HttpResponse::FATAL_ERROR);
 		Logger::debug("URI size limit exceeded", __FILE__, __LINE__, __PRETTY_FUNCTION__);
 		_uriState = URI_PARSING_ERROR;
 		return;
 	}
-	_uriSize = requestLine.size() + 2;
+	_uriSize = lineEnd + 2;
+	// Keeps its capacity across the requests of a connection
+	_requestLine.assign(buffer.data(), lineEnd);
 	// Clear buffer up to the CLRF
-	buffer.erase(buffer.begin(), it + 2);
+	buffer.consume(lineEnd + 2);
 
 	// Parse request line
-	std::istringstream stream(requestLine);
-
-	if (!(stream >> _method >> _URI >> _version))
+	size_t cursor = 0;
+	size_t methodOffset;
+	size_t methodLength;
+	if (!nextWord(_requestLine, cursor, methodOffset, methodLength) ||
+		!nextWord(_requestLine, cursor, _targetOffset, _targetLength) ||
+		!nextWord(_requestLine, cursor, _versionOffset, _versionLength))
 	{
-		Logger::debug("Invalid request line: " + requestLine, __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		Logger::debug("Invalid request line: " + _requestLine, __FILE__, __LINE__, __PRETTY_FUNCTION__);
 		_uriState = URI_PARSING_ERROR;
-		response.setResponseDefaultBody(400, "Invalid request line: " + requestLine, NULL, NULL,
+		response.setResponseDefaultBody(400, "Invalid request line: " + _requestLine, NULL, NULL,
 										HttpResponse::FATAL_ERROR);
 		return;
 	}
-
-	_rawURI = _URI;
+	_method.assign(_requestLine, methodOffset, methodLength);
+	_URI.assign(_requestLine, _targetOffset, _targetLength);
 
 	// Validate URI
-	if (_URI.empty() || _URI[0] != '/')
+	if (_URI[0] != '/')
 	{
 		Logger::debug("Invalid URI: " + _URI, __FILE__, __LINE__, __PRETTY_FUNCTION__);
 		_uriState = URI_PARSING_ERROR;
@@ -111,11 +147,11 @@ void HttpURI::parseBuffer(std::vector<char> &buffer, HttpResponse &response)
 	}
 
 	// Validate version
-	if (_version != "HTTP/1.1")
+	if (_requestLine.compare(_versionOffset, _versionLength, HTTP::HTTP_VERSION) != 0)
 	{
-		Logger::debug("Unsupported HTTP version: " + _version, __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		Logger::debug("Unsupported HTTP version: " + getVersion(), __FILE__, __LINE__, __PRETTY_FUNCTION__);
 		_uriState = URI_PARSING_ERROR;
-		response.setResponseDefaultBody(505, "HTTP Version Not Supported: " + _version, NULL, NULL,
+		response.setResponseDefaultBody(505, "HTTP Version Not Supported: " + getVersion(), NULL, NULL,
 										HttpResponse::FATAL_ERROR);
 		return;
 	}
@@ -123,57 +159,52 @@ void HttpURI::parseBuffer(std::vector<char> &buffer, HttpResponse &response)
 	_uriState = URI_PARSING_COMPLETE;
 }
 
+// The path is normalised where it lies in _URI and joined to the root on the stack, a clean path costs no allocation
+// once _URI has grown to hold resolved paths
 void HttpURI::sanitizeURI(const Server *server, const Location *location, HttpResponse &response)
 {
-	std::string path;
-	// 1. Seperate the URI into the path and the query parameters
+	// 1. Seperate the URI into the path and the query, the query is only split into parameters when asked for
 	size_t queryPos = _URI.find('?');
 	if (queryPos != std::string::npos)
 	{
-		path = _URI.substr(0, queryPos);
-		_queryString = _URI.substr(queryPos + 1);
+		const char *target = _requestLine.data() + _targetOffset;
+		const char *query = static_cast<const char *>(std::memchr(target, '?', _targetLength));
+		if (query != NULL)
+		{
+			_queryOffset = query + 1 - _requestLine.data();
+			_queryLength = target + _targetLength - (query + 1);
+			_queryString.clear();
+			_queryParameters.clear();
+			_queryParsed = false;
+		}
+		_URI.resize(queryPos);
 	}
-	else
+
+	// 2. Decode, collapse slashes and resolve dot segments in one pass
+	if (!StrUtils::normalizeUriPath(_URI))
 	{
-		path = _URI;
+		_uriState = URI_PARSING_ERROR;
+		Logger::debug("Path climbs above root: " + getRawURI(), __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		response.setResponseDefaultBody(403, "Forbidden", NULL, NULL, HttpResponse::FATAL_ERROR);
+		return;
 	}
 
-	// 2. Seperate query parameters into tokens
-	std::string token;
-	std::istringstream stream(_queryString);
-	while (getline(stream, token, '&'))
+	// 3. Combine path and root path
+	const std::string &root =
+		(location && !location->getRoot().empty()) ? location->getRoot() : server->getRootPath();
+	char joined[PATH_MAX];
+	bool fits = root.size() + _URI.size() < sizeof(joined);
+	if (fits)
 	{
-		// Seperate into key and value
-		size_t keyPos = token.find('=');
-		std::string key = token.substr(0, keyPos);
-		std::string value = token.substr(keyPos + 1);
-
-		// Decode key and value
-		key = StrUtils::percentDecode(key);
-		value = StrUtils::percentDecode(value);
-
-		// Add to query parameters
-		_queryParameters[key].push_back(value);
+		std::memcpy(joined, root.data(), root.size());
+		std::memcpy(joined + root.size(), _URI.data(), _URI.size());
+		joined[root.size() + _URI.size()] = '\0';
 	}
 
-	// 3. Sanitize path
-	path = StrUtils::percentDecode(path);
-
-	// 4. Combine path and root path
-	std::string root;
-	if (location && !location->getRoot().empty())
-		root = location->getRoot();
-	else
-		root = server->getRootPath();
-
-	std::string fullPath = root;
-	if (!root.empty() && root[root.size() - 1] != '/' && path[0] != '/')
-		fullPath += "/";
-	fullPath += path;
-
 	char resolvedPath[PATH_MAX];
-	if (realpath(fullPath.c_str(), resolvedPath) == NULL)
+	if (!fits || realpath(joined, resolvedPath) == NULL)
 	{
+		std::string fullPath = root + _URI;
 		size_t lastSlash = fullPath.find_last_of('/');
 		std::string directoryPath;
 		if (lastSlash != std::string::npos)
@@ -217,7 +248,7 @@ void HttpURI::sanitizeURI(const Server *server, const Location *location, HttpRe
 		return;
 	}
 
-	if (std::string(resolvedPath).compare(0, root.size(), root) != 0)
+	if (std::strncmp(resolvedPath, root.c_str(), root.size()) != 0)
 	{
 		_uriState = URI_PARSING_ERROR;
 		Logger::debug("Resolved path escapes root: " + std::string(resolvedPath), __FILE__, __LINE__,
@@ -241,6 +272,8 @@ const std::string &HttpURI::getURI() const
 
 const std::string &HttpURI::getVersion() const
 {
+	if (_version.empty() && _versionLength != 0)
+		_version.assign(_requestLine, _versionOffset, _versionLength);
 	return _version;
 }
 
@@ -261,11 +294,32 @@ const std::string &HttpURI::getMethod() const
 
 const std::map<std::string, std::vector<std::string> > &HttpURI::getQueryParameters() const
 {
+	if (_queryParsed)
+		return _queryParameters;
+	_queryParsed = true;
+	std::string token;
+	std::istringstream stream(getQueryString());
+	while (getline(stream, token, '&'))
+	{
+		// Seperate into key and value
+		size_t keyPos = token.find('=');
+		std::string key = token.substr(0, keyPos);
+		std::string value = token.substr(keyPos + 1);
+
+		// Decode key and value
+		key = StrUtils::percentDecode(key);
+		value = StrUtils::percentDecode(value);
+
+		// Add to query parameters
+		_queryParameters[key].push_back(value);
+	}
 	return _queryParameters;
 }
 
 const std::string &HttpURI::getQueryString() const
 {
+	if (_queryString.empty() && _queryLength != 0)
+		_queryString.assign(_requestLine, _queryOffset, _queryLength);
 	return _queryString;
 }
 
@@ -276,15 +330,25 @@ const std::string &HttpURI::getQueryString() const
 void HttpURI::reset()
 {
 	_uriState = URI_PARSING;
+	_requestLine.clear();
+	_targetOffset = 0;
+	_targetLength = 0;
+	_versionOffset = 0;
+	_versionLength = 0;
 	_method.clear();
 	_URI.clear();
 	_rawURI.clear();
 	_version.clear();
+	_queryOffset = 0;
+	_queryLength = 0;
 	_queryParameters.clear();
 	_queryString.clear();
+	_queryParsed = true;
 }
 
 const std::string &HttpURI::getRawURI() const
 {
+	if (_rawURI.empty() && _targetLength != 0)
+		_rawURI.assign(_requestLine, _targetOffset, _targetLength);
 	return _rawURI;
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "../../includes/HTTP/KnownHeaders.hpp"
+
+namespace
+{
+struct Entry
+{
+	const char *name;
+	size_t length;
+	bool singleton;
+};
+
+// Indexed by KnownHeaders::Id
+const Entry ENTRIES[KnownHeaders::COUNT] = {{"host", 4, true},
+											{"content-length", 14, true},
+											{"transfer-encoding", 17, false},
+											{"connection", 10, false},
+											{"content-type", 12, true},
+											{"content-location", 16, true},
+											{"date", 4, true},
+											{"etag", 4, true},
+											{"expires", 7, true},
+											{"last-modified", 13, true},
+											{"location", 8, true},
+											{"server", 6, true},
+											{"user-agent", 10, true},
+											{"referer", 7, true},
+											{"authorization", 13, true},
+											{"proxy-authorization", 19, true},
+											{"expect", 6, true},
+											{"upgrade", 7, true},
+											{"retry-after", 11, true},
+											{"content-range", 13, true},
+											{"accept", 6, false},
+											{"accept-encoding", 15, false},
+											{"accept-language", 15, false},
+											{"cookie", 6, false},
+											{"set-cookie", 10, false},
+											{"cache-control", 13, false},
+											{"keep-alive", 10, false},
+											{"range", 5, false},
+											{"if-modified-since", 17, false},
+											{"if-none-match", 13, false},
+											{"te", 2, false},
+											{"vary", 4, false}};
+
+const size_t SLOT_COUNT = 64;
+
+// Generated offline: hash() below puts every name of ENTRIES in its own slot. A name added to the registry needs
+// the multipliers searched again.
+const KnownHeaders::Id SLOTS[SLOT_COUNT] = {
+	KnownHeaders::EXPIRES, KnownHeaders::CONTENT_LOCATION, KnownHeaders::CONTENT_LENGTH, KnownHeaders::UNKNOWN,
+	KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::CONTENT_TYPE, KnownHeaders::UNKNOWN,
+	KnownHeaders::UNKNOWN, KnownHeaders::CONTENT_RANGE, KnownHeaders::LOCATION, KnownHeaders::SET_COOKIE,
+	KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN,
+	KnownHeaders::USER_AGENT, KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::AUTHORIZATION,
+	KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN,
+	KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::REFERER, KnownHeaders::VARY,
+	KnownHeaders::ACCEPT_ENCODING, KnownHeaders::IF_NONE_MATCH, KnownHeaders::LAST_MODIFIED, KnownHeaders::UNKNOWN,
+	KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::PROXY_AUTHORIZATION,
+	KnownHeaders::UNKNOWN, KnownHeaders::ACCEPT_LANGUAGE, KnownHeaders::CONNECTION, KnownHeaders::UPGRADE,
+	KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::RANGE, KnownHeaders::COOKIE,
+	KnownHeaders::UNKNOWN, KnownHeaders::TRANSFER_ENCODING, KnownHeaders::RETRY_AFTER, KnownHeaders::UNKNOWN,
+	KnownHeaders::IF_MODIFIED_SINCE, KnownHeaders::CACHE_CONTROL, KnownHeaders::UNKNOWN, KnownHeaders::HOST,
+	KnownHeaders::ACCEPT, KnownHeaders::KEEP_ALIVE, KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN,
+	KnownHeaders::EXPECT, KnownHeaders::SERVER, KnownHeaders::TE, KnownHeaders::ETAG,
+	KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::UNKNOWN, KnownHeaders::DATE};
+
+unsigned char lower(char c)
+{
+	unsigned char uc = static_cast<unsigned char>(c);
+	return (uc >= 'A' && uc <= 'Z') ? uc + ('a' - 'A') : uc;
+}
+
+// Length, first, middle and last byte are enough to tell the registry's names apart
+size_t hash(const char *name, size_t length)
+{
+	return (length * 3 + lower(name[0]) * 17 + lower(name[length - 1]) * 63 + lower(name[length / 2])) %
+		   SLOT_COUNT;
+}
+} // namespace
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+KnownHeaders::Id KnownHeaders::lookup(const char *name, size_t length)
+{
+	if (length < 2 || length > 19) // shortest and longest names of the registry
+		return UNKNOWN;
+	Id id = SLOTS[hash(name, length)];
+	if (id == UNKNOWN || ENTRIES[id].length != length)
+		return UNKNOWN;
+	for (size_t i = 0; i < length; ++i)
+		if (lower(name[i]) != static_cast<unsigned char>(ENTRIES[id].name[i]))
+			return UNKNOWN;
+	return id;
+}
+
+KnownHeaders::Id KnownHeaders::lookup(const std::string &name)
+{
+	return lookup(name.data(), name.size());
+}
+
+const char *KnownHeaders::name(Id id)
+{
+	return id < COUNT ? ENTRIES[id].name : "";
+}
+
+bool KnownHeaders::isSingleton(Id id)
+{
+	return id < COUNT && ENTRIES[id].singleton;
+}
+
+/* ************************************************************************** */
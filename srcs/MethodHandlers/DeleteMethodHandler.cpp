@@ -65,6 +65,14 @@ bool DeleteMethodHandler::canHandle(const std::string &method) const
 	return method == "DELETE";
 }
 
+// unlink() of a large file frees its extents before returning
+bool DeleteMethodHandler::canOffload(const HttpRequest &request, const Location *location) const
+{
+	(void)request;
+	(void)location;
+	return true;
+}
+
 bool DeleteMethodHandler::deleteFile(const std::string &filePath, HttpResponse &response, const Server *server,
 									 const Location *location)
 {
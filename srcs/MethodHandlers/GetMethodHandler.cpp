@@ -116,6 +116,14 @@ bool GetMethodHandler::canHandle(const std::string &method) const
 	return method == "GET";
 }
 
+// stat() of the path and its indexes, open() of the file or a directory listing
+bool GetMethodHandler::canOffload(const HttpRequest &request, const Location *location) const
+{
+	(void)request;
+	(void)location;
+	return true;
+}
+
 bool GetMethodHandler::serveFile(const std::string &filePath, HttpResponse &response, const Server *server,
 								 const Location *location)
 {
@@ -50,6 +50,12 @@ bool PostMethodHandler::canHandle(const std::string &method) const
 	return method == "POST";
 }
 
+// A CGI is spawned and streamed by the event loop, only plain uploads are written from an I/O thread
+bool PostMethodHandler::canOffload(const HttpRequest &request, const Location *location) const
+{
+	return !isCgiRequest(request.getUri(), location);
+}
+
 bool PostMethodHandler::handleCgiRequest(const HttpRequest &request, HttpResponse &response, const Server *server,
 										 const Location *location)
 {
@@ -163,7 +169,7 @@ bool PostMethodHandler::handleFileUpload(const HttpRequest &request, HttpRespons
 	return true;
 }
 
-bool PostMethodHandler::isCgiRequest(const std::string &uri, const Location *location)
+bool PostMethodHandler::isCgiRequest(const std::string &uri, const Location *location) const
 {
 	if (!location->hasCgiPath())
 		return false;
@@ -101,6 +101,14 @@ bool PutMethodHandler::canHandle(const std::string &method) const
 	return method == "PUT";
 }
 
+// Creating the directories and writing the whole body
+bool PutMethodHandler::canOffload(const HttpRequest &request, const Location *location) const
+{
+	(void)request;
+	(void)location;
+	return true;
+}
+
 bool PutMethodHandler::_ensureDirectory(const std::string &filePath) const
 {
 	size_t slashPos = filePath.find_last_of('/');
@@ -0,0 +1,306 @@
+#include "../../includes/Global/CharScan.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CHARSCAN_X86 1
+#endif
+
+namespace
+{
+const unsigned char C = CharScan::CONTROL;
+const unsigned char S = CharScan::SPACE;
+const unsigned char T = CharScan::TOKEN;
+const unsigned char W = CharScan::CONFIG_WORD;
+const unsigned char D = CharScan::DIGIT;
+} // namespace
+
+const unsigned char CharScan::CLASSES[256] = {
+	C, C, C, C, C, C, C, C, C, C|S, C|S, C|S, C|S, C|S, C, C, // 0x00
+	C, C, C, C, C, C, C, C, C, C, C, C, C, C, C, C, // 0x10
+	S, T, 0, T, T|W, T, T, T, 0, 0, T, T, 0, T|W, T|W, T|W, // 0x20
+	T|W|D, T|W|D, T|W|D, T|W|D, T|W|D, T|W|D, T|W|D, T|W|D, T|W|D, T|W|D, W, 0, 0, W, 0, 0, // 0x30
+	0, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, // 0x40
+	T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, W, 0, W, T, T|W, // 0x50
+	T, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, // 0x60
+	T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, T|W, 0, T, 0, T, C, // 0x70
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x80
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x90
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xA0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xB0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xC0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xD0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xE0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xF0
+};
+
+namespace
+{
+typedef const char *(*Scanner)(const char *begin, const char *end);
+
+/*
+** ---------------------------------- SCALAR ----------------------------------
+*/
+
+// memchr() already runs vectorised in libc, only the candidates are checked
+const char *findCrlfScalar(const char *begin, const char *end)
+{
+	while (end - begin >= 2)
+	{
+		const char *cr = static_cast<const char *>(std::memchr(begin, '\r', end - begin - 1));
+		if (cr == NULL)
+			break;
+		if (cr[1] == '\n')
+			return cr;
+		begin = cr + 1;
+	}
+	return end;
+}
+
+const char *findControlScalar(const char *begin, const char *end)
+{
+	while (begin != end && !CharScan::is(static_cast<unsigned char>(*begin), CharScan::CONTROL))
+		++begin;
+	return begin;
+}
+
+const char *findUriSpecialScalar(const char *begin, const char *end)
+{
+	for (; begin != end; ++begin)
+		if (*begin == '%' || *begin == '+' ||
+			(*begin == '/' && end - begin >= 2 && (begin[1] == '/' || begin[1] == '.')))
+			return begin;
+	return end;
+}
+
+#ifdef CHARSCAN_X86
+
+/*
+** ----------------------------------- SSE2 -----------------------------------
+*/
+
+// A CR whose next byte is LF: the block is compared once as loaded and once shifted by a byte
+__attribute__((target("sse2"))) const char *findCrlfSse2(const char *begin, const char *end)
+{
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	while (end - begin >= 17)
+	{
+		__m128i here = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+		__m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin + 1));
+		int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(here, cr), _mm_cmpeq_epi8(next, lf)));
+		if (mask != 0)
+			return begin + __builtin_ctz(mask);
+		begin += 16;
+	}
+	return findCrlfScalar(begin, end);
+}
+
+// Unsigned byte <= 0x1F is min(byte, 0x1F) == byte, DEL is compared on its own
+__attribute__((target("sse2"))) const char *findControlSse2(const char *begin, const char *end)
+{
+	const __m128i unitSeparator = _mm_set1_epi8(0x1F);
+	const __m128i del = _mm_set1_epi8(0x7F);
+	while (end - begin >= 16)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+		__m128i low = _mm_cmpeq_epi8(_mm_min_epu8(block, unitSeparator), block);
+		int mask = _mm_movemask_epi8(_mm_or_si128(low, _mm_cmpeq_epi8(block, del)));
+		if (mask != 0)
+			return begin + __builtin_ctz(mask);
+		begin += 16;
+	}
+	return findControlScalar(begin, end);
+}
+
+__attribute__((target("sse2"))) const char *findUriSpecialSse2(const char *begin, const char *end)
+{
+	const __m128i percent = _mm_set1_epi8('%');
+	const __m128i plus = _mm_set1_epi8('+');
+	const __m128i dot = _mm_set1_epi8('.');
+	const __m128i slash = _mm_set1_epi8('/');
+	while (end - begin >= 17)
+	{
+		__m128i here = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+		__m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin + 1));
+		__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(here, percent), _mm_cmpeq_epi8(here, plus));
+		__m128i nextSlashOrDot = _mm_or_si128(_mm_cmpeq_epi8(next, slash), _mm_cmpeq_epi8(next, dot));
+		hit = _mm_or_si128(hit, _mm_and_si128(_mm_cmpeq_epi8(here, slash), nextSlashOrDot));
+		int mask = _mm_movemask_epi8(hit);
+		if (mask != 0)
+			return begin + __builtin_ctz(mask);
+		begin += 16;
+	}
+	return findUriSpecialScalar(begin, end);
+}
+
+/*
+** ----------------------------------- AVX2 -----------------------------------
+*/
+
+__attribute__((target("avx2"))) const char *findCrlfAvx2(const char *begin, const char *end)
+{
+	const __m256i cr = _mm256_set1_epi8('\r');
+	const __m256i lf = _mm256_set1_epi8('\n');
+	while (end - begin >= 33)
+	{
+		__m256i here = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+		__m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + 1));
+		unsigned mask = static_cast<unsigned>(
+			_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(here, cr), _mm256_cmpeq_epi8(next, lf))));
+		if (mask != 0)
+			return begin + __builtin_ctz(mask);
+		begin += 32;
+	}
+	// The SSE2 tail is not VEX encoded: without this the dirty upper halves cost a state transition per call
+	_mm256_zeroupper();
+	return findCrlfSse2(begin, end);
+}
+
+__attribute__((target("avx2"))) const char *findControlAvx2(const char *begin, const char *end)
+{
+	const __m256i unitSeparator = _mm256_set1_epi8(0x1F);
+	const __m256i del = _mm256_set1_epi8(0x7F);
+	while (end - begin >= 32)
+	{
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+		__m256i low = _mm256_cmpeq_epi8(_mm256_min_epu8(block, unitSeparator), block);
+		unsigned mask =
+			static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(low, _mm256_cmpeq_epi8(block, del))));
+		if (mask != 0)
+			return begin + __builtin_ctz(mask);
+		begin += 32;
+	}
+	_mm256_zeroupper();
+	return findControlSse2(begin, end);
+}
+
+__attribute__((target("avx2"))) const char *findUriSpecialAvx2(const char *begin, const char *end)
+{
+	const __m256i percent = _mm256_set1_epi8('%');
+	const __m256i plus = _mm256_set1_epi8('+');
+	const __m256i dot = _mm256_set1_epi8('.');
+	const __m256i slash = _mm256_set1_epi8('/');
+	while (end - begin >= 33)
+	{
+		__m256i here = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+		__m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + 1));
+		__m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(here, percent), _mm256_cmpeq_epi8(here, plus));
+		__m256i nextSlashOrDot = _mm256_or_si256(_mm256_cmpeq_epi8(next, slash), _mm256_cmpeq_epi8(next, dot));
+		hit = _mm256_or_si256(hit, _mm256_and_si256(_mm256_cmpeq_epi8(here, slash), nextSlashOrDot));
+		unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+		if (mask != 0)
+			return begin + __builtin_ctz(mask);
+		begin += 32;
+	}
+	_mm256_zeroupper();
+	return findUriSpecialSse2(begin, end);
+}
+
+#endif
+
+/*
+** --------------------------------- DISPATCH ---------------------------------
+*/
+
+struct Kernels
+{
+	Scanner findCrlf;
+	Scanner findControl;
+	Scanner findUriSpecial;
+	const char *name;
+};
+
+Kernels selectKernels()
+{
+	Kernels kernels;
+	kernels.findCrlf = findCrlfScalar;
+	kernels.findControl = findControlScalar;
+	kernels.findUriSpecial = findUriSpecialScalar;
+	kernels.name = "scalar";
+#ifdef CHARSCAN_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		kernels.findCrlf = findCrlfAvx2;
+		kernels.findControl = findControlAvx2;
+		kernels.findUriSpecial = findUriSpecialAvx2;
+		kernels.name = "avx2";
+	}
+	else if (__builtin_cpu_supports("sse2"))
+	{
+		kernels.findCrlf = findCrlfSse2;
+		kernels.findControl = findControlSse2;
+		kernels.findUriSpecial = findUriSpecialSse2;
+		kernels.name = "sse2";
+	}
+#endif
+	return kernels;
+}
+
+// Chosen during static initialisation, before any thread exists, and never written again
+const Kernels g_kernels = selectKernels();
+} // namespace
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+const char *CharScan::findCrlf(const char *begin, const char *end)
+{
+	return g_kernels.findCrlf(begin, end);
+}
+
+// "\r\n\r\n": every CRLF is a candidate, the bytes after it decide
+const char *CharScan::findDoubleCrlf(const char *begin, const char *end)
+{
+	while (true)
+	{
+		const char *crlf = g_kernels.findCrlf(begin, end);
+		if (end - crlf < 4)
+			return end;
+		if (crlf[2] == '\r' && crlf[3] == '\n')
+			return crlf;
+		begin = crlf + 2;
+	}
+}
+
+const char *CharScan::findControl(const char *begin, const char *end)
+{
+	return g_kernels.findControl(begin, end);
+}
+
+const char *CharScan::findUriSpecial(const char *begin, const char *end)
+{
+	return g_kernels.findUriSpecial(begin, end);
+}
+
+const char *CharScan::findHeaderEnd(const char *begin, const char *end, size_t &separatorLength)
+{
+	const char *found = findDoubleCrlf(begin, end);
+	if (found != end)
+	{
+		separatorLength = 4;
+		return found;
+	}
+	for (const char *lf = begin; end - lf >= 2; ++lf)
+	{
+		lf = static_cast<const char *>(std::memchr(lf, '\n', end - lf - 1));
+		if (lf == NULL)
+			break;
+		if (lf[1] == '\n')
+		{
+			separatorLength = 2;
+			return lf;
+		}
+	}
+	separatorLength = 0;
+	return end;
+}
+
+const char *CharScan::kernelName()
+{
+	return g_kernels.name;
+}
+
+/* ************************************************************************** */
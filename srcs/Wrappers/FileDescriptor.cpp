@@ -7,8 +7,12 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sstream>
 #include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -181,6 +185,61 @@ bool FileDescriptor::setReuseAddr()
 	return true;
 }
 
+// Lets several sockets (one per worker process) bind the same address; the kernel load balances between them
+bool FileDescriptor::setReusePort()
+{
+	int opt = 1;
+	if (setsockopt(_ctrl->fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == -1)
+	{
+		Logger::error("FileDescriptor: Failed to set SO_REUSEPORT: " + std::string(strerror(errno)), __FILE__, __LINE__,
+					  __PRETTY_FUNCTION__);
+		return false;
+	}
+	return true;
+}
+
+// Integer socket options, name is only used in the log line
+bool FileDescriptor::setIntOption(int level, int option, int value, const char *name)
+{
+	if (setsockopt(_ctrl->fd, level, option, &value, sizeof(value)) == -1)
+	{
+		Logger::error("FileDescriptor: Failed to set " + std::string(name) + ": " + std::string(strerror(errno)),
+					  __FILE__, __LINE__, __PRETTY_FUNCTION__);
+		return false;
+	}
+	return true;
+}
+
+// Small writes leave at once instead of waiting for the ACK of the previous segment
+bool FileDescriptor::setNoDelay()
+{
+	return setIntOption(IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+}
+
+// Holds back partial segments until unsetCork(), so a head and the start of its file body share packets
+bool FileDescriptor::setCork()
+{
+	return setIntOption(IPPROTO_TCP, TCP_CORK, 1, "TCP_CORK");
+}
+
+// Pushes out whatever the cork held back
+bool FileDescriptor::unsetCork()
+{
+	return setIntOption(IPPROTO_TCP, TCP_CORK, 0, "TCP_CORK");
+}
+
+// Gives up ownership without closing: every copy sharing this descriptor is invalidated and the caller becomes
+// responsible for the raw fd (used to hand accepted sockets to another thread)
+int FileDescriptor::release()
+{
+	if (!_ctrl)
+		return -1;
+	int fd = _ctrl->fd;
+	_ctrl->fd = -1;
+	closeDescriptor();
+	return fd;
+}
+
 /*
 ** --------------------------------- COMPARATOR
 *---------------------------------
@@ -467,6 +526,21 @@ ssize_t FileDescriptor::writeFile(const std::vector<char> &buffer, std::vector<c
 	return bytesWritten;
 }
 
+ssize_t FileDescriptor::writeFile(const char *data, size_t len)
+{
+	if (len == 0)
+		return 0;
+	ssize_t bytesWritten = write(_ctrl->fd, data, len);
+	if (bytesWritten == -1)
+	{
+		std::stringstream ss;
+		ss << "FileDescriptor: Failed to write file: " << strerror(errno);
+		Logger::log(Logger::ERROR, ss.str());
+		throw std::runtime_error(ss.str());
+	}
+	return bytesWritten;
+}
+
 /*
 ** --------------------------------- SOCKET OPERATIONS
 *---------------------------------
@@ -656,13 +730,14 @@ FileDescriptor FileDescriptor::createSocket(int domain, int type, int protocol)
 
 // Facilates the acceptance of a new connection from a listening socket returns the new file descriptor
 // WARNING: overwrites the passed in SocketAddress with information from the accepted connection
-FileDescriptor FileDescriptor::createFromAccept(int sockfd, SocketAddress &remoteAddress)
+// flags are the accept4() flags (SOCK_NONBLOCK, SOCK_CLOEXEC) so the new socket needs no follow-up fcntl
+FileDescriptor FileDescriptor::createFromAccept(int sockfd, SocketAddress &remoteAddress, int flags)
 {
 	errno = 0;
 	struct sockaddr_storage address; // supports both IPv4 and IPv6
 	socklen_t addrlen = sizeof(address);
 
-	int fd = accept(sockfd, (struct sockaddr *)&address, &addrlen);
+	int fd = accept4(sockfd, (struct sockaddr *)&address, &addrlen, flags);
 	if (fd == -1)
 		return FileDescriptor();
 	remoteAddress = SocketAddress(address, addrlen);
@@ -751,4 +826,38 @@ FileDescriptor FileDescriptor::createEpoll(int flags)
 	return FileDescriptor(fd);
 }
 
+// Counter fd used to wake another thread's epoll loop (write 8 bytes to signal, read them back to reset)
+FileDescriptor FileDescriptor::createEventFd(unsigned int initval, int flags)
+{
+	int fd = eventfd(initval, flags);
+	if (fd == -1)
+	{
+		std::stringstream ss;
+		ss << "FileDescriptor: Failed to create eventfd: " << strerror(errno);
+		Logger::log(Logger::ERROR, ss.str());
+		throw std::runtime_error(ss.str());
+	}
+	return FileDescriptor(fd);
+}
+
+// Reads the signals in mask as signalfd_siginfo records, the caller blocks them so they are not delivered otherwise
+FileDescriptor FileDescriptor::createSignalFd(const sigset_t &mask, int flags)
+{
+	int fd = signalfd(-1, &mask, flags);
+	if (fd == -1)
+	{
+		std::stringstream ss;
+		ss << "FileDescriptor: Failed to create signalfd: " << strerror(errno);
+		Logger::log(Logger::ERROR, ss.str());
+		throw std::runtime_error(ss.str());
+	}
+	return FileDescriptor(fd);
+}
+
+// Takes ownership of a descriptor previously handed over with release()
+FileDescriptor FileDescriptor::createFromRaw(int fd)
+{
+	return FileDescriptor(fd);
+}
+
 /* ************************************************************************** */
@@ -153,6 +153,13 @@ void FileManager::append(const std::vector<char> &buffer, std::vector<char>::ite
 	_fd.writeFile(buffer, start, end);
 }
 
+void FileManager::append(const char *data, size_t len)
+{
+	if (!_instantiated)
+		instantiate();
+	_fd.writeFile(data, len);
+}
+
 void FileManager::reset()
 {
 	unlink(_filePath.c_str());
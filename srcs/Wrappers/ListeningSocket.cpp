@@ -3,15 +3,22 @@
 #include "../../includes/Global/StrUtils.hpp"
 #include <cstring>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sstream>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
 */
 
-ListeningSocket::ListeningSocket() : _socketAddress(SocketAddress())
+ListenOptions::ListenOptions() : backlog(SOMAXCONN), rcvbuf(0), sndbuf(0), deferAccept(0), fastOpen(0), reusePort(false),
+	  mode(0666)
+{
+}
+
+ListeningSocket::ListeningSocket() : _socketAddress(SocketAddress()), _reusePort(false), _shared(false), _listening(false)
 {
 }
 
@@ -20,7 +27,8 @@ ListeningSocket::ListeningSocket(const ListeningSocket &src)
 	*this = src;
 }
 
-ListeningSocket::ListeningSocket(const SocketAddress &socketAddress) : _socketAddress(socketAddress)
+ListeningSocket::ListeningSocket(const SocketAddress &socketAddress)
+	: _socketAddress(socketAddress), _reusePort(false), _shared(false), _listening(false)
 {
 	_bindFd = FileDescriptor::createSocket(socketAddress.getFamily(), SOCK_STREAM, 0);
 	if (!_bindFd.isValid())
@@ -46,6 +54,10 @@ ListeningSocket &ListeningSocket::operator=(ListeningSocket const &rhs)
 	{
 		_socketAddress = rhs._socketAddress;
 		_bindFd = rhs._bindFd;
+		_options = rhs._options;
+		_reusePort = rhs._reusePort;
+		_shared = rhs._shared;
+		_listening = rhs._listening;
 	}
 	return *this;
 }
@@ -62,20 +74,100 @@ std::ostream &operator<<(std::ostream &o, ListeningSocket const &i)
 
 void ListeningSocket::bind()
 {
+	// Socket options only apply to the bind if they are set before it. A unix socket path is never shared, the file
+	// left behind by a previous run is removed instead.
+	if (_socketAddress.isUnix())
+		_removeStaleSocket();
+	else
+	{
+		_bindFd.setReuseAddr();
+		if ((_reusePort || _options.reusePort) && !_bindFd.setReusePort())
+			throw std::runtime_error("Failed to set SO_REUSEPORT: current Fd: " +
+									 StrUtils::toString(_bindFd.getFd()) + " error: " + std::string(strerror(errno)));
+	}
+	// Buffer sizes must be known before the handshake to pick the window scale, tuning failures are only logged
+	if (_options.rcvbuf > 0)
+		_bindFd.setIntOption(SOL_SOCKET, SO_RCVBUF, _options.rcvbuf, "SO_RCVBUF");
+	if (_options.sndbuf > 0)
+		_bindFd.setIntOption(SOL_SOCKET, SO_SNDBUF, _options.sndbuf, "SO_SNDBUF");
 	errno = 0;
 	if (::bind(_bindFd.getFd(), reinterpret_cast<const struct sockaddr *>(_socketAddress.getSockAddr()),
 			   _socketAddress.getSize()) == -1)
 		throw std::runtime_error("Failed to bind socket: current Fd: " + StrUtils::toString(_bindFd.getFd()) +
 								 " error: " + std::string(strerror(errno)));
-	_bindFd.setReuseAddr();
+	// bind() creates the file under the umask, the proxy's user may need more than that
+	if (_socketAddress.isUnix() && chmod(_socketAddress.getHost().c_str(), _options.mode) == -1)
+		Logger::warning("ListeningSocket: Failed to chmod " + _socketAddress.getHost() + ": " +
+							std::string(strerror(errno)),
+						__FILE__, __LINE__, __PRETTY_FUNCTION__);
+}
+
+// A socket file outlives the process that bound it. Only unlink one nobody accepts on anymore, and never a regular
+// file a typo pointed the listen directive at.
+void ListeningSocket::_removeStaleSocket() const
+{
+	const std::string &path = _socketAddress.getHost();
+	struct stat fileStat;
+	if (lstat(path.c_str(), &fileStat) == -1)
+		return;
+	if (!S_ISSOCK(fileStat.st_mode))
+		throw std::runtime_error("Refusing to replace " + path + ": not a socket");
+	FileDescriptor probe = FileDescriptor::createSocket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (!probe.isValid())
+		throw std::runtime_error("Failed to probe " + path + ": " + std::string(strerror(errno)));
+	errno = 0;
+	if (connect(probe.getFd(), reinterpret_cast<const struct sockaddr *>(_socketAddress.getSockAddr()),
+				_socketAddress.getSize()) == 0 ||
+		errno == EAGAIN)
+		throw std::runtime_error("Unix socket " + path + " is in use by another process");
+	if (errno == ECONNREFUSED && unlink(path.c_str()) == -1)
+		throw std::runtime_error("Failed to remove stale socket " + path + ": " + std::string(strerror(errno)));
 }
 
 void ListeningSocket::listen()
 {
+	bool tcp = !_socketAddress.isUnix();
+	if (tcp && _options.deferAccept > 0)
+		_bindFd.setIntOption(IPPROTO_TCP, TCP_DEFER_ACCEPT, _options.deferAccept, "TCP_DEFER_ACCEPT");
+	if (tcp && _options.fastOpen > 0)
+		_bindFd.setIntOption(IPPROTO_TCP, TCP_FASTOPEN, _options.fastOpen, "TCP_FASTOPEN");
 	errno = 0;
-	if (::listen(_bindFd.getFd(), SOMAXCONN) == -1)
+	if (::listen(_bindFd.getFd(), _options.backlog) == -1)
 		throw std::runtime_error("Failed to listen on socket: current Fd: " + StrUtils::toString(_bindFd.getFd()) +
 								 " error: " + std::string(strerror(errno)));
+	_listening = true;
+}
+
+// Must be called before bind()
+void ListeningSocket::setReusePort(bool reusePort)
+{
+	_reusePort = reusePort;
+}
+
+// Must be called before bind()
+void ListeningSocket::setOptions(const ListenOptions &options)
+{
+	_options = options;
+}
+
+const ListenOptions &ListeningSocket::getOptions() const
+{
+	return _options;
+}
+
+void ListeningSocket::setShared(bool shared)
+{
+	_shared = shared;
+}
+
+bool ListeningSocket::isShared() const
+{
+	return _shared;
+}
+
+bool ListeningSocket::isListening() const
+{
+	return _listening;
 }
 
 void ListeningSocket::accept(SocketAddress &remoteAddr, FileDescriptor &clientFd) const
@@ -27,6 +27,7 @@ std::ofstream Logger::_logFile;
 #define LOG_MIN_LEVEL 2 // Default to WARNING: show WARNING/ERROR/CRITICAL by default
 #endif
 Logger::LogLevel Logger::_minLogLevel = static_cast<Logger::LogLevel>(LOG_MIN_LEVEL);
+Mutex Logger::_mutex;
 
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
@@ -112,15 +113,7 @@ void Logger::log(LogLevel level, const std::string &message)
 	std::string levelStr = _getLevelString(level);
 	std::string logEntry = "[" + timestamp + "] " + levelStr + " " + message;
 
-	// Log to session file
-	if (_sessionInitialized && _logFile.is_open())
-	{
-		_logFile << logEntry << std::endl;
-		_logFile.flush(); // Ensure immediate write
-	}
-
-	// Log to console with color coding
-	_logToConsole(level, logEntry);
+	_writeEntry(level, logEntry);
 }
 
 void Logger::log(LogLevel level, const std::stringstream &ss)
@@ -146,15 +139,7 @@ void Logger::log(LogLevel level, const std::string &message, const std::string &
 	std::string logEntry = "[" + timestamp + "] " + levelStr + " [" + filename + ":" + StrUtils::toString<int>(line) +
 						   "] " + function + " " + message;
 
-	// Log to session file
-	if (_sessionInitialized && _logFile.is_open())
-	{
-		_logFile << logEntry << std::endl;
-		_logFile.flush(); // Ensure immediate write
-	}
-
-	// Log to console with color coding
-	_logToConsole(level, logEntry);
+	_writeEntry(level, logEntry);
 }
 
 // Removed message-only convenience overloads to enforce consistent style (file/line/function).
@@ -169,13 +154,7 @@ void Logger::access(const std::string &message, const std::string &file, int lin
 	std::string timestamp = _getCurrentTime();
 	std::stringstream ss;
 	ss << "[" << timestamp << "] [ACCESS]  [" << filename << ":" << line << "] " << function << " " << message;
-	std::string logEntry = ss.str();
-	if (_sessionInitialized && _logFile.is_open())
-	{
-		_logFile << logEntry << std::endl;
-		_logFile.flush();
-	}
-	_logToConsole(INFO, logEntry);
+	_writeEntry(INFO, ss.str());
 }
 
 void Logger::debug(const std::string &message, const std::string &file, int line, const std::string &function)
@@ -262,8 +241,10 @@ void Logger::logCGIExecution(const std::string &scriptPath, int statusCode, cons
 std::string Logger::_getCurrentTime()
 {
 	std::time_t now = std::time(0);
+	struct tm timeinfo;
 	char buf[80];
-	std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+	localtime_r(&now, &timeinfo); // localtime() shares a static buffer between threads
+	std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &timeinfo);
 	return std::string(buf);
 }
 
@@ -303,6 +284,21 @@ void Logger::_logToConsole(LogLevel level, const std::string &logEntry)
 	out << logEntry << "\033[0m" << std::endl; // Reset color
 }
 
+// Single write path so an entry reaches the file and the console without interleaving with other threads
+void Logger::_writeEntry(LogLevel level, const std::string &logEntry)
+{
+	ScopedLock lock(_mutex);
+	// Log to session file
+	if (_sessionInitialized && _logFile.is_open())
+	{
+		_logFile << logEntry << std::endl;
+		_logFile.flush(); // Ensure immediate write
+	}
+
+	// Log to console with color coding
+	_logToConsole(level, logEntry);
+}
+
 void Logger::_createLogDirectory()
 {
 	struct stat st;
@@ -0,0 +1,79 @@
+#include "../../includes/Wrapper/Mutex.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/*
+** ------------------------------- CONSTRUCTOR --------------------------------
+*/
+
+Mutex::Mutex()
+{
+	int error = pthread_mutex_init(&_mutex, NULL);
+	if (error != 0)
+		throw std::runtime_error("Mutex: Failed to initialise mutex: " + std::string(strerror(error)));
+}
+
+ScopedLock::ScopedLock(Mutex &mutex) : _mutex(mutex)
+{
+	_mutex.lock();
+}
+
+Condition::Condition()
+{
+	int error = pthread_cond_init(&_cond, NULL);
+	if (error != 0)
+		throw std::runtime_error("Condition: Failed to initialise condition variable: " +
+								 std::string(strerror(error)));
+}
+
+/*
+** -------------------------------- DESTRUCTOR --------------------------------
+*/
+
+Mutex::~Mutex()
+{
+	pthread_mutex_destroy(&_mutex);
+}
+
+ScopedLock::~ScopedLock()
+{
+	_mutex.unlock();
+}
+
+Condition::~Condition()
+{
+	pthread_cond_destroy(&_cond);
+}
+
+/*
+** --------------------------------- METHODS ----------------------------------
+*/
+
+void Mutex::lock()
+{
+	pthread_mutex_lock(&_mutex);
+}
+
+void Mutex::unlock()
+{
+	pthread_mutex_unlock(&_mutex);
+}
+
+// Callers loop on their predicate, wakeups may be spurious
+void Condition::wait(Mutex &mutex)
+{
+	pthread_cond_wait(&_cond, &mutex._mutex);
+}
+
+void Condition::signal()
+{
+	pthread_cond_signal(&_cond);
+}
+
+void Condition::broadcast()
+{
+	pthread_cond_broadcast(&_cond);
+}
+
+/* ************************************************************************** */
@@ -155,6 +155,7 @@ double ScopedTimer::getElapsedTime() const
 
 void PerformanceMonitor::recordRequestTime(double timeMs)
 {
+	ScopedLock lock(_mutex);
 	_requestTimes.push_back(timeMs);
 	_currentMetrics.totalRequestTime += timeMs;
 	_sessionMetrics.totalRequestTime += timeMs;
@@ -164,29 +165,32 @@ void PerformanceMonitor::recordRequestTime(double timeMs)
 	if (timeMs > _currentMetrics.maxRequestTime)
 		_currentMetrics.maxRequestTime = timeMs;
 	
-	calculateStatistics();
+	_calculateStatistics();
 }
 
 void PerformanceMonitor::recordCGITime(double timeMs)
 {
+	ScopedLock lock(_mutex);
 	_cgiTimes.push_back(timeMs);
 	_currentMetrics.totalCGITime += timeMs;
 	_sessionMetrics.totalCGITime += timeMs;
 	
-	calculateStatistics();
+	_calculateStatistics();
 }
 
 void PerformanceMonitor::recordFileReadTime(double timeMs)
 {
+	ScopedLock lock(_mutex);
 	_fileReadTimes.push_back(timeMs);
 	_currentMetrics.totalFileReadTime += timeMs;
 	_sessionMetrics.totalFileReadTime += timeMs;
 	
-	calculateStatistics();
+	_calculateStatistics();
 }
 
 void PerformanceMonitor::recordConnection()
 {
+	ScopedLock lock(_mutex);
 	_currentMetrics.totalConnections++;
 	_sessionMetrics.totalConnections++;
 	_currentMetrics.activeConnections++;
@@ -198,6 +202,7 @@ void PerformanceMonitor::recordConnection()
 
 void PerformanceMonitor::recordDisconnection()
 {
+	ScopedLock lock(_mutex);
 	if (_currentMetrics.activeConnections > 0)
 	{
 		_currentMetrics.activeConnections--;
@@ -210,6 +215,7 @@ void PerformanceMonitor::recordDisconnection()
 
 void PerformanceMonitor::recordRequest(bool success)
 {
+	ScopedLock lock(_mutex);
 	_currentMetrics.totalRequests++;
 	_sessionMetrics.totalRequests++;
 	
@@ -227,30 +233,42 @@ void PerformanceMonitor::recordRequest(bool success)
 
 void PerformanceMonitor::recordBytesTransferred(size_t bytes)
 {
+	ScopedLock lock(_mutex);
 	_currentMetrics.bytesTransferred += bytes;
 	_sessionMetrics.bytesTransferred += bytes;
 }
 
 void PerformanceMonitor::recordEpollEvent()
 {
+	ScopedLock lock(_mutex);
 	_currentMetrics.epollEventsProcessed++;
 	_sessionMetrics.epollEventsProcessed++;
 }
 
 void PerformanceMonitor::recordTimeout()
 {
+	ScopedLock lock(_mutex);
 	_currentMetrics.timeoutsOccurred++;
 	_sessionMetrics.timeoutsOccurred++;
 }
 
 void PerformanceMonitor::recordError()
 {
+	ScopedLock lock(_mutex);
 	_currentMetrics.errorsOccurred++;
 	_sessionMetrics.errorsOccurred++;
 }
 
+void PerformanceMonitor::recordRejectedConnection()
+{
+	ScopedLock lock(_mutex);
+	_currentMetrics.rejectedConnections++;
+	_sessionMetrics.rejectedConnections++;
+}
+
 void PerformanceMonitor::recordMemoryAllocation(size_t bytes)
 {
+	ScopedLock lock(_mutex);
 	_currentMetrics.totalMemoryAllocated += bytes;
 	_sessionMetrics.totalMemoryAllocated += bytes;
 	_updateMemoryMetrics();
@@ -258,6 +276,7 @@ void PerformanceMonitor::recordMemoryAllocation(size_t bytes)
 
 void PerformanceMonitor::recordMemoryDeallocation(size_t bytes)
 {
+	ScopedLock lock(_mutex);
 	if (_currentMetrics.totalMemoryAllocated >= bytes)
 	{
 		_currentMetrics.totalMemoryAllocated -= bytes;
@@ -268,12 +287,14 @@ void PerformanceMonitor::recordMemoryDeallocation(size_t bytes)
 
 void PerformanceMonitor::recordFileDescriptorOpen()
 {
+	ScopedLock lock(_mutex);
 	_currentMetrics.fileDescriptorsUsed++;
 	_sessionMetrics.fileDescriptorsUsed++;
 }
 
 void PerformanceMonitor::recordFileDescriptorClose()
 {
+	ScopedLock lock(_mutex);
 	if (_currentMetrics.fileDescriptorsUsed > 0)
 	{
 		_currentMetrics.fileDescriptorsUsed--;
@@ -286,6 +307,13 @@ void PerformanceMonitor::recordFileDescriptorClose()
 */
 
 void PerformanceMonitor::calculateStatistics()
+{
+	ScopedLock lock(_mutex);
+	_calculateStatistics();
+}
+
+// Callers must hold _mutex
+void PerformanceMonitor::_calculateStatistics()
 {
 	// Calculate request time statistics
 	if (!_requestTimes.empty())
@@ -311,6 +339,7 @@ void PerformanceMonitor::calculateStatistics()
 
 void PerformanceMonitor::resetSessionMetrics()
 {
+	ScopedLock lock(_mutex);
 	_sessionMetrics = Metrics();
 	_requestTimes.clear();
 	_cgiTimes.clear();
@@ -326,6 +355,7 @@ void PerformanceMonitor::resetSessionMetrics()
 
 void PerformanceMonitor::updateSystemMetrics()
 {
+	ScopedLock lock(_mutex);
 	_updateMemoryMetrics();
 	_updateFileDescriptorMetrics();
 	_updateSystemMetrics();
@@ -413,6 +443,7 @@ void PerformanceMonitor::logPerformanceSummary()
 
 std::string PerformanceMonitor::generatePerformanceReport() const
 {
+	ScopedLock lock(_mutex);
 	std::stringstream ss;
 	
 	ss << "Session Duration: " << std::fixed << std::setprecision(2) << _getCurrentTime() << " ms\n";
@@ -425,6 +456,7 @@ std::string PerformanceMonitor::generatePerformanceReport() const
 	ss << "Epoll Events Processed: " << _sessionMetrics.epollEventsProcessed << "\n";
 	ss << "Timeouts: " << _sessionMetrics.timeoutsOccurred << "\n";
 	ss << "Errors: " << _sessionMetrics.errorsOccurred << "\n";
+	ss << "Rejected Connections: " << _sessionMetrics.rejectedConnections << "\n";
 	ss << "\n";
 	ss << "Request Timing:\n";
 	ss << "  Total Time: " << std::fixed << std::setprecision(2) << _sessionMetrics.totalRequestTime << " ms\n";
@@ -454,6 +486,7 @@ std::string PerformanceMonitor::generatePerformanceReport() const
 
 std::string PerformanceMonitor::generatePerformanceSummary() const
 {
+	ScopedLock lock(_mutex);
 	std::stringstream ss;
 	
 	double sessionTimeMs = _getCurrentTime();
@@ -138,7 +138,13 @@ SocketAddress::SocketAddress(const std::string &host, const std::string &port) :
 
 SocketAddress::SocketAddress(const std::string &host_port) : _addrLen(0), _family(AF_UNSPEC)
 {
-	if (!host_port.empty() && host_port[0] == '[')
+	static const std::string unixPrefix = "unix:";
+	if (host_port.compare(0, unixPrefix.size(), unixPrefix) == 0)
+	{
+		std::memset(&_storage, 0, sizeof(_storage));
+		_setUnixPath(host_port.substr(unixPrefix.size()));
+	}
+	else if (!host_port.empty() && host_port[0] == '[')
 	{
 		size_t end = host_port.find(']');
 		if (end == std::string::npos)
@@ -166,9 +172,33 @@ SocketAddress::SocketAddress(const SocketAddress &src)
 ** ------------------------------- PRIVATE HELPERS ---------------------------
 */
 
+// "unix:/run/webserv.sock", the path has to fit sun_path with its terminator
+void SocketAddress::_setUnixPath(const std::string &path)
+{
+	struct sockaddr_un *addrUn = reinterpret_cast<struct sockaddr_un *>(&_storage);
+	if (path.empty() || path.size() >= sizeof(addrUn->sun_path))
+		throw std::runtime_error("Invalid unix socket path: " + path);
+	addrUn->sun_family = AF_UNIX;
+	std::memcpy(addrUn->sun_path, path.c_str(), path.size() + 1);
+	_family = AF_UNIX;
+	_addrLen = offsetof(struct sockaddr_un, sun_path) + path.size() + 1;
+	_host = path;
+	_port = 0;
+}
+
 void SocketAddress::_updateCachedValues()
 {
-	if (_family == AF_INET && _addrLen >= sizeof(struct sockaddr_in))
+	if (_family == AF_UNIX)
+	{
+		// Clients connecting over a unix socket are usually unbound, their address carries no path
+		const struct sockaddr_un *addrUn = reinterpret_cast<const struct sockaddr_un *>(&_storage);
+		size_t pathLength = _addrLen > offsetof(struct sockaddr_un, sun_path)
+								? _addrLen - offsetof(struct sockaddr_un, sun_path)
+								: 0;
+		_host = std::string(addrUn->sun_path, strnlen(addrUn->sun_path, pathLength));
+		_port = 0;
+	}
+	else if (_family == AF_INET && _addrLen >= sizeof(struct sockaddr_in))
 	{
 		const struct sockaddr_in *addr4 = _getSockAddrIn();
 		_port = ntohs(addr4->sin_port);
@@ -271,7 +301,10 @@ bool SocketAddress::operator>=(const SocketAddress &rhs) const
 
 std::ostream &operator<<(std::ostream &o, const SocketAddress &i)
 {
-	o << i.getHost() << ":" << i.getPort();
+	if (i.isUnix())
+		o << "unix:" << i.getHost();
+	else
+		o << i.getHost() << ":" << i.getPort();
 	return o;
 }
 
@@ -289,6 +322,11 @@ bool SocketAddress::isIPv6() const
 	return _family == AF_INET6;
 }
 
+bool SocketAddress::isUnix() const
+{
+	return _family == AF_UNIX;
+}
+
 bool SocketAddress::isValid() const
 {
 	return _family != AF_UNSPEC && _addrLen > 0;
@@ -323,6 +361,8 @@ std::string SocketAddress::getHostString() const
 	{
 		return IPAddressParser::ipv6ToString(_getSockAddrIn6()->sin6_addr);
 	}
+	else if (isUnix())
+		return "unix:" + _host;
 	return "unknown";
 }
 
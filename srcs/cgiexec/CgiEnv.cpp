@@ -110,9 +110,13 @@ void CgiEnv::_transposeData(const HttpRequest &request, const Server *server, co
 		if (request.getRemoteAddress())
 		{
 			Logger::debug("CgiEnv: Setting REMOTE_ADDR", __FILE__, __LINE__, __PRETTY_FUNCTION__);
-			setEnv("REMOTE_ADDR", request.getRemoteAddress()->getHost());
-			Logger::debug("CgiEnv: Setting REMOTE_PORT", __FILE__, __LINE__, __PRETTY_FUNCTION__);
-			setEnv("REMOTE_PORT", request.getRemoteAddress()->getPortString());
+			// A peer on a unix socket has no address or port: "unix:" like nginx, and no REMOTE_PORT at all
+			setEnv("REMOTE_ADDR", request.getRemoteAddress()->getHostString());
+			if (!request.getRemoteAddress()->isUnix())
+			{
+				Logger::debug("CgiEnv: Setting REMOTE_PORT", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+				setEnv("REMOTE_PORT", request.getRemoteAddress()->getPortString());
+			}
 		}
 		Logger::debug("CgiEnv: Setting REQUEST_URI", __FILE__, __LINE__, __PRETTY_FUNCTION__);
 		setEnv("REQUEST_URI", request.getRawUri());
@@ -125,9 +129,10 @@ void CgiEnv::_transposeData(const HttpRequest &request, const Server *server, co
 		case HttpBody::BODY_TYPE_CONTENT_LENGTH:
 		{
 			setEnv("CONTENT_LENGTH", StrUtils::toString(request.getContentLength()));
-			std::vector<std::string> contentType = request.getHeader("content-type");
-			if (!contentType.empty())
-				setEnv("CONTENT_TYPE", contentType[0]);
+			const char *contentType;
+			size_t contentTypeLength;
+			if (request.getHeaderFields().getValue(KnownHeaders::CONTENT_TYPE, contentType, contentTypeLength))
+				setEnv("CONTENT_TYPE", std::string(contentType, contentTypeLength));
 			break;
 		}
 		default:
@@ -167,20 +172,22 @@ void CgiEnv::_transposeData(const HttpRequest &request, const Server *server, co
 		Logger::debug("CgiEnv: SCRIPT_NAME=" + cleanUri + " SCRIPT_FILENAME=" + scriptPath, __FILE__, __LINE__,
 					  __PRETTY_FUNCTION__);
 
-		// Headers
-		const std::map<std::string, std::vector<std::string> > &headers = request.getHeaders();
-		for (std::map<std::string, std::vector<std::string> >::const_iterator it = headers.begin(); it != headers.end();
-			 ++it)
+		// Headers, one variable per name from its first line
+		const HttpHeaders &headers = request.getHeaderFields();
+		for (size_t i = 0; i < headers.getFieldCount(); ++i)
 		{
-			if (it->second.empty())
+			KnownHeaders::Id id;
+			std::string headerName;
+			const char *value;
+			size_t valueLength;
+			if (!headers.getField(i, id, headerName, value, valueLength))
 				continue;
-			std::string headerName = it->first;
-			if (headerName == "authorization" || headerName == "proxy-authorization")
+			if (id == KnownHeaders::AUTHORIZATION || id == KnownHeaders::PROXY_AUTHORIZATION)
 				continue;
-			if (headerName == "content-length" || headerName == "content-type")
+			if (id == KnownHeaders::CONTENT_LENGTH || id == KnownHeaders::CONTENT_TYPE)
 				continue;
 			std::string cgiHeaderName = "HTTP_" + _convertHeaderNameToCgi(headerName);
-			setEnv(cgiHeaderName, it->second[0]);
+			setEnv(cgiHeaderName, std::string(value, valueLength));
 		}
 
 		// Add minimal shell environment for CGI (PATH for interpreter resolution)
@@ -1,48 +1,54 @@
 #include "../../includes/CGI/CgiExecutor.hpp"
+#include "../../includes/Global/CharScan.hpp"
 #include "../../includes/Global/Logger.hpp"
 #include "../../includes/Global/PerformanceMonitor.hpp"
 #include "../../includes/Global/StrUtils.hpp"
+#include "../../includes/HTTP/HTTP.hpp"
+#include <csignal>
 #include <cstring>
 #include <fcntl.h>
 #include <fstream>
 #include <sys/select.h>
 #include <sys/stat.h>
 
+std::vector<pid_t> CgiExecutor::_detachedChildren;
+Mutex CgiExecutor::_detachedMutex;
+static volatile size_t detachedCount = 0; // lets reapDetached() skip the lock when there is nothing to reap
+
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
 */
 
-CgiExecutor::CgiExecutor() : _childPid(-1), _timeoutSeconds(DEFAULT_TIMEOUT_SECONDS), _processRunning(false)
+CgiExecutor::CgiExecutor()
+	: _childPid(-1), _timeoutSeconds(DEFAULT_TIMEOUT_SECONDS), _processRunning(false), _outputComplete(false)
 {
 	// Initialize pipe file descriptors to invalid state
 	for (int i = 0; i < 2; ++i)
 	{
 		_stdinPipe[i] = FileDescriptor();
 		_stdoutPipe[i] = FileDescriptor();
-		_stderrPipe[i] = FileDescriptor();
 	}
 }
 
-CgiExecutor::CgiExecutor(int timeoutSeconds) : _childPid(-1), _timeoutSeconds(timeoutSeconds), _processRunning(false)
+CgiExecutor::CgiExecutor(int timeoutSeconds)
+	: _childPid(-1), _timeoutSeconds(timeoutSeconds), _processRunning(false), _outputComplete(false)
 {
 	// Initialize pipe file descriptors to invalid state
 	for (int i = 0; i < 2; ++i)
 	{
 		_stdinPipe[i] = FileDescriptor();
 		_stdoutPipe[i] = FileDescriptor();
-		_stderrPipe[i] = FileDescriptor();
 	}
 }
 
 CgiExecutor::CgiExecutor(const CgiExecutor &other)
-	: _childPid(-1), _timeoutSeconds(other._timeoutSeconds), _processRunning(false)
+	: _childPid(-1), _timeoutSeconds(other._timeoutSeconds), _processRunning(false), _outputComplete(false)
 {
 	// Initialize pipe file descriptors to invalid state
 	for (int i = 0; i < 2; ++i)
 	{
 		_stdinPipe[i] = FileDescriptor();
 		_stdoutPipe[i] = FileDescriptor();
-		_stderrPipe[i] = FileDescriptor();
 	}
 	// Note: We don't copy the process state or pipes as they are not copyable
 }
@@ -81,13 +87,13 @@ CgiExecutor &CgiExecutor::operator=(const CgiExecutor &other)
 		// Reset non-copyable state
 		_childPid = -1;
 		_processRunning = false;
+		_outputComplete = false;
 
 		// Initialize pipe file descriptors to invalid state
 		for (int i = 0; i < 2; ++i)
 		{
 			_stdinPipe[i] = FileDescriptor();
 			_stdoutPipe[i] = FileDescriptor();
-			_stderrPipe[i] = FileDescriptor();
 		}
 	}
 	return *this;
@@ -98,14 +104,14 @@ CgiExecutor &CgiExecutor::operator=(const CgiExecutor &other)
 */
 
 CgiExecutor::ExecutionResult CgiExecutor::execute(const std::string &scriptPath, const std::string &interpreter,
-												  char **envp, const std::string &inputData, std::string &outputData,
-												  std::string &errorData)
+												  char **envp, const std::string &inputData, std::string &outputData)
 {
 	PERF_SCOPED_TIMER(cgi_execution);
 
 	// Clear output buffers
 	outputData.clear();
-	errorData.clear();
+	_outputComplete = false;
+	reapDetached();
 
 	// Check if script exists and is executable
 	if (!isFileExecutable(scriptPath))
@@ -135,7 +141,14 @@ CgiExecutor::ExecutionResult CgiExecutor::execute(const std::string &scriptPath,
 
 	// Communicate with the child process
 	Logger::debug("CgiExecutor: Communicating with child process", __FILE__, __LINE__, __PRETTY_FUNCTION__);
-	result = communicateWithChild(inputData, outputData, errorData);
+	result = communicateWithChild(inputData, outputData);
+	if (result == SUCCESS && !_outputComplete)
+	{
+		// Still writing its body, the caller takes the rest of stdout with detachOutput()
+		Logger::debug("CgiExecutor: Header block read, body left in the pipe", __FILE__, __LINE__,
+					  __PRETTY_FUNCTION__);
+		return result;
+	}
 
 	// Wait for child to complete
 	Logger::debug("CgiExecutor: Waiting for child process to complete", __FILE__, __LINE__, __PRETTY_FUNCTION__);
@@ -161,6 +174,46 @@ int CgiExecutor::getTimeout() const
 	return _timeoutSeconds;
 }
 
+bool CgiExecutor::isOutputComplete() const
+{
+	return _outputComplete;
+}
+
+// Hands the read end of stdout to the caller, the child is reaped by reapDetached() once it exits
+FileDescriptor CgiExecutor::detachOutput()
+{
+	FileDescriptor output = _stdoutPipe[0];
+	_stdoutPipe[0] = FileDescriptor();
+	closePipes();
+	if (_processRunning && _childPid > 0)
+	{
+		ScopedLock lock(_detachedMutex);
+		_detachedChildren.push_back(_childPid);
+		detachedCount = _detachedChildren.size();
+	}
+	_processRunning = false;
+	_childPid = -1;
+	return output;
+}
+
+void CgiExecutor::reapDetached()
+{
+	if (detachedCount == 0)
+		return;
+	ScopedLock lock(_detachedMutex);
+	for (size_t i = 0; i < _detachedChildren.size();)
+	{
+		if (waitpid(_detachedChildren[i], NULL, WNOHANG) == 0)
+		{
+			++i; // Still running
+			continue;
+		}
+		_detachedChildren[i] = _detachedChildren.back();
+		_detachedChildren.pop_back();
+	}
+	detachedCount = _detachedChildren.size();
+}
+
 bool CgiExecutor::isProcessRunning() const
 {
 	return _processRunning;
@@ -210,17 +263,6 @@ CgiExecutor::ExecutionResult CgiExecutor::setupPipes()
 		return ERROR_PIPE_FAILED;
 	}
 
-	// Create stderr pipe using FileDescriptor wrapper
-	if (!FileDescriptor::createPipe(_stderrPipe[0], _stderrPipe[1]))
-	{
-		Logger::log(Logger::ERROR, "Failed to create stderr pipe");
-		_stdinPipe[0].closeDescriptor();
-		_stdinPipe[1].closeDescriptor();
-		_stdoutPipe[0].closeDescriptor();
-		_stdoutPipe[1].closeDescriptor();
-		return ERROR_PIPE_FAILED;
-	}
-
 	return SUCCESS;
 }
 
@@ -230,7 +272,6 @@ void CgiExecutor::closePipes()
 	{
 		_stdinPipe[i].closeDescriptor();
 		_stdoutPipe[i].closeDescriptor();
-		_stderrPipe[i].closeDescriptor();
 	}
 }
 
@@ -249,12 +290,20 @@ CgiExecutor::ExecutionResult CgiExecutor::forkAndExec(const std::string &scriptP
 	{
 		// Child process
 
-		// Redirect stdin, stdout, stderr to pipes
-		if (dup2(_stdinPipe[0].getFd(), STDIN_FILENO) == -1 || dup2(_stdoutPipe[1].getFd(), STDOUT_FILENO) == -1 ||
-			dup2(_stderrPipe[1].getFd(), STDERR_FILENO) == -1)
+		// Signal masks survive execve, the server blocks SIGHUP (read from a signalfd) and reactor threads block all
+		sigset_t noSignals;
+		sigemptyset(&noSignals);
+		sigprocmask(SIG_SETMASK, &noSignals, NULL);
+
+		// Redirect stdin and stdout to pipes, stderr stays the server's: the script can outlive execute(), nobody
+		// would drain a stderr pipe by then
+		if (dup2(_stdinPipe[0].getFd(), STDIN_FILENO) == -1 || dup2(_stdoutPipe[1].getFd(), STDOUT_FILENO) == -1)
 		{
 			_exit(1);
 		}
+		// The script's ends block, a full stdout pipe must wait for the client instead of failing its writes
+		fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) & ~O_NONBLOCK);
+		fcntl(STDOUT_FILENO, F_SETFL, fcntl(STDOUT_FILENO, F_GETFL) & ~O_NONBLOCK);
 
 		closePipes();
 
@@ -304,13 +353,13 @@ CgiExecutor::ExecutionResult CgiExecutor::forkAndExec(const std::string &scriptP
 	// Close child ends of pipes in parent
 	_stdinPipe[0].closeDescriptor();
 	_stdoutPipe[1].closeDescriptor();
-	_stderrPipe[1].closeDescriptor();
 
 	return SUCCESS;
 }
 
-CgiExecutor::ExecutionResult CgiExecutor::communicateWithChild(const std::string &inputData, std::string &outputData,
-															   std::string &errorData)
+// Feeds the request body, then reads stdout until it closes or CGI_BUFFERED_OUTPUT bytes including the header block
+// are in. Short outputs complete here and keep their Content-Length, only long ones are left in the pipe.
+CgiExecutor::ExecutionResult CgiExecutor::communicateWithChild(const std::string &inputData, std::string &outputData)
 {
 	// Write input data to child's stdin using FileDescriptor wrapper
 	if (!inputData.empty())
@@ -326,87 +375,40 @@ CgiExecutor::ExecutionResult CgiExecutor::communicateWithChild(const std::string
 	// Close stdin pipe to signal end of input
 	_stdinPipe[1].closeDescriptor();
 
-	// Read output from child's stdout and stderr using FileDescriptor wrapper
-	bool stdoutClosed = false;
-	bool stderrClosed = false;
-
-	while (!stdoutClosed || !stderrClosed)
+	while (true)
 	{
-		bool dataAvailable = false;
-
-		// Check if stdout has data ready
-		if (!stdoutClosed && _stdoutPipe[0].waitForPipeReady(true, _timeoutSeconds * 1000))
+		bool headersRead = hasHeaderBlock(outputData);
+		if (headersRead && outputData.length() >= HTTP::CGI_BUFFERED_OUTPUT)
+			return SUCCESS; // The rest is spliced as it comes
+		if (!_stdoutPipe[0].waitForPipeReady(true, _timeoutSeconds * 1000))
 		{
-			std::string buffer;
-			ssize_t bytesRead = _stdoutPipe[0].readPipe(buffer, MAX_OUTPUT_SIZE - outputData.length());
-			if (bytesRead > 0)
-			{
-				outputData += buffer;
-				dataAvailable = true;
-				if (outputData.length() >= MAX_OUTPUT_SIZE)
-				{
-					Logger::log(Logger::ERROR, "CGI output too large");
-					killProcess();
-					return ERROR_READ_FAILED;
-				}
-			}
-			else if (bytesRead == 0)
-				stdoutClosed = true;
-			else
-			{
-				Logger::log(Logger::ERROR, "Failed to read from stdout pipe");
-				stdoutClosed = true;
-			}
+			Logger::log(Logger::ERROR, "CGI process timeout");
+			killProcess();
+			return ERROR_TIMEOUT;
 		}
-
-		// Check if stderr has data ready
-		if (!stderrClosed && _stderrPipe[0].waitForPipeReady(true, _timeoutSeconds * 1000))
+		std::string buffer;
+		ssize_t bytesRead = _stdoutPipe[0].readPipe(buffer, HTTP::CGI_BUFFERED_OUTPUT);
+		if (bytesRead == 0)
 		{
-			std::string buffer;
-			ssize_t bytesRead = _stderrPipe[0].readPipe(buffer, MAX_OUTPUT_SIZE - errorData.length());
-			if (bytesRead > 0)
-			{
-				errorData += buffer;
-				dataAvailable = true;
-				if (errorData.length() >= MAX_OUTPUT_SIZE)
-				{
-					Logger::log(Logger::ERROR, "CGI error output too large");
-					killProcess();
-					return ERROR_READ_FAILED;
-				}
-			}
-			else if (bytesRead == 0)
-				stderrClosed = true;
-			else
-			{
-				Logger::log(Logger::ERROR, "Failed to read from stderr pipe");
-				stderrClosed = true;
-			}
+			_outputComplete = true;
+			return SUCCESS;
 		}
-
-		// If no data was available and pipes are still open, check for timeout
-		if (!dataAvailable && (!stdoutClosed || !stderrClosed))
+		outputData += buffer;
+		if (!headersRead && !hasHeaderBlock(outputData) &&
+			outputData.length() > static_cast<size_t>(HTTP::DEFAULT_CLIENT_MAX_HEADERS_SIZE))
 		{
-			// Use a shorter timeout for individual checks to avoid hanging
-			if (!_stdoutPipe[0].waitForPipeReady(true, 100) && !_stderrPipe[0].waitForPipeReady(true, 100))
-			{
-				// Check if child process is still running
-				if (!_processRunning)
-				{
-					stdoutClosed = true;
-					stderrClosed = true;
-				}
-				else
-				{
-					Logger::log(Logger::ERROR, "CGI process timeout");
-					killProcess();
-					return ERROR_TIMEOUT;
-				}
-			}
+			Logger::log(Logger::ERROR, "CGI header block too large");
+			killProcess();
+			return ERROR_READ_FAILED;
 		}
 	}
+}
 
-	return SUCCESS;
+bool CgiExecutor::hasHeaderBlock(const std::string &output)
+{
+	size_t separatorLength;
+	CharScan::findHeaderEnd(output.data(), output.data() + output.size(), separatorLength);
+	return separatorLength != 0;
 }
 
 CgiExecutor::ExecutionResult CgiExecutor::waitForChild()
@@ -91,9 +91,9 @@ CgiHandler::ExecutionResult CgiHandler::execute(const HttpRequest &request, Http
 				  __FILE__, __LINE__, __PRETTY_FUNCTION__);
 
 	// Execute CGI script
-	std::string output, error;
+	std::string output;
 	Logger::debug("CgiHandler: Executing CGI script", __FILE__, __LINE__, __PRETTY_FUNCTION__);
-	ExecutionResult result = executeCgiScript(scriptPath, interpreter, request, output, error);
+	ExecutionResult result = executeCgiScript(scriptPath, interpreter, request, output);
 	Logger::debug("CgiHandler: executeCgiScript returned result code: " + StrUtils::toString(result), __FILE__,
 				  __LINE__, __PRETTY_FUNCTION__);
 	if (result != SUCCESS)
@@ -115,9 +115,14 @@ CgiHandler::ExecutionResult CgiHandler::execute(const HttpRequest &request, Http
 		return result;
 	}
 
+	// A long body is still being written, the response splices the rest of stdout to the client
+	FileDescriptor stream;
+	if (!_executor.isOutputComplete())
+		stream = _executor.detachOutput();
+
 	// Process the response
 	Logger::debug("CgiHandler: Processing CGI response", __FILE__, __LINE__, __PRETTY_FUNCTION__);
-	result = processResponse(output, error, response, server);
+	result = processResponse(output, stream, response, server);
 	Logger::debug("CgiHandler: processResponse returned result code: " + StrUtils::toString(result), __FILE__, __LINE__,
 				  __PRETTY_FUNCTION__);
 
@@ -163,8 +168,7 @@ int CgiHandler::getTimeout() const
 */
 
 CgiHandler::ExecutionResult CgiHandler::executeCgiScript(const std::string &scriptPath, const std::string &interpreter,
-														 const HttpRequest &request, std::string &output,
-														 std::string &error)
+														 const HttpRequest &request, std::string &output)
 {
 	// Get environment array
 	char **envArray = _cgiEnv.getEnvArray();
@@ -176,17 +180,11 @@ CgiHandler::ExecutionResult CgiHandler::executeCgiScript(const std::string &scri
 
 	// Execute the script
 	CgiExecutor::ExecutionResult execResult =
-		_executor.execute(scriptPath, interpreter, envArray, request.getBodyData(), output, error);
+		_executor.execute(scriptPath, interpreter, envArray, request.getBodyData(), output);
 
 	// Clean up environment array
 	_cgiEnv.freeEnvArray(envArray);
 
-	// Log stderr if present
-	if (!error.empty())
-	{
-		Logger::warning("CGI script stderr output: " + error, __FILE__, __LINE__, __PRETTY_FUNCTION__);
-	}
-
 	// Map executor results to handler results
 	switch (execResult)
 	{
@@ -202,18 +200,20 @@ CgiHandler::ExecutionResult CgiHandler::executeCgiScript(const std::string &scri
 	}
 }
 
-CgiHandler::ExecutionResult CgiHandler::processResponse(const std::string &output, const std::string &error,
+CgiHandler::ExecutionResult CgiHandler::processResponse(const std::string &output, const FileDescriptor &stream,
 														HttpResponse &response, const Server *server)
 {
 	(void)server;
-	// Log any error output from CGI script
-	if (!error.empty())
+	// NPH scripts write their own status line and headers, the output goes to the client untouched
+	if (output.compare(0, 5, "HTTP/") == 0)
 	{
-		Logger::log(Logger::WARNING, "CGI script error output: " + error);
+		_response.clear();
+		response.setResponsePassThrough(stream, output);
+		return SUCCESS;
 	}
 
 	// Parse CGI output
-	CgiResponse::ParseResult parseResult = _response.parseOutput(output);
+	CgiResponse::ParseResult parseResult = _response.parseOutput(output, !stream.isOpen());
 	if (parseResult != CgiResponse::SUCCESS)
 	{
 		Logger::log(Logger::ERROR, "Failed to parse CGI output");
@@ -228,7 +228,7 @@ CgiHandler::ExecutionResult CgiHandler::processResponse(const std::string &outpu
 	}
 
 	// Populate HTTP response from parsed CGI response
-	_response.populateHttpResponse(response);
+	_response.populateHttpResponse(response, stream);
 
 	return SUCCESS;
 }
@@ -1,20 +1,25 @@
 #include "../../includes/CGI/CgiResponse.hpp"
+#include "../../includes/Global/CharScan.hpp"
 #include "../../includes/Global/StrUtils.hpp"
 #include <algorithm>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 
 /*
 ** ------------------------------- CONSTRUCTOR --------------------------------
 */
 
-CgiResponse::CgiResponse() : _statusCode(200), _statusMessage("OK"), _isParsed(false), _isNPH(false)
+CgiResponse::CgiResponse()
+	: _statusCode(200), _statusMessage("OK"), _isParsed(false), _isNPH(false), _outputComplete(true)
 {
 }
 
 CgiResponse::CgiResponse(const CgiResponse &other)
 	: _headers(other._headers), _body(other._body), _statusCode(other._statusCode),
-	  _statusMessage(other._statusMessage), _isParsed(other._isParsed), _isNPH(other._isNPH)
+	  _statusMessage(other._statusMessage), _isParsed(other._isParsed), _isNPH(other._isNPH),
+	  _outputComplete(other._outputComplete)
 {
 }
 
@@ -40,6 +45,7 @@ CgiResponse &CgiResponse::operator=(const CgiResponse &other)
 		_statusMessage = other._statusMessage;
 		_isParsed = other._isParsed;
 		_isNPH = other._isNPH;
+		_outputComplete = other._outputComplete;
 	}
 	return *this;
 }
@@ -48,27 +54,22 @@ CgiResponse &CgiResponse::operator=(const CgiResponse &other)
 ** --------------------------------- METHODS ----------------------------------
 */
 
-CgiResponse::ParseResult CgiResponse::parseOutput(const std::string &cgiOutput)
+// cgiOutput holds at least the header block; when outputComplete is false the rest of the body is still in the
+// script's stdout and _body is only its beginning
+CgiResponse::ParseResult CgiResponse::parseOutput(const std::string &cgiOutput, bool outputComplete)
 {
 	clear();
+	_outputComplete = outputComplete;
 	if (cgiOutput.empty())
 	{
 		Logger::log(Logger::ERROR, "CGI output is empty");
 		return ERROR_MALFORMED_RESPONSE;
 	}
 	// Find the separator between headers and body (double CRLF or double LF)
-	size_t headerEndPos = cgiOutput.find("\r\n\r\n");
-	size_t separatorLength = 0;
-
-	if (headerEndPos != std::string::npos)
-		separatorLength = 4; // Length of "\r\n\r\n"
-	else
-	{
-		headerEndPos = cgiOutput.find("\n\n");
-		if (headerEndPos != std::string::npos)
-			separatorLength = 2; // Length of "\n\n"
-	}
-	if (headerEndPos == std::string::npos)
+	size_t separatorLength;
+	const char *output = cgiOutput.data();
+	size_t headerEndPos = CharScan::findHeaderEnd(output, output + cgiOutput.size(), separatorLength) - output;
+	if (separatorLength == 0)
 	{
 		// No header/body separator found - treat entire output as body
 		_body = cgiOutput;
@@ -76,17 +77,10 @@ CgiResponse::ParseResult CgiResponse::parseOutput(const std::string &cgiOutput)
 		_isParsed = true;
 		return SUCCESS;
 	}
-	else
-	{
-		headerEndPos += separatorLength; // Move past the separator
-		std::string header = cgiOutput.substr(0, headerEndPos);
-		_body = cgiOutput.substr(headerEndPos);
-		parseHeaders(header);
-	}
 
 	// Extract headers and body
-	std::string headerSection = cgiOutput.substr(0, headerEndPos - separatorLength);
-	_body = cgiOutput.substr(headerEndPos);
+	std::string headerSection = cgiOutput.substr(0, headerEndPos);
+	_body = cgiOutput.substr(headerEndPos + separatorLength);
 
 	// Check if this is NPH (Non-Parsed Header) mode
 	if (headerSection.find("HTTP/") == 0)
@@ -116,7 +110,7 @@ CgiResponse::ParseResult CgiResponse::parseOutput(const std::string &cgiOutput)
 	return SUCCESS;
 }
 
-void CgiResponse::populateHttpResponse(HttpResponse &httpResponse) const
+void CgiResponse::populateHttpResponse(HttpResponse &httpResponse, const FileDescriptor &stream) const
 {
 	if (!_isParsed)
 	{
@@ -127,6 +121,8 @@ void CgiResponse::populateHttpResponse(HttpResponse &httpResponse) const
 
 	for (std::map<std::string, std::string>::const_iterator it = _headers.begin(); it != _headers.end(); ++it)
 	{
+		if (stream.isOpen() && it->first == "content-length")
+			continue; // Set by setResponseStream() once validated
 		httpResponse.setHeader(Header(it->first + ": " + it->second));
 	}
 
@@ -136,6 +132,11 @@ void CgiResponse::populateHttpResponse(HttpResponse &httpResponse) const
 		// 204 No Content, 304 Not Modified, 1xx Informational - no body
 		httpResponse.setBody("");
 	}
+	else if (stream.isOpen())
+	{
+		// Only the beginning of the body was read, the rest is spliced from the script's stdout
+		httpResponse.setResponseStream(stream, _body, getScriptContentLength());
+	}
 	else
 	{
 		httpResponse.setBody(_body);
@@ -201,32 +202,28 @@ void CgiResponse::clear()
 	_statusMessage = "OK";
 	_isParsed = false;
 	_isNPH = false;
+	_outputComplete = true;
 }
 
 /*
 ** --------------------------------- PRIVATE ----------------------------------
 */
 
+// One line per '\n', a trailing '\r' is dropped and empty lines are skipped
 CgiResponse::ParseResult CgiResponse::parseHeaders(const std::string &headerSection)
 {
-	std::istringstream headerStream(headerSection);
-	std::string line;
+	const char *cursor = headerSection.data();
+	const char *end = cursor + headerSection.size();
 
-	while (std::getline(headerStream, line))
+	while (cursor != end)
 	{
-		// Remove carriage return if present
-		if (!line.empty() && line[line.length() - 1] == '\r')
-		{
-			line.erase(line.length() - 1);
-		}
-
-		// Skip empty lines
-		if (line.empty())
-		{
-			continue;
-		}
-
-		parseHeaderLine(line);
+		const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+		const char *lineEnd = newline ? newline : end;
+		if (lineEnd != cursor && lineEnd[-1] == '\r')
+			--lineEnd;
+		if (lineEnd != cursor)
+			parseHeaderLine(cursor, lineEnd);
+		cursor = newline ? newline + 1 : end;
 	}
 
 	return SUCCESS;
@@ -267,26 +264,33 @@ CgiResponse::ParseResult CgiResponse::parseStatusLine(const std::string &statusL
 	return SUCCESS;
 }
 
-void CgiResponse::parseHeaderLine(const std::string &line)
+void CgiResponse::parseHeaderLine(const char *begin, const char *end)
 {
-	size_t colonPos = line.find(':');
-	if (colonPos == std::string::npos)
+	const char *colon = static_cast<const char *>(std::memchr(begin, ':', end - begin));
+	if (colon == NULL)
 	{
-		Logger::log(Logger::WARNING, "Invalid header line (no colon): " + line);
+		Logger::log(Logger::WARNING, "Invalid header line (no colon): " + std::string(begin, end));
 		return;
 	}
 
-	std::string name = trim(line.substr(0, colonPos));
-	std::string value = trim(line.substr(colonPos + 1));
+	const char *nameBegin = begin;
+	const char *nameEnd = colon;
+	const char *valueBegin = colon + 1;
+	const char *valueEnd = end;
+	trimRange(nameBegin, nameEnd);
+	trimRange(valueBegin, valueEnd);
 
-	if (name.empty())
+	if (nameBegin == nameEnd)
 	{
-		Logger::log(Logger::WARNING, "Empty header name in line: " + line);
+		Logger::log(Logger::WARNING, "Empty header name in line: " + std::string(begin, end));
 		return;
 	}
 
 	// Store header with lowercase name for case-insensitive access
-	_headers[toLowerCase(name)] = value;
+	std::string name(nameBegin, nameEnd);
+	for (size_t i = 0; i < name.size(); ++i)
+		name[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[i])));
+	_headers[name].assign(valueBegin, valueEnd);
 }
 
 std::string CgiResponse::toLowerCase(const std::string &str) const
@@ -308,11 +312,33 @@ std::string CgiResponse::trim(const std::string &str) const
 	return str.substr(start, end - start + 1);
 }
 
+// Same set of characters as trim(), without the copy
+void CgiResponse::trimRange(const char *&begin, const char *&end) const
+{
+	while (begin != end && (*begin == ' ' || *begin == '\t' || *begin == '\r' || *begin == '\n'))
+		++begin;
+	while (end != begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n'))
+		--end;
+}
+
 bool CgiResponse::isValidStatusCode(int code) const
 {
 	return code >= 100 && code <= 599;
 }
 
+// Content-Length the script announced, -1 when it gave none or an unusable one
+ssize_t CgiResponse::getScriptContentLength() const
+{
+	std::map<std::string, std::string>::const_iterator it = _headers.find("content-length");
+	if (it == _headers.end() || it->second.empty())
+		return -1;
+	char *end = NULL;
+	long length = std::strtol(it->second.c_str(), &end, 10);
+	if (*end != '\0' || length < 0)
+		return -1;
+	return static_cast<ssize_t>(length);
+}
+
 std::string CgiResponse::getDefaultStatusMessage(int code) const
 {
 	switch (code)
@@ -399,11 +425,12 @@ void CgiResponse::processSpecialHeaders()
 
 void CgiResponse::setDefaultHeaders()
 {
-	// Always set Content-Length based on actual body length
+	// Set Content-Length based on actual body length when the whole body was read
 	// This ensures correct Content-Length even if CGI script provided an
 	// incorrect one or if no Content-Length was provided (EOF-based
-	// termination)
-	_headers["content-length"] = StrUtils::toString(_body.length());
+	// termination). A body still in the pipe keeps the script's own, if any.
+	if (_outputComplete)
+		_headers["content-length"] = StrUtils::toString(_body.length());
 
 	// Set Content-Type if not already set
 	if (!hasHeader("content-type"))
@@ -21,19 +21,27 @@ int main(int argc, char **argv)
 	Logger::log(Logger::INFO, "PerformanceMonitor: Performance monitoring initialized", __FILE__, __LINE__,
 				__FUNCTION__);
 
-	if (argc != 2)
+	// Optional --event-backend=NAME ahead of the config file, overrides the event_backend directive
+	const std::string backendOption = "--event-backend=";
+	bool backendOverride = false;
+	EventBackend::Type backendType = EventBackend::EPOLL;
+	if (argc == 3 && std::string(argv[1]).compare(0, backendOption.size(), backendOption) == 0)
+		backendOverride = EventBackend::parseType(std::string(argv[1]).substr(backendOption.size()), backendType);
+	if (argc != 2 && !backendOverride)
 	{
-		Logger::log(Logger::ERROR, "Usage: " + std::string(argv[0]) + " <config_file>");
+		Logger::log(Logger::ERROR,
+					"Usage: " + std::string(argv[0]) + " [--event-backend=epoll|io_uring] <config_file>");
 		Logger::closeSession();
 		return 1;
 	}
+	const char *configFile = argv[argc - 1];
 
 	try
 	{
-		Logger::log(Logger::INFO, "Starting WebServ with config file: " + std::string(argv[1]));
+		Logger::log(Logger::INFO, "Starting WebServ with config file: " + std::string(configFile));
 
 		// 1. Build the AST
-		ConfigFileReader reader(argv[1]);
+		ConfigFileReader reader(configFile);
 		ConfigTokeniser tokenizer(reader);
 		ConfigParser parser(tokenizer);
 		AST::ASTNode cfg = parser.parse();
@@ -52,11 +60,16 @@ int main(int argc, char **argv)
 			Logger::log(Logger::INFO, "Configured Server " + StrUtils::toString<size_t>(i) + ":");
 			std::cout << servers[i] << std::endl;
 		}
-		// 3. Build server map
-		ServerMap serverMap(servers);
+		GlobalConfig globalConfig = translator.getGlobalConfig();
+		if (backendOverride)
+			globalConfig.setEventBackend(backendType);
+		if (globalConfig.isModified())
+			std::cout << globalConfig << std::endl;
+		// 3. Build server map (worker mode only reserves the addresses, each worker listens on its own copy)
+		ServerMap serverMap(servers, globalConfig.getWorkerProcesses() > 1);
 		// Print occurs in ServerManager::run(), avoid duplicate dump here
 		// 4. Create manager instance with server map
-		ServerManager serverManager(serverMap);
+		ServerManager serverManager(serverMap, globalConfig, configFile);
 
 		// 5. Start the server
 		serverManager.run();